@@ -0,0 +1,525 @@
+// Microbenchmarks for kiln_string.
+//
+// Build (from the repository root):
+//     gcc -O3 -pthread -Iinclude src/*.c bench/bench_kiln_string.c -o bench_kiln_string
+//
+// Usage:
+//     ./bench_kiln_string [--json] [--filter <substring>] [--max-size <bytes>] [--min-time-ms <ms>]
+//
+// Every benchmark is run for each input size from 8 bytes to 64 MiB (x8 steps,
+// the last one clamped to --max-size) and, where
+// it matters, for several match densities. Each kiln_string function is paired
+// with the closest glibc equivalent (`impl` is "kiln" or "libc"). Reported
+// numbers are the best of several repetitions: ns/op, GB/s and cycles/byte.
+// Cycles are TSC reference cycles on x86 and are reported as 0 elsewhere.
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <locale.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "../include/kiln_string.h"
+
+#define BENCH_REPETITIONS 5
+#define BENCH_MAX_SIZE ((size_t)64 << 20)
+
+typedef enum {
+    DENSITY_NONE,
+    DENSITY_SPARSE,
+    DENSITY_DENSE,
+} bench_density_t;
+
+static const char* density_names[] = { "none", "sparse", "dense" };
+static const size_t density_period[] = { 0, 4096, 64 };
+
+typedef struct {
+    kstring_ref_t input;
+    kstring_ref_t other;
+    const char* needle;
+    const char* replacement;
+    kiln_string_t work;
+} bench_ctx_t;
+
+typedef struct {
+    const char* name;
+    const char* impl;
+    bool uses_density;
+    // Prepares `work` before each call, its cost is measured separately and subtracted
+    void (*reset)(bench_ctx_t* ctx);
+    void (*run)(bench_ctx_t* ctx);
+} bench_t;
+
+static volatile uint64_t bench_sink;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Inputs
+
+#define BENCH_NEEDLE "needle!"
+#define BENCH_REPLACEMENT "replacement"
+
+/// @brief Fills a buffer with lowercase text and spaces, with `BENCH_NEEDLE` every `period` bytes (never if 0)
+static char* make_input(size_t size, size_t period) {
+    char* buf = malloc(size + 1);
+    uint32_t state = 2463534242u;
+    for (size_t i = 0; i < size; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        uint32_t r = state % 27;
+        buf[i] = r == 26 ? ' ' : (char)('a' + r);
+    }
+
+    size_t needle_len = strlen(BENCH_NEEDLE);
+    if (period != 0 && size >= needle_len) {
+        for (size_t i = period - needle_len; i + needle_len <= size; i += period) {
+            memcpy(buf + i, BENCH_NEEDLE, needle_len);
+        }
+    }
+
+    // Some surrounding whitespace for the trim benchmarks
+    if (size >= 4) {
+        buf[0] = ' ';
+        buf[1] = '\t';
+        buf[size - 2] = '\n';
+        buf[size - 1] = ' ';
+    }
+
+    buf[size] = '\0';
+    return buf;
+}
+
+static void reset_work(bench_ctx_t* ctx) {
+    ctx->work.__length = 0;
+    kiln_string_push_kstring_ref(&ctx->work, ctx->input);
+}
+
+static void reset_empty(bench_ctx_t* ctx) {
+    ctx->work.__length = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Benchmarks
+
+static void run_find(bench_ctx_t* ctx) {
+    bench_sink += (uint64_t)kstring_ref_find(ctx->input, ctx->needle);
+}
+
+static void run_libc_find(bench_ctx_t* ctx) {
+    const char* found = memmem(ctx->input.ptr, ctx->input.__length, ctx->needle, strlen(ctx->needle));
+    bench_sink += found ? (uint64_t)(found - ctx->input.ptr) : 0;
+}
+
+static void run_rfind(bench_ctx_t* ctx) {
+    bench_sink += (uint64_t)kstring_ref_rfind(ctx->input, ctx->needle);
+}
+
+/// @brief glibc has no reverse substring search, memrchr on the first byte is the usual stand-in
+static const char* libc_rfind(const bench_ctx_t* ctx) {
+    size_t needle_len = strlen(ctx->needle);
+    size_t limit = ctx->input.__length;
+    while (limit > 0) {
+        const char* p = memrchr(ctx->input.ptr, ctx->needle[0], limit);
+        if (p == NULL) {
+            break;
+        }
+        size_t pos = (size_t)(p - ctx->input.ptr);
+        if (pos + needle_len <= ctx->input.__length && memcmp(p, ctx->needle, needle_len) == 0) {
+            return p;
+        }
+        limit = pos;
+    }
+    return NULL;
+}
+
+static void run_libc_rfind(bench_ctx_t* ctx) {
+    const char* found = libc_rfind(ctx);
+    bench_sink += found ? (uint64_t)(found - ctx->input.ptr) : 0;
+}
+
+static void run_replace(bench_ctx_t* ctx) {
+    kiln_string_replace(&ctx->work, ctx->needle, ctx->replacement);
+    bench_sink += ctx->work.__length;
+}
+
+static void run_libc_replace(bench_ctx_t* ctx) {
+    // Single pass strstr + memcpy into a fresh buffer, sized for the worst case
+    const char* src = ctx->work.ptr;
+    size_t needle_len = strlen(ctx->needle);
+    size_t replacement_len = strlen(ctx->replacement);
+    size_t worst = ctx->work.__length / needle_len * replacement_len + ctx->work.__length + 1;
+    char* out = malloc(worst);
+    char* dst = out;
+    const char* found;
+    while ((found = strstr(src, ctx->needle)) != NULL) {
+        memcpy(dst, src, (size_t)(found - src));
+        dst += found - src;
+        memcpy(dst, ctx->replacement, replacement_len);
+        dst += replacement_len;
+        src = found + needle_len;
+    }
+    size_t rest = strlen(src);
+    memcpy(dst, src, rest + 1);
+    bench_sink += (uint64_t)(dst - out) + rest;
+    free(out);
+}
+
+static void run_partition(bench_ctx_t* ctx) {
+    kstring_ref_t parts[2];
+    kstring_ref_partition(ctx->input, ctx->needle, parts);
+    bench_sink += parts[0].__length;
+}
+
+static void run_libc_partition(bench_ctx_t* ctx) {
+    size_t needle_len = strlen(ctx->needle);
+    const char* found = memmem(ctx->input.ptr, ctx->input.__length, ctx->needle, needle_len);
+    kstring_ref_t parts[2] = { ctx->input, { .ptr = ctx->input.ptr + ctx->input.__length, .__length = 0 } };
+    if (found != NULL) {
+        parts[0].__length = (uint64_t)(found - ctx->input.ptr);
+        parts[1].ptr = (char*)found + needle_len;
+        parts[1].__length = ctx->input.__length - parts[0].__length - needle_len;
+    }
+    bench_sink += parts[0].__length + parts[1].__length;
+}
+
+static void run_rpartition(bench_ctx_t* ctx) {
+    kstring_ref_t parts[2];
+    kstring_ref_rpartition(ctx->input, ctx->needle, parts);
+    bench_sink += parts[0].__length;
+}
+
+static void run_libc_rpartition(bench_ctx_t* ctx) {
+    size_t needle_len = strlen(ctx->needle);
+    const char* found = libc_rfind(ctx);
+    kstring_ref_t parts[2] = { { .ptr = ctx->input.ptr, .__length = 0 }, ctx->input };
+    if (found != NULL) {
+        parts[0].__length = (uint64_t)(found - ctx->input.ptr);
+        parts[1].ptr = (char*)found + needle_len;
+        parts[1].__length = ctx->input.__length - parts[0].__length - needle_len;
+    }
+    bench_sink += parts[0].__length + parts[1].__length;
+}
+
+static void run_trim(bench_ctx_t* ctx) {
+    bench_sink += kstring_ref_trim(ctx->input).__length;
+}
+
+static void run_libc_trim(bench_ctx_t* ctx) {
+    const char* p = ctx->input.ptr;
+    size_t len = ctx->input.__length;
+    size_t start = 0;
+    while (start < len && isspace((unsigned char)p[start])) start++;
+    while (len > start && isspace((unsigned char)p[len - 1])) len--;
+    bench_sink += len - start;
+}
+
+static void run_trim_inplace(bench_ctx_t* ctx) {
+    kiln_string_trim_inplace(&ctx->work);
+    bench_sink += ctx->work.__length;
+}
+
+static void run_libc_trim_inplace(bench_ctx_t* ctx) {
+    char* p = ctx->work.ptr;
+    size_t len = ctx->work.__length;
+    size_t start = 0;
+    while (start < len && isspace((unsigned char)p[start])) start++;
+    while (len > start && isspace((unsigned char)p[len - 1])) len--;
+    memmove(p, p + start, len - start);
+    p[len - start] = '\0';
+    bench_sink += len - start;
+}
+
+static void run_ascii_lower(bench_ctx_t* ctx) {
+    kiln_string_to_ascii_lower(&ctx->work);
+    bench_sink += (unsigned char)ctx->work.ptr[0];
+}
+
+static void run_libc_lower(bench_ctx_t* ctx) {
+    char* p = ctx->work.ptr;
+    for (size_t i = 0; i < ctx->work.__length; i++) {
+        p[i] = (char)tolower((unsigned char)p[i]);
+    }
+    bench_sink += (unsigned char)p[0];
+}
+
+static void run_ascii_upper(bench_ctx_t* ctx) {
+    kiln_string_to_ascii_upper(&ctx->work);
+    bench_sink += (unsigned char)ctx->work.ptr[0];
+}
+
+static void run_libc_upper(bench_ctx_t* ctx) {
+    char* p = ctx->work.ptr;
+    for (size_t i = 0; i < ctx->work.__length; i++) {
+        p[i] = (char)toupper((unsigned char)p[i]);
+    }
+    bench_sink += (unsigned char)p[0];
+}
+
+static void run_unicode_upper(bench_ctx_t* ctx) {
+    kiln_string_to_unicode_upper(&ctx->work);
+    bench_sink += (unsigned char)ctx->work.ptr[0];
+}
+
+static void run_libc_unicode_upper(bench_ctx_t* ctx) {
+    // mbrtowc + towupper + wcrtomb under a UTF-8 locale, into a fresh buffer since lengths can change
+    const char* src = ctx->work.ptr;
+    size_t len = ctx->work.__length;
+    char* out = malloc(len * MB_CUR_MAX + 1);
+    size_t out_len = 0;
+    mbstate_t in_state = { 0 };
+    mbstate_t out_state = { 0 };
+    size_t i = 0;
+    while (i < len) {
+        wchar_t wc;
+        size_t n = mbrtowc(&wc, src + i, len - i, &in_state);
+        if (n == (size_t)-1 || n == (size_t)-2) {
+            // Invalid or truncated sequences are copied as they are
+            out[out_len++] = src[i++];
+            in_state = (mbstate_t){ 0 };
+            continue;
+        }
+        if (n == 0) {
+            n = 1;
+        }
+        out_len += wcrtomb(out + out_len, (wchar_t)towupper((wint_t)wc), &out_state);
+        i += n;
+    }
+    out[out_len] = '\0';
+    bench_sink += out_len + (unsigned char)out[0];
+    free(out);
+}
+
+static void run_compare(bench_ctx_t* ctx) {
+    bench_sink += (uint64_t)kstring_ref_compare(ctx->input, ctx->other);
+}
+
+static void run_libc_compare(bench_ctx_t* ctx) {
+    bench_sink += (uint64_t)memcmp(ctx->input.ptr, ctx->other.ptr, ctx->input.__length);
+}
+
+static void run_equals(bench_ctx_t* ctx) {
+    bench_sink += kstring_ref_equals(ctx->input, ctx->other);
+}
+
+static void run_libc_equals(bench_ctx_t* ctx) {
+    bench_sink += ctx->input.__length == ctx->other.__length
+        && memcmp(ctx->input.ptr, ctx->other.ptr, ctx->input.__length) == 0;
+}
+
+static void run_push(bench_ctx_t* ctx) {
+    kiln_string_push_kstring_ref(&ctx->work, ctx->input);
+    bench_sink += ctx->work.__length;
+}
+
+static void run_libc_push(bench_ctx_t* ctx) {
+    memcpy(ctx->work.ptr, ctx->input.ptr, ctx->input.__length);
+    ctx->work.ptr[ctx->input.__length] = '\0';
+    bench_sink += ctx->input.__length;
+}
+
+static const bench_t benches[] = {
+    { "find",          "kiln", true,  NULL,        run_find },
+    { "find",          "libc", true,  NULL,        run_libc_find },
+    { "rfind",         "kiln", true,  NULL,        run_rfind },
+    { "rfind",         "libc", true,  NULL,        run_libc_rfind },
+    { "replace",       "kiln", true,  reset_work,  run_replace },
+    { "replace",       "libc", true,  reset_work,  run_libc_replace },
+    { "partition",     "kiln", true,  NULL,        run_partition },
+    { "partition",     "libc", true,  NULL,        run_libc_partition },
+    { "rpartition",    "kiln", true,  NULL,        run_rpartition },
+    { "rpartition",    "libc", true,  NULL,        run_libc_rpartition },
+    { "trim",          "kiln", false, NULL,        run_trim },
+    { "trim",          "libc", false, NULL,        run_libc_trim },
+    { "trim_inplace",  "kiln", false, reset_work,  run_trim_inplace },
+    { "trim_inplace",  "libc", false, reset_work,  run_libc_trim_inplace },
+    { "ascii_lower",   "kiln", false, reset_work,  run_ascii_lower },
+    { "ascii_lower",   "libc", false, reset_work,  run_libc_lower },
+    { "ascii_upper",   "kiln", false, reset_work,  run_ascii_upper },
+    { "ascii_upper",   "libc", false, reset_work,  run_libc_upper },
+    { "unicode_upper", "kiln", false, reset_work,  run_unicode_upper },
+    { "unicode_upper", "libc", false, reset_work,  run_libc_unicode_upper },
+    { "compare",       "kiln", false, NULL,        run_compare },
+    { "compare",       "libc", false, NULL,        run_libc_compare },
+    { "equals",        "kiln", false, NULL,        run_equals },
+    { "equals",        "libc", false, NULL,        run_libc_equals },
+    { "push",          "kiln", false, reset_empty, run_push },
+    { "push",          "libc", false, reset_empty, run_libc_push },
+};
+
+// ---------------------------------------------------------------------------
+// Harness
+
+typedef struct {
+    double ns_per_op;
+    double cycles_per_op;
+} bench_result_t;
+
+/// @brief Times `iters` calls of reset (+ run). Returns the best of BENCH_REPETITIONS.
+static bench_result_t time_loop(const bench_t* bench, bench_ctx_t* ctx, size_t iters, bool with_run) {
+    bench_result_t best = { 1e300, 1e300 };
+    for (int rep = 0; rep < BENCH_REPETITIONS; rep++) {
+        uint64_t t0 = now_ns();
+        uint64_t c0 = now_cycles();
+        for (size_t i = 0; i < iters; i++) {
+            if (bench->reset) bench->reset(ctx);
+            if (with_run) bench->run(ctx);
+        }
+        uint64_t c1 = now_cycles();
+        uint64_t t1 = now_ns();
+
+        double ns = (double)(t1 - t0) / (double)iters;
+        double cycles = (double)(c1 - c0) / (double)iters;
+        if (ns < best.ns_per_op) {
+            best.ns_per_op = ns;
+            best.cycles_per_op = cycles;
+        }
+    }
+    return best;
+}
+
+static bench_result_t measure(const bench_t* bench, bench_ctx_t* ctx, uint64_t min_time_ns) {
+    // Calibrate the iteration count so one repetition takes about `min_time_ns`
+    size_t iters = 1;
+    for (;;) {
+        uint64_t t0 = now_ns();
+        for (size_t i = 0; i < iters; i++) {
+            if (bench->reset) bench->reset(ctx);
+            bench->run(ctx);
+        }
+        uint64_t elapsed = now_ns() - t0;
+        if (elapsed >= min_time_ns / 4 || iters >= ((size_t)1 << 30)) {
+            if (elapsed > 0 && elapsed < min_time_ns) {
+                iters = (size_t)((double)iters * (double)min_time_ns / (double)elapsed) + 1;
+            }
+            break;
+        }
+        iters *= 2;
+    }
+
+    bench_result_t total = time_loop(bench, ctx, iters, true);
+    if (bench->reset) {
+        bench_result_t overhead = time_loop(bench, ctx, iters, false);
+        total.ns_per_op -= overhead.ns_per_op;
+        total.cycles_per_op -= overhead.cycles_per_op;
+        if (total.ns_per_op < 0) total.ns_per_op = 0;
+        if (total.cycles_per_op < 0) total.cycles_per_op = 0;
+    }
+    return total;
+}
+
+/// @brief The size after `size`: 8 times larger, but the last step is clamped so that `max_size` itself is measured
+static size_t next_size(size_t size, size_t max_size) {
+    return size < max_size && size * 8 > max_size ? max_size : size * 8;
+}
+
+static void print_usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--json] [--filter <substring>] [--max-size <bytes>] [--min-time-ms <ms>]\n", argv0);
+}
+
+int main(int argc, char** argv) {
+    bool json = false;
+    const char* filter = NULL;
+    size_t max_size = BENCH_MAX_SIZE;
+    uint64_t min_time_ns = 20 * 1000000ull;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            max_size = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+            min_time_ns = strtoull(argv[++i], NULL, 10) * 1000000ull;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (json) {
+        printf("{\n  \"library\": \"kiln_string\",\n  \"results\": [");
+    } else {
+        printf("%-14s %-5s %-7s %10s %14s %10s %12s\n", "benchmark", "impl", "density", "size", "ns/op", "GB/s", "cycles/byte");
+    }
+
+    // The unicode_upper baseline needs a UTF-8 locale; the C locale leaves it a byte loop
+    if (setlocale(LC_CTYPE, "C.UTF-8") == NULL) {
+        setlocale(LC_CTYPE, "en_US.UTF-8");
+    }
+
+    bool first = true;
+    for (size_t size = 8; size <= max_size; size = next_size(size, max_size)) {
+        for (int density = DENSITY_NONE; density <= DENSITY_DENSE; density++) {
+            char* input = make_input(size, density_period[density]);
+            char* other = malloc(size + 1);
+            memcpy(other, input, size + 1);
+
+            bench_ctx_t ctx = {
+                .input = { .ptr = input, .__length = size },
+                .other = { .ptr = other, .__length = size },
+                .needle = BENCH_NEEDLE,
+                .replacement = BENCH_REPLACEMENT,
+                .work = kiln_string_with_capacity(size * 2 + 1),
+            };
+
+            for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+                const bench_t* bench = &benches[b];
+                if (!bench->uses_density && density != DENSITY_NONE) continue;
+                if (filter && strstr(bench->name, filter) == NULL) continue;
+
+                bench_result_t result = measure(bench, &ctx, min_time_ns);
+                double gbps = result.ns_per_op > 0 ? (double)size / result.ns_per_op : 0;
+                double cpb = result.cycles_per_op / (double)size;
+                const char* density_name = bench->uses_density ? density_names[density] : "-";
+
+                if (json) {
+                    printf("%s\n    {\"name\": \"%s\", \"impl\": \"%s\", \"density\": \"%s\", \"size\": %zu, "
+                           "\"ns_per_op\": %.3f, \"gb_per_s\": %.4f, \"cycles_per_byte\": %.4f}",
+                           first ? "" : ",", bench->name, bench->impl, density_name, size,
+                           result.ns_per_op, gbps, cpb);
+                } else {
+                    printf("%-14s %-5s %-7s %10zu %14.2f %10.3f %12.4f\n",
+                           bench->name, bench->impl, density_name, size, result.ns_per_op, gbps, cpb);
+                }
+                fflush(stdout);
+                first = false;
+            }
+
+            kiln_string_free(&ctx.work);
+            free(input);
+            free(other);
+        }
+    }
+
+    if (json) {
+        printf("\n  ]\n}\n");
+    }
+
+    return 0;
+}
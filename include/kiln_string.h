@@ -8,6 +8,20 @@
 #include <ctype.h>
 #include <stddef.h>
 
+// The small accessors and wrappers marked KILN_STRING_INLINE are defined at the
+// bottom of this header. Normally they are compiled once into the library (the
+// translation unit that defines KILN_STRING_IMPLEMENTATION emits them). Define
+// KILN_STRING_HEADER_ONLY before including this header to get them as
+// `static inline` instead, so they inline into the caller without LTO. The heavy
+// kernels stay out of line in both modes.
+#ifdef KILN_STRING_HEADER_ONLY
+#define KILN_STRING_INLINE static inline
+#define KILN_STRING_INLINE_DEF static inline
+#else
+#define KILN_STRING_INLINE
+#define KILN_STRING_INLINE_DEF inline
+#endif
+
 
 typedef struct {
     char* ptr;
@@ -21,6 +35,32 @@ typedef struct {
     uint64_t __length;
 } kstring_ref_t;
 
+/// @brief A kstring_ref_t for a string literal, with the length taken from sizeof (no strlen).
+/// Only accepts literals: `KSTR("abc")`
+#define KSTR(literal) ((kstring_ref_t){ .ptr = (char*)("" literal ""), .__length = sizeof("" literal "") - 1 })
+
+// Conversions behind KSTR_REF. Always static inline, so strlen on a literal
+// passed as a char* is folded at compile time.
+static inline kstring_ref_t __kstr_ref_identity(kstring_ref_t ref) {
+    return ref;
+}
+
+static inline kstring_ref_t __kstr_ref_from_kiln_string(const kiln_string_t* string) {
+    return (kstring_ref_t){ .ptr = string->ptr, .__length = string->__length };
+}
+
+static inline kstring_ref_t __kstr_ref_from_cstr(const char* cstr) {
+    return (kstring_ref_t){ .ptr = (char*)cstr, .__length = strlen(cstr) };
+}
+
+/// @brief Turns a kstring_ref_t, a kiln_string_t* or a C string into a kstring_ref_t
+#define KSTR_REF(x) _Generic((x), \
+    kstring_ref_t: __kstr_ref_identity, \
+    kiln_string_t*: __kstr_ref_from_kiln_string, \
+    const kiln_string_t*: __kstr_ref_from_kiln_string, \
+    char*: __kstr_ref_from_cstr, \
+    const char*: __kstr_ref_from_cstr)(x)
+
 
 /// @brief Copies the data from string to it's own internal buffer
 /// @param string 
@@ -30,7 +70,7 @@ kiln_string_t kiln_string_from_cstr(const char* string);
 /// @brief Creates a string from a kstring_ref_t by compying the contents. 
 /// @param str_ref 
 /// @return 
-extern inline kiln_string_t kiln_string_from_kstring_ref(kstring_ref_t str_ref);
+kiln_string_t kiln_string_from_kstring_ref(kstring_ref_t str_ref);
 
 /// @brief Creates a string with capacity `capacity`
 /// @param capacity 
@@ -40,29 +80,102 @@ kiln_string_t kiln_string_with_capacity(size_t capacity);
 /// @brief Creates a string from a kstring_ref_t by compying the contents. 
 /// @param str_ref 
 /// @return 
-extern inline kiln_string_t kstring_ref_to_kiln_string(kstring_ref_t str_ref);
+KILN_STRING_INLINE kiln_string_t kstring_ref_to_kiln_string(kstring_ref_t str_ref);
 
-extern inline kstring_ref_t kiln_string_to_kstring_ref(const kiln_string_t* string);
+KILN_STRING_INLINE kstring_ref_t kiln_string_to_kstring_ref(const kiln_string_t* string);
 
-extern inline kstring_ref_t kstring_ref_from_kiln_string(const kiln_string_t* string);
+KILN_STRING_INLINE kstring_ref_t kstring_ref_from_kiln_string(const kiln_string_t* string);
 
-extern inline kstring_ref_t kstring_ref_from_cstr(char* string);
+KILN_STRING_INLINE kstring_ref_t kstring_ref_from_cstr(char* string);
 
 /// @brief Frees the memory allocated by the kiln string. Sets the pointer to NULL
 /// @param str 
 /// @return 
-extern inline void kiln_string_free(kiln_string_t* str);
+KILN_STRING_INLINE void kiln_string_free(kiln_string_t* str);
 
 /// @brief Appends the content of a char* to a KilnString
 /// @param string 
 /// @param cstr 
-extern inline void kiln_string_push_cstr(kiln_string_t* string, char* cstr);
+KILN_STRING_INLINE void kiln_string_push_cstr(kiln_string_t* string, char* cstr);
 
 /// @brief Appends the content of a kstring_ref_t to a KilnString
 /// @param string The kiln_string_t to append to
 /// @param str_ref The kstring_ref_t to append
 void kiln_string_push_kstring_ref(kiln_string_t* string, kstring_ref_t str_ref);
 
+/// @brief Creates a string holding `refs` with `sep` between consecutive pieces, with one exact-size allocation
+/// @param refs The pieces
+/// @param n Number of pieces
+/// @param sep The separator, may be empty
+/// @return The joined string (empty if n is 0)
+kiln_string_t kiln_string_join(const kstring_ref_t* refs, size_t n, kstring_ref_t sep);
+
+/// @brief Creates a string holding all of `refs` back to back, with one exact-size allocation
+/// @param refs The pieces
+/// @param n Number of pieces
+/// @return The concatenated string (empty if n is 0)
+kiln_string_t kiln_string_concat(const kstring_ref_t* refs, size_t n);
+
+/// @brief Appends `refs` to `string` with `sep` between consecutive pieces.
+/// The total length is computed first, so the string grows at most once
+/// @param string The kiln_string_t to append to
+/// @param refs The pieces
+/// @param n Number of pieces
+/// @param sep The separator, may be empty
+void kiln_string_push_join(kiln_string_t* string, const kstring_ref_t* refs, size_t n, kstring_ref_t sep);
+
+/// @brief Appends all of `refs` to `string`, growing it at most once
+/// @param string The kiln_string_t to append to
+/// @param refs The pieces
+/// @param n Number of pieces
+void kiln_string_push_concat(kiln_string_t* string, const kstring_ref_t* refs, size_t n);
+
+/// @brief How a kiln_string_t picks its new capacity when an append does not fit.
+/// Higher factors mean fewer reallocations, lower ones less unused memory
+typedef enum {
+    KILN_GROWTH_DOUBLE,      // 2x (the default)
+    KILN_GROWTH_ONE_HALF,    // 1.5x
+    KILN_GROWTH_SIZE_CLASS,  // 1.5x, then rounded up to the allocator's size class (malloc_usable_size, glibc only)
+} kiln_string_growth_t;
+
+/// @brief Sets how `kiln_string_t`s grow when an append runs out of capacity. Applies process wide
+/// @param policy See `kiln_string_growth_t`
+void kiln_string_set_growth_policy(kiln_string_growth_t policy);
+
+/// @brief Returns the growth policy set with `kiln_string_set_growth_policy` (KILN_GROWTH_DOUBLE by default)
+kiln_string_growth_t kiln_string_get_growth_policy(void);
+
+/// @brief Makes sure `string` can take `additional` more bytes without reallocating.
+/// Grows by the current growth policy, so a series of reserves stays amortised O(1)
+/// @param string The kiln_string_t to grow
+/// @param additional Number of bytes that will be appended
+/// @return false if the allocation failed, `string` is left untouched in that case
+bool kiln_string_reserve(kiln_string_t* string, uint64_t additional);
+
+/// @brief Reallocates `string` so that its capacity is exactly its length plus the NUL terminator.
+/// Useful for long-lived strings after `kiln_string_trim_inplace`, `kiln_string_remove_suffix` etc.
+/// @param string The kiln_string_t to shrink. Left as it is if the reallocation fails
+void kiln_string_shrink_to_fit(kiln_string_t* string);
+
+/// @brief Set in `__capacity` when the buffer is an anonymous mapping rather than a malloc block
+#define KILN_STRING_MAPPED ((size_t)1 << 63)
+
+/// @brief Default for `kiln_string_set_map_threshold`
+#define KILN_STRING_DEFAULT_MAP_THRESHOLD ((size_t)64 << 20)
+
+/// @brief Sets the capacity from which a growing string switches to an mmap'd buffer. 0 turns the mode off.
+/// Mapped buffers get transparent huge page advice and grow with mremap, so growing a huge string
+/// does not copy it. Applies process wide, strings that are already mapped stay mapped.
+/// Has no effect where mremap is unavailable
+/// @param bytes The threshold in bytes
+void kiln_string_set_map_threshold(size_t bytes);
+
+/// @brief Returns the threshold set with `kiln_string_set_map_threshold`, 0 if large-string mode is off or unsupported
+size_t kiln_string_get_map_threshold(void);
+
+/// @brief Releases a mapped buffer, used by `kiln_string_free`. Not meant to be called directly
+void __kiln_string_unmap(kiln_string_t* string);
+
 /// @brief Checks if a kiln_string_t ends with the specified suffix
 /// @param string The string to check
 /// @param suffix The suffix to check for
@@ -81,12 +194,24 @@ bool kiln_string_starts_with(const kiln_string_t* string, const char* prefix);
 /// @return true if the string ends with the suffix, false otherwise
 bool kstring_ref_ends_with(kstring_ref_t string, const char* suffix);
 
+/// @brief Checks if a kstring_ref_t ends with the specified suffix
+/// @param string The string reference to check
+/// @param suffix The suffix to check for
+/// @return true if the string ends with the suffix, false otherwise
+bool kstring_ref_ends_with_ref(kstring_ref_t string, kstring_ref_t suffix);
+
 /// @brief Checks if a kstring_ref_t starts with the specified prefix
 /// @param string The string reference to check
 /// @param prefix The prefix to check for
 /// @return true if the string starts with the prefix, false otherwise
 bool kstring_ref_starts_with(kstring_ref_t string, const char* prefix);
 
+/// @brief Checks if a kstring_ref_t starts with the specified prefix
+/// @param string The string reference to check
+/// @param prefix The prefix to check for
+/// @return true if the string starts with the prefix, false otherwise
+bool kstring_ref_starts_with_ref(kstring_ref_t string, kstring_ref_t prefix);
+
 /// @brief Removes the specified suffix from the string if it has the suffix, does nothing if otherwise
 /// @param string 
 /// @param suffix 
@@ -111,39 +236,39 @@ kstring_ref_t kstring_ref_substring(kstring_ref_t string, int64_t start_idx, int
 /// @param start_idx -1 to default to the start (or 0)
 /// @param end_idx -1 to default to the end
 /// @return A kstring_ref_t pointing to the requested substring
-extern inline kstring_ref_t kiln_string_substring(const kiln_string_t* string, int64_t start_idx, int64_t end_idx);
+KILN_STRING_INLINE kstring_ref_t kiln_string_substring(const kiln_string_t* string, int64_t start_idx, int64_t end_idx);
 
 /// @brief Checks if a kstring_ref_t equals a C-style string
 /// @param string The kstring_ref_t to compare
 /// @param other The C-style string to compare against
 /// @return true if the strings are equal, false otherwise
-extern inline bool kstring_ref_equals_cstr(kstring_ref_t string, const char* other);
+KILN_STRING_INLINE bool kstring_ref_equals_cstr(kstring_ref_t string, const char* other);
 
 /// @brief Checks if a kstring_ref_t equals kiln_string_t
 /// @param string The kstring_ref_t to compare
 /// @param other The kiln string to compare against
 /// @return true if the strings are equal, false otherwise
-extern inline bool kstring_ref_equals_kiln_string(kstring_ref_t string, const kiln_string_t* other);
+KILN_STRING_INLINE bool kstring_ref_equals_kiln_string(kstring_ref_t string, const kiln_string_t* other);
 
 /// @brief Checks if two StringRefs are equal
 /// @param s1 The first kstring_ref_t to compare
 /// @param s2 The second kstring_ref_t to compare
 /// @return true if the strings are equal, false otherwise
-extern inline bool kstring_ref_equals(kstring_ref_t s1, kstring_ref_t s2);
+KILN_STRING_INLINE bool kstring_ref_equals(kstring_ref_t s1, kstring_ref_t s2);
 
 /// @brief Checks if a kiln_string_t equals a C-style string
 /// @param string The kiln_string_t to compare
 /// @param other The C-style string to compare against
 /// @return true if the strings are equal, false otherwise
-extern inline bool kiln_string_equals_cstr(const kiln_string_t* string, const char* other);
+KILN_STRING_INLINE bool kiln_string_equals_cstr(const kiln_string_t* string, const char* other);
 
-extern inline bool kiln_string_equals_kstring_ref(const kiln_string_t* string, kstring_ref_t other);
+KILN_STRING_INLINE bool kiln_string_equals_kstring_ref(const kiln_string_t* string, kstring_ref_t other);
 
 /// @brief Checks if two KilnStrings are equalg
 /// @param s1 The first kiln_string_t to compare
 /// @param s2 The first kiln_string_t to compare
 /// @return true if the strings are equal, false otherwise
-extern inline bool kiln_string_equals(const kiln_string_t* s1, const kiln_string_t* s2);
+KILN_STRING_INLINE bool kiln_string_equals(const kiln_string_t* s1, const kiln_string_t* s2);
 
 /// @brief Compares two StringRefs lexicographically
 /// @param s1 First kstring_ref_t to compare
@@ -155,7 +280,7 @@ int32_t kstring_ref_compare(kstring_ref_t s1, kstring_ref_t s2);
 /// @param s1 First kiln_string_t to compare
 /// @param s2 Second kiln_string_t to compare
 /// @return 0 if equal, negative if s1 < s2, positive if s1 > s2
-extern inline int32_t kiln_string_compare(const kiln_string_t* s1, const kiln_string_t* s2);
+KILN_STRING_INLINE int32_t kiln_string_compare(const kiln_string_t* s1, const kiln_string_t* s2);
 
 /// @brief Converts ASCII characters in a kiln_string_t to lowercase, ignoring non-ASCII characters
 /// @param string The kiln_string_t to convert
@@ -193,29 +318,47 @@ kstring_ref_t kiln_string_trim(const kiln_string_t* string);
 /// @param new_s
 void kiln_string_replace(kiln_string_t* string, const char* old_s, const char* new_s);
 
+/// @brief Replaces all non-overlapping instances of old_s (left to right) with new_s
+/// @param string The kiln_string_t to edit
+/// @param old_s The text to replace, nothing happens if it is empty
+/// @param new_s The replacement
+void kiln_string_replace_ref(kiln_string_t* string, kstring_ref_t old_s, kstring_ref_t new_s);
+
 /// @brief Returns the index of the first character of the first occurance of `target`. 
 /// @param string The kstring_ref_t to search in
 /// @param target The substring to find
 /// @return Returns `-1` if target is not in `string`
 int64_t kstring_ref_find(kstring_ref_t string, const char* target);
 
+/// @brief Returns the index of the first character of the first occurance of `target`. 
+/// @param string The kstring_ref_t to search in
+/// @param target The substring to find
+/// @return Returns `-1` if target is not in `string`, 0 if target is empty
+int64_t kstring_ref_find_ref(kstring_ref_t string, kstring_ref_t target);
+
 /// @brief Finds the last occurrence of a target string within a StringRef
 /// @param string The kstring_ref_t to search in
 /// @param target The string to search for
 /// @return The position of the last occurrence, or -1 if not found
 int64_t kstring_ref_rfind(kstring_ref_t string, const char* target);
 
+/// @brief Finds the last occurrence of a target string within a StringRef
+/// @param string The kstring_ref_t to search in
+/// @param target The string to search for
+/// @return The position of the last occurrence, or -1 if not found (or target is empty)
+int64_t kstring_ref_rfind_ref(kstring_ref_t string, kstring_ref_t target);
+
 /// @brief Returns the index of the first character of the first occurance of `target` in a KilnString. 
 /// @param string The kiln_string_t to search in
 /// @param target The substring to find
 /// @return Returns `-1` if target is not in `string`
-extern inline int64_t kiln_string_find(const kiln_string_t* string, const char* target);
+KILN_STRING_INLINE int64_t kiln_string_find(const kiln_string_t* string, const char* target);
 
 /// @brief Returns the index of the first character of the last occurance of `target` in a KilnString. 
 /// @param string The kiln_string_t to search in
 /// @param target The substring to find
 /// @return Returns `-1` if target is not in `string`
-extern inline int64_t kiln_string_rfind(const kiln_string_t* string, const char* target);
+KILN_STRING_INLINE int64_t kiln_string_rfind(const kiln_string_t* string, const char* target);
 
 /// @brief Partitions a kstring_ref_t into two parts based on the first occurrence of a delimiter
 /// @param string The kstring_ref_t to be partitioned
@@ -223,23 +366,1166 @@ extern inline int64_t kiln_string_rfind(const kiln_string_t* string, const char*
 /// @param output_buffer Array of 2 kstring_ref_t's to store the results - first part before delimiter, second part after delimiter
 void kstring_ref_partition(kstring_ref_t string, const char* delimiter, kstring_ref_t output_buffer[2]);
 
+/// @brief Partitions a kstring_ref_t into two parts based on the first occurrence of a delimiter
+/// @param string The kstring_ref_t to be partitioned
+/// @param delimiter The delimiter string to search for
+/// @param output_buffer Array of 2 kstring_ref_t's to store the results - first part before delimiter, second part after delimiter
+void kstring_ref_partition_ref(kstring_ref_t string, kstring_ref_t delimiter, kstring_ref_t output_buffer[2]);
+
 /// @brief Partitions a kstring_ref_t into two parts based on the last occurrence of a delimiter
 /// @param string The kstring_ref_t to be partitioned
 /// @param delimiter The delimiter string to search for from the end
 /// @param output_buffer Array of 2 kstring_ref_t's to store the results - first part before last delimiter, second part after last delimiter
 void kstring_ref_rpartition(kstring_ref_t string, const char* delimiter, kstring_ref_t output_buffer[2]);
 
+/// @brief Partitions a kstring_ref_t into two parts based on the last occurrence of a delimiter
+/// @param string The kstring_ref_t to be partitioned
+/// @param delimiter The delimiter string to search for from the end
+/// @param output_buffer Array of 2 kstring_ref_t's to store the results - first part before last delimiter, second part after last delimiter
+void kstring_ref_rpartition_ref(kstring_ref_t string, kstring_ref_t delimiter, kstring_ref_t output_buffer[2]);
+
+// Iterator over the pieces of a string between occurrences of a separator
+typedef struct {
+    kstring_ref_t __rest;
+    kstring_ref_t __sep;
+    bool __done;
+} kstring_split_iter_t;
+
+/// @brief Creates an iterator over the pieces of `string` between occurrences of `sep`.
+/// Like Python's str.split(sep): n separators give n + 1 pieces, including empty ones
+/// @param string The kstring_ref_t to split, it must outlive the iterator
+/// @param sep The separator. If it is empty the whole string comes back as a single piece
+/// @return The iterator, see `kstring_split_iter_next`
+kstring_split_iter_t kstring_ref_split(kstring_ref_t string, kstring_ref_t sep);
+
+/// @brief Returns the next piece of a split
+/// @param iter 
+/// @param out Set to the piece, a span into the string being split
+/// @return false once every piece has been returned
+bool kstring_split_iter_next(kstring_split_iter_t* iter, kstring_ref_t* out);
+
+// Type generic front ends: every argument may be a kstring_ref_t (e.g. KSTR("lit")),
+// a kiln_string_t* or a C string, and is routed to the length-aware _ref function.
+#define kstr_find(string, target) kstring_ref_find_ref(KSTR_REF(string), KSTR_REF(target))
+#define kstr_rfind(string, target) kstring_ref_rfind_ref(KSTR_REF(string), KSTR_REF(target))
+#define kstr_starts_with(string, prefix) kstring_ref_starts_with_ref(KSTR_REF(string), KSTR_REF(prefix))
+#define kstr_ends_with(string, suffix) kstring_ref_ends_with_ref(KSTR_REF(string), KSTR_REF(suffix))
+#define kstr_equals(a, b) kstring_ref_equals(KSTR_REF(a), KSTR_REF(b))
+#define kstr_partition(string, delimiter, output_buffer) kstring_ref_partition_ref(KSTR_REF(string), KSTR_REF(delimiter), output_buffer)
+#define kstr_rpartition(string, delimiter, output_buffer) kstring_ref_rpartition_ref(KSTR_REF(string), KSTR_REF(delimiter), output_buffer)
+#define kstr_split(string, sep) kstring_ref_split(KSTR_REF(string), KSTR_REF(sep))
+// kstr_replace edits its first argument, which must be a kiln_string_t*
+#define kstr_replace(string, old_s, new_s) kiln_string_replace_ref(string, KSTR_REF(old_s), KSTR_REF(new_s))
+
 /// @brief Partitions a kiln_string_t into two parts based on the first occurrence of a delimiter
 /// @param string The kstring_ref_t to be partitioned
 /// @param delimiter The delimiter string to search for
 /// @param output_buffer Array of 2 kstring_ref_t's to store the results - first part before delimiter, second part after delimiter
-extern inline void kiln_string_partition(const kiln_string_t* string, const char* delimiter, kstring_ref_t output_buffer[2]);
+KILN_STRING_INLINE void kiln_string_partition(const kiln_string_t* string, const char* delimiter, kstring_ref_t output_buffer[2]);
 
 /// @brief Partitions a kiln_string_t into two parts based on the last occurrence of a delimiter
 /// @param string The kstring_ref_t to be partitioned
 /// @param delimiter The delimiter string to search for from the end
 /// @param output_buffer Array of 2 kstring_ref_t's to store the results - first part before last delimiter, second part after last delimiter
-extern inline void kiln_string_rpartition(const kiln_string_t* string, const char* delimiter, kstring_ref_t output_buffer[2]);
+KILN_STRING_INLINE void kiln_string_rpartition(const kiln_string_t* string, const char* delimiter, kstring_ref_t output_buffer[2]);
+
+
+/// @brief Sorts an array of kstring_ref_t lexicographically (same order as `kstring_ref_compare`)
+/// @param refs The array to sort in place
+/// @param n Number of elements in `refs`
+void kstring_ref_sort(kstring_ref_t* refs, size_t n);
+
+/// @brief Sorts an array of kstring_ref_t lexicographically, keeping equal strings in their original order
+/// @param refs The array to sort in place
+/// @param n Number of elements in `refs`
+void kstring_ref_sort_stable(kstring_ref_t* refs, size_t n);
+
+/// @brief Sorts an array of kstring_ref_t and removes duplicates, keeping the first occurrence of each string
+/// @param refs The array to sort in place
+/// @param n Number of elements in `refs`
+/// @return The number of unique strings, which are stored in `refs[0..return)`
+size_t kstring_ref_sort_unique(kstring_ref_t* refs, size_t n);
+
+/// @brief Sorts an array of kstring_ref_t lexicographically using the built-in thread pool.
+/// The array is split into one run per thread, the runs are sorted concurrently and then merged pairwise.
+/// Small arrays are sorted on the calling thread.
+/// @param refs The array to sort in place
+/// @param n Number of elements in `refs`
+/// @param n_threads Number of runs to sort concurrently, 0 to use every core
+void kstring_ref_sort_parallel(kstring_ref_t* refs, size_t n, size_t n_threads);
+
+// Settings for the parallel (`_par_`) functions
+typedef struct {
+    // Number of chunks to search concurrently, 0 to use every core
+    size_t n_threads;
+    // Inputs shorter than this many bytes are processed on the calling thread, 0 for the default (1 MiB)
+    size_t serial_cutoff;
+} kstring_par_config_t;
+
+/// @brief Finds every non-overlapping occurrence of `target`, scanning chunks of the string concurrently on the built-in thread pool.
+/// Matches are the same as a serial left-to-right scan would find (the same ones `kiln_string_replace` replaces)
+/// @param string The kstring_ref_t to search in
+/// @param target The substring to find
+/// @param config Thread count and serial cutoff, NULL for the defaults
+/// @param out_count Set to the number of matches found
+/// @return A malloc'd array of match offsets in ascending order that the caller must free, NULL if there are no matches or on allocation failure
+uint64_t* kstring_ref_par_find_all(kstring_ref_t string, const char* target, const kstring_par_config_t* config, size_t* out_count);
+
+/// @brief Counts the non-overlapping occurrences of `target`, scanning chunks of the string concurrently on the built-in thread pool
+/// @param string The kstring_ref_t to search in
+/// @param target The substring to count
+/// @param config Thread count and serial cutoff, NULL for the defaults
+/// @return The number of matches, 0 if `target` is empty
+uint64_t kstring_ref_par_count(kstring_ref_t string, const char* target, const kstring_par_config_t* config);
+
+/// @brief Replaces all instances of old_s with new_s, finding matches and writing the result concurrently on the built-in thread pool.
+/// Matches are found per chunk, output offsets are prefix-summed and every thread writes its part straight into one
+/// pre-sized buffer. The result is the same as `kiln_string_replace`.
+/// @param string 
+/// @param old_s
+/// @param new_s
+/// @param config Thread count and serial cutoff, NULL for the defaults
+void kiln_string_par_replace(kiln_string_t* string, const char* old_s, const char* new_s, const kstring_par_config_t* config);
+
+// Per-thread allocation and copy counters. They are only updated when the library
+// is compiled with -DKILN_STRING_STATS, otherwise every field stays 0.
+typedef struct {
+    // Fresh buffer allocations (constructors, replace)
+    uint64_t allocations;
+    // Buffer reallocations when a string grows
+    uint64_t reallocations;
+    // Total bytes requested by allocations and reallocations
+    uint64_t bytes_allocated;
+    // Bytes copied into string buffers with memcpy
+    uint64_t bytes_copied;
+    // Bytes shifted inside a buffer with memmove (remove_prefix, trim_inplace)
+    uint64_t bytes_moved;
+    // Number of times an existing string had to increase its capacity
+    uint64_t growth_events;
+    // Unused capacity (beyond length + NUL) left by each allocation or growth, summed
+    uint64_t capacity_slack;
+} kiln_string_stats_t;
+
+/// @brief Returns the calling thread's allocation and copy counters
+/// @return All zeros unless the library was compiled with -DKILN_STRING_STATS
+kiln_string_stats_t kiln_string_stats_snapshot(void);
+
+/// @brief Resets the calling thread's allocation and copy counters to zero
+void kiln_string_stats_reset(void);
+
+
+/// @brief Checks if every byte of the string is below 0x80
+/// @param string The kstring_ref_t to check
+/// @return true if the string is pure ASCII (also true for an empty string)
+bool kstring_ref_is_ascii(kstring_ref_t string);
+
+/// @brief Checks if the string is well formed UTF-8 (no overlongs, surrogates or code points above U+10FFFF)
+/// @param string The kstring_ref_t to check
+/// @return true if the string is valid UTF-8
+bool kstring_ref_is_valid_utf8(kstring_ref_t string);
+
+/// @brief Hashes the bytes of a kstring_ref_t with a seed. The result is the same on every CPU
+/// and every dispatch tier, so it can be stored or sent between machines.
+/// @param string The kstring_ref_t to hash
+/// @param seed Any 64 bit value. The seed is mixed in nonlinearly, so inputs that collide under one seed
+/// are not more likely than any other pair to collide under another
+/// @return A 64 bit hash
+uint64_t kstring_ref_hash_seeded(kstring_ref_t string, uint64_t seed);
+
+/// @brief Hashes the bytes of a kstring_ref_t (seed 0)
+/// @param string The kstring_ref_t to hash
+/// @return A 64 bit hash
+uint64_t kstring_ref_hash(kstring_ref_t string);
+
+/// @brief Hashes the contents of a kiln_string_t, same result as `kstring_ref_hash` on the same bytes
+/// @param string The kiln_string_t to hash
+/// @return A 64 bit hash
+uint64_t kiln_string_hash(const kiln_string_t* string);
+
+// Kernel tiers for find, compare, case conversion, trim, validation and hashing.
+// The best tier for the CPU is selected when the library is loaded; set the
+// KILN_STRING_ISA environment variable (scalar, sse4.2, avx2 or avx512) to force
+// a lower one.
+typedef enum {
+    KILN_STRING_ISA_SCALAR = 0,
+    KILN_STRING_ISA_SSE42,
+    KILN_STRING_ISA_AVX2,
+    KILN_STRING_ISA_AVX512,
+} kiln_string_isa_t;
+
+// Flags returned by `kiln_string_cpu_features`
+#define KILN_CPU_SSE42       (1u << 0)
+#define KILN_CPU_AVX2        (1u << 1)
+#define KILN_CPU_AVX512BW    (1u << 2)
+#define KILN_CPU_AVX512VBMI  (1u << 3)
+
+/// @brief Returns the string-relevant instruction set extensions of the running CPU
+/// @return A bitmask of `KILN_CPU_*` flags
+uint32_t kiln_string_cpu_features(void);
+
+/// @brief Returns the highest kernel tier the running CPU supports
+/// @return The best kiln_string_isa_t
+kiln_string_isa_t kiln_string_best_isa(void);
+
+/// @brief Returns the kernel tier currently in use
+/// @return The active kiln_string_isa_t
+kiln_string_isa_t kiln_string_get_isa(void);
+
+/// @brief Switches every dispatched kernel to the given tier. Not thread safe, call it before
+/// other threads use the library.
+/// @param isa The tier to use
+/// @return false (and nothing changes) if the CPU does not support `isa`
+bool kiln_string_set_isa(kiln_string_isa_t isa);
+
+/// @brief Returns the name of a tier, as accepted by the KILN_STRING_ISA environment variable
+/// @param isa The tier
+/// @return A static string, "unknown" for values outside the enum
+const char* kiln_string_isa_name(kiln_string_isa_t isa);
+
+// Reference counted, copy-on-write string. Handles made with `kiln_shared_string_clone`
+// share one buffer; the first mutation through a shared handle gives it a private copy.
+// The count is atomic, so handles to the same buffer may be cloned and freed from
+// different threads (a single handle must not be used by two threads at once).
+typedef struct {
+    struct __kiln_shared_block* __block;
+} kiln_shared_string_t;
+
+/// @brief Creates a shared string holding a copy of `str_ref`
+/// @param str_ref The contents
+/// @return A handle with a use count of 1 (its block is NULL if the allocation failed)
+kiln_shared_string_t kiln_shared_string_from_kstring_ref(kstring_ref_t str_ref);
+
+/// @brief Creates a shared string from a C-style string
+/// @param cstr The contents
+/// @return A handle with a use count of 1
+kiln_shared_string_t kiln_shared_string_from_cstr(const char* cstr);
+
+/// @brief Moves a kiln_string_t into a new shared string without copying its buffer
+/// @param string The string to take over, its pointer is set to NULL
+/// @return A handle with a use count of 1
+kiln_shared_string_t kiln_shared_string_from_kiln_string(kiln_string_t* string);
+
+/// @brief Returns a new handle to the same buffer (no copy, only the count is incremented)
+/// @param shared The handle to clone
+/// @return The new handle, free it with `kiln_shared_string_free`
+kiln_shared_string_t kiln_shared_string_clone(const kiln_shared_string_t* shared);
+
+/// @brief Releases a handle, the buffer is freed with the last one. Sets the handle to NULL
+/// @param shared 
+void kiln_shared_string_free(kiln_shared_string_t* shared);
+
+/// @brief Returns a view of the shared buffer. It stays valid until this handle is mutated or freed
+/// @param shared 
+/// @return The contents, NUL terminated
+kstring_ref_t kiln_shared_string_view(const kiln_shared_string_t* shared);
+
+/// @brief Returns the number of handles sharing this buffer
+/// @param shared 
+/// @return 0 for a freed handle
+size_t kiln_shared_string_use_count(const kiln_shared_string_t* shared);
+
+/// @brief Gives this handle a buffer nobody else sees (copying it if it is shared) and returns it,
+/// so any kiln_string_* function can be used to modify it. The pointer is valid until the handle is freed.
+/// @param shared 
+/// @return The private kiln_string_t, NULL if the copy could not be allocated
+kiln_string_t* kiln_shared_string_make_mut(kiln_shared_string_t* shared);
+
+/// @brief Copy-on-write version of `kiln_string_push_kstring_ref`
+/// @param shared 
+/// @param str_ref 
+void kiln_shared_string_push_kstring_ref(kiln_shared_string_t* shared, kstring_ref_t str_ref);
+
+/// @brief Copy-on-write version of `kiln_string_push_cstr`
+/// @param shared 
+/// @param cstr 
+void kiln_shared_string_push_cstr(kiln_shared_string_t* shared, const char* cstr);
+
+/// @brief Copy-on-write version of `kiln_string_replace`. Nothing is copied if `old_s` does not occur
+/// @param shared 
+/// @param old_s
+/// @param new_s
+void kiln_shared_string_replace(kiln_shared_string_t* shared, const char* old_s, const char* new_s);
+
+/// @brief Copy-on-write version of `kiln_string_trim_inplace`. Nothing is copied if there is no whitespace to remove
+/// @param shared 
+void kiln_shared_string_trim_inplace(kiln_shared_string_t* shared);
+
+/// @brief Copy-on-write version of `kiln_string_to_ascii_lower`
+/// @param shared 
+void kiln_shared_string_to_ascii_lower(kiln_shared_string_t* shared);
+
+/// @brief Copy-on-write version of `kiln_string_to_ascii_upper`
+/// @param shared 
+void kiln_shared_string_to_ascii_upper(kiln_shared_string_t* shared);
+
+/// @brief Copy-on-write version of `kiln_string_to_unicode_lower`
+/// @param shared 
+void kiln_shared_string_to_unicode_lower(kiln_shared_string_t* shared);
+
+/// @brief Copy-on-write version of `kiln_string_to_unicode_upper`
+/// @param shared 
+void kiln_shared_string_to_unicode_upper(kiln_shared_string_t* shared);
+
+// Immutable string key that carries its length and `kstring_ref_hash` in the same
+// allocation as its bytes. Create it once, then hash lookups and equality checks
+// never rehash or call strlen.
+typedef struct {
+    uint64_t __hash;
+    uint64_t __length;
+    char __bytes[]; // NUL terminated
+} kiln_key_t;
+
+/// @brief Allocates a key holding a copy of `str_ref` and its hash, in one block
+/// @param str_ref The contents
+/// @return The key, NULL if the allocation failed. Release it with `kiln_key_free`
+const kiln_key_t* kiln_key_from_kstring_ref(kstring_ref_t str_ref);
+
+/// @brief Allocates a key from a C-style string
+/// @param cstr The contents
+/// @return The key, NULL if the allocation failed. Release it with `kiln_key_free`
+const kiln_key_t* kiln_key_from_cstr(const char* cstr);
+
+/// @brief Frees a key (NULL is ignored)
+/// @param key 
+void kiln_key_free(const kiln_key_t* key);
+
+/// @brief Returns a view of the key's bytes, valid as long as the key
+/// @param key 
+/// @return A NUL terminated kstring_ref_t
+KILN_STRING_INLINE kstring_ref_t kiln_key_to_kstring_ref(const kiln_key_t* key);
+
+/// @brief Returns the cached hash, equal to `kstring_ref_hash` of the contents
+/// @param key 
+/// @return 
+KILN_STRING_INLINE uint64_t kiln_key_hash(const kiln_key_t* key);
+
+/// @brief Returns the cached length
+/// @param key 
+/// @return 
+KILN_STRING_INLINE uint64_t kiln_key_length(const kiln_key_t* key);
+
+/// @brief Checks if two keys hold the same bytes. Different hashes or lengths reject without touching the bytes
+/// @param k1 
+/// @param k2 
+/// @return true if the keys are equal
+KILN_STRING_INLINE bool kiln_key_equals(const kiln_key_t* k1, const kiln_key_t* k2);
+
+/// @brief Checks if a key equals a kstring_ref_t whose hash is already known (e.g. a probe computed once per lookup)
+/// @param key 
+/// @param str_ref 
+/// @param hash `kstring_ref_hash(str_ref)`
+/// @return true if they are equal
+KILN_STRING_INLINE bool kiln_key_equals_hashed_ref(const kiln_key_t* key, kstring_ref_t str_ref, uint64_t hash);
+
+/// @brief Checks if a key equals a kstring_ref_t (length check, then memcmp)
+/// @param key 
+/// @param str_ref 
+/// @return true if they are equal
+KILN_STRING_INLINE bool kiln_key_equals_kstring_ref(const kiln_key_t* key, kstring_ref_t str_ref);
+
+// A set of prefixes compiled into a flattened byte trie. Matching walks the input
+// once, so testing a path against hundreds of prefixes costs about as much as a
+// single `kstring_ref_starts_with`.
+typedef struct {
+    struct __kiln_trie_node* __nodes;
+    char* __labels;
+    uint32_t* __children;
+    size_t __n_nodes;
+    bool __suffix;
+} kstring_prefix_set_t;
+
+// Same structure built over reversed strings, for ends_with checks such as file extensions
+typedef kstring_prefix_set_t kstring_suffix_set_t;
+
+/// @brief Compiles a list of prefixes into a set that `kstring_prefix_set_match_*` can test in one pass
+/// @param prefixes The prefixes, they are copied so the array may be freed afterwards
+/// @param n Number of prefixes
+/// @return The set, free it with `kstring_prefix_set_free`. An empty set matches nothing (also the result on allocation failure)
+kstring_prefix_set_t kstring_prefix_set_new(const kstring_ref_t* prefixes, size_t n);
+
+/// @brief Frees the memory of a prefix set
+/// @param set 
+void kstring_prefix_set_free(kstring_prefix_set_t* set);
+
+/// @brief Finds the longest prefix in the set that `string` starts with
+/// @param set 
+/// @param string 
+/// @return Index of that prefix in the array passed to `kstring_prefix_set_new` (the lowest one for duplicates), -1 if none matches
+int64_t kstring_prefix_set_match_longest(const kstring_prefix_set_t* set, kstring_ref_t string);
+
+/// @brief Checks if `string` starts with any prefix in the set. Stops at the first (shortest) match
+/// @param set 
+/// @param string 
+/// @return true if some prefix matches
+bool kstring_prefix_set_match_any(const kstring_prefix_set_t* set, kstring_ref_t string);
+
+/// @brief Compiles a list of suffixes into a set (a prefix set over the reversed strings)
+/// @param suffixes The suffixes, they are copied so the array may be freed afterwards
+/// @param n Number of suffixes
+/// @return The set, free it with `kstring_suffix_set_free`
+kstring_suffix_set_t kstring_suffix_set_new(const kstring_ref_t* suffixes, size_t n);
+
+/// @brief Frees the memory of a suffix set
+/// @param set 
+void kstring_suffix_set_free(kstring_suffix_set_t* set);
+
+/// @brief Finds the longest suffix in the set that `string` ends with
+/// @param set 
+/// @param string 
+/// @return Index of that suffix in the array passed to `kstring_suffix_set_new`, -1 if none matches
+int64_t kstring_suffix_set_match_longest(const kstring_suffix_set_t* set, kstring_ref_t string);
+
+/// @brief Checks if `string` ends with any suffix in the set
+/// @param set 
+/// @param string 
+/// @return true if some suffix matches
+bool kstring_suffix_set_match_any(const kstring_suffix_set_t* set, kstring_ref_t string);
+
+// A glob pattern compiled once and matched against kstring_ref_t (no NUL terminator or copy needed)
+typedef struct {
+    struct __kiln_glob_segment* __segments;
+    struct __kiln_glob_atom* __atoms;
+    uint64_t* __classes;
+    char* __literals;
+    uint64_t* __masks;
+    size_t __n_segments;
+    bool __has_star;
+} kstring_glob_t;
+
+/// @brief Compiles a glob pattern. `*` matches any run of bytes (including `/`), `?` any single byte,
+/// `[abc]`, `[a-z]` and `[!...]` / `[^...]` a byte from (or not from) a set, and `\` escapes the next character
+/// @param pattern The NUL terminated pattern
+/// @return The compiled glob, free it with `kstring_glob_free`
+kstring_glob_t kstring_glob_compile(const char* pattern);
+
+/// @brief Compiles a glob pattern given as a kstring_ref_t
+/// @param pattern The pattern (see `kstring_glob_compile`)
+/// @return The compiled glob, free it with `kstring_glob_free`
+kstring_glob_t kstring_glob_compile_ref(kstring_ref_t pattern);
+
+/// @brief Frees the memory of a compiled glob
+/// @param glob 
+void kstring_glob_free(kstring_glob_t* glob);
+
+/// @brief Checks if a whole kstring_ref_t matches the glob. `*` never backtracks and each segment between
+/// `*`s is found in one left to right pass (the find kernel for literals, Shift-And otherwise), so the cost
+/// is linear in the input for segments of up to 64 atoms. Longer segments also check their atoms past the
+/// 64th at each hit of the first 64
+/// @param glob 
+/// @param string 
+/// @return true if it matches
+bool kstring_glob_match(const kstring_glob_t* glob, kstring_ref_t string);
+
+/// @brief Matches many strings against one glob. Large batches are split across the built-in thread pool
+/// @param glob 
+/// @param strings The strings to test
+/// @param n Number of strings
+/// @param out If not NULL, out[i] is set to whether strings[i] matches
+/// @return The number of strings that match
+size_t kstring_glob_match_many(const kstring_glob_t* glob, const kstring_ref_t* strings, size_t n, bool* out);
+
+// Streaming CSV/TSV tokenizer over an in-memory document. Fields come back as
+// kstring_ref_t spans into the input; see kiln_string_csv.c for how quoted
+// separators are found without a per-byte state machine.
+typedef struct {
+    kstring_ref_t __input;
+    uint64_t __field_start;
+    uint64_t __block_base;
+    uint64_t __next_block;
+    uint64_t __sep_bits;
+    uint64_t __quote_carry;
+    char __delimiter;
+    bool __last_was_newline;
+    bool __done;
+} kiln_csv_reader_t;
+
+typedef struct {
+    // The field's bytes. For quoted fields the surrounding quotes are stripped, but doubled
+    // quotes inside are left as they are (see `needs_unescape`)
+    kstring_ref_t value;
+    // The field started with a quote
+    bool quoted;
+    // `value` contains "" pairs, use `kiln_csv_field_unescape_into` to get the real contents
+    bool needs_unescape;
+    // This is the last field of its record (followed by a newline or the end of the input)
+    bool end_of_record;
+} kiln_csv_field_t;
+
+/// @brief Creates a reader over CSV (or TSV, with '\t') data. The input is only read, never copied,
+/// so it must outlive the reader and the fields it returns
+/// @param input The whole document, e.g. a buffer or an mmap'd file
+/// @param delimiter The field separator, usually ',' or '\t'
+/// @return The reader
+kiln_csv_reader_t kiln_csv_reader_new(kstring_ref_t input, char delimiter);
+
+/// @brief Reads the next field. Both "\n" and "\r\n" end a record
+/// @param reader 
+/// @param field Set to the field, see `kiln_csv_field_t`
+/// @return false once the input is exhausted
+bool kiln_csv_reader_next(kiln_csv_reader_t* reader, kiln_csv_field_t* field);
+
+/// @brief Appends the value of a field to `string`, turning doubled quotes ("") back into single ones
+/// @param string The kiln_string_t to append to
+/// @param field A field returned by `kiln_csv_reader_next`
+void kiln_csv_field_unescape_into(kiln_string_t* string, kiln_csv_field_t field);
+
+/// @brief Appends `ref` to `string` escaped for use inside a JSON string literal (the quotes are not added).
+/// The exact output size is counted first, so the string grows at most once; clean runs are copied with memcpy
+/// @param string The kiln_string_t to append to
+/// @param ref The raw bytes
+void kiln_string_push_json_escaped(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Appends the unescaped contents of a JSON string literal (without its quotes) to `string`.
+/// \uXXXX escapes are written as UTF-8, including surrogate pairs. Runs without a backslash are copied with memcpy
+/// @param string The kiln_string_t to append to
+/// @param ref The escaped text
+/// @return false if `ref` has an invalid escape or lone surrogate, `string` is left unchanged in that case
+bool kstring_ref_json_unescape_into(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Appends the padded base64 encoding (standard alphabet) of `ref` to `string`.
+/// The output size is known up front, so the string grows at most once and the kernel writes straight into it
+/// @param string The kiln_string_t to append to
+/// @param ref The raw bytes
+void kiln_string_push_base64(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Appends the lowercase hex encoding of `ref` to `string`, two digits per byte.
+/// The string grows at most once and the kernel writes straight into it
+/// @param string The kiln_string_t to append to
+/// @param ref The raw bytes
+void kiln_string_push_hex(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Appends the bytes encoded by the base64 text `ref` to `string`.
+/// Padding is optional, but if present it must make the length a multiple of 4. Whitespace is not skipped
+/// @param string The kiln_string_t to append to
+/// @param ref The base64 text (standard alphabet)
+/// @return false if `ref` is not valid base64, `string` is left unchanged in that case
+bool kstring_ref_base64_decode_into(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Appends the bytes encoded by the hex text `ref` to `string`. Upper and lowercase digits are accepted
+/// @param string The kiln_string_t to append to
+/// @param ref The hex text, two digits per byte
+/// @return false if `ref` has an odd length or a non hex character, `string` is left unchanged in that case
+bool kstring_ref_hex_decode_into(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Appends `ref` to `string` percent-encoded: every byte other than A-Z a-z 0-9 - . _ ~ becomes %XX
+/// (uppercase hex, a space is %20). The exact output size is counted first, so the string grows at most once
+/// @param string The kiln_string_t to append to
+/// @param ref The raw bytes
+void kiln_string_push_url_encoded(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Appends the percent-decoded bytes of `ref` to `string`. Runs without a '%' are copied with memcpy.
+/// '+' is left as is (this is RFC 3986 decoding, not form decoding)
+/// @param string The kiln_string_t to append to
+/// @param ref The encoded text
+/// @return false if a '%' is not followed by two hex digits, `string` is left unchanged in that case
+bool kstring_ref_url_decode_into(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Appends `ref` to `string` with & < > " ' replaced by &amp; &lt; &gt; &quot; &#39;, which is safe
+/// for both element content and quoted attribute values. The string grows at most once
+/// @param string The kiln_string_t to append to
+/// @param ref The raw text
+void kiln_string_push_html_escaped(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Appends `ref` to `string` with ASCII letters lowercased, other bytes are copied as they are
+/// @param string The kiln_string_t to append to (must not be the memory `ref` points into)
+/// @param ref The source text
+void kstring_ref_to_ascii_lower_into(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Appends `ref` to `string` with ASCII letters uppercased, other bytes are copied as they are
+/// @param string The kiln_string_t to append to (must not be the memory `ref` points into)
+/// @param ref The source text
+void kstring_ref_to_ascii_upper_into(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Appends `ref` to `string` lowercased like `kiln_string_to_unicode_lower`
+/// @param string The kiln_string_t to append to (must not be the memory `ref` points into)
+/// @param ref The source text
+void kstring_ref_to_unicode_lower_into(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Appends `ref` to `string` uppercased like `kiln_string_to_unicode_upper`
+/// @param string The kiln_string_t to append to (must not be the memory `ref` points into)
+/// @param ref The source text
+void kstring_ref_to_unicode_upper_into(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Writes `ref` with ASCII letters lowercased and a NUL terminator to `buf`
+/// @param ref The source text
+/// @param buf The output buffer, only written to if the result fits
+/// @param buf_size Size of `buf` in bytes
+/// @return The length of the result; it was written only if this is less than `buf_size`
+uint64_t kstring_ref_to_ascii_lower_buf(kstring_ref_t ref, char* buf, uint64_t buf_size);
+
+/// @brief Writes `ref` with ASCII letters uppercased and a NUL terminator to `buf`
+/// @param ref The source text
+/// @param buf The output buffer, only written to if the result fits
+/// @param buf_size Size of `buf` in bytes
+/// @return The length of the result; it was written only if this is less than `buf_size`
+uint64_t kstring_ref_to_ascii_upper_buf(kstring_ref_t ref, char* buf, uint64_t buf_size);
+
+/// @brief Writes `ref` lowercased like `kiln_string_to_unicode_lower` and a NUL terminator to `buf`
+/// @param ref The source text
+/// @param buf The output buffer, only written to if the result fits
+/// @param buf_size Size of `buf` in bytes
+/// @return The length of the result; it was written only if this is less than `buf_size`
+uint64_t kstring_ref_to_unicode_lower_buf(kstring_ref_t ref, char* buf, uint64_t buf_size);
+
+/// @brief Writes `ref` uppercased like `kiln_string_to_unicode_upper` and a NUL terminator to `buf`
+/// @param ref The source text
+/// @param buf The output buffer, only written to if the result fits
+/// @param buf_size Size of `buf` in bytes
+/// @return The length of the result; it was written only if this is less than `buf_size`
+uint64_t kstring_ref_to_unicode_upper_buf(kstring_ref_t ref, char* buf, uint64_t buf_size);
+
+/// @brief Appends `ref` without its leading and trailing whitespace to `string`
+/// @param string The kiln_string_t to append to (must not be the memory `ref` points into)
+/// @param ref The source text
+void kstring_ref_trim_into(kiln_string_t* string, kstring_ref_t ref);
+
+/// @brief Writes `ref` without its leading and trailing whitespace and a NUL terminator to `buf`
+/// @param ref The source text
+/// @param buf The output buffer, only written to if the result fits
+/// @param buf_size Size of `buf` in bytes
+/// @return The length of the result; it was written only if this is less than `buf_size`
+uint64_t kstring_ref_trim_buf(kstring_ref_t ref, char* buf, uint64_t buf_size);
+
+/// @brief Appends `ref` with every non-overlapping occurrence of `old_s` replaced by `new_s` to `string`.
+/// Matches are found left to right like `kiln_string_replace`; an empty `old_s` copies `ref` unchanged
+/// @param string The kiln_string_t to append to (must not be the memory `ref` points into)
+/// @param ref The source text
+/// @param old_s The text to replace
+/// @param new_s The replacement
+void kstring_ref_replace_into(kiln_string_t* string, kstring_ref_t ref, kstring_ref_t old_s, kstring_ref_t new_s);
+
+/// @brief Writes `ref` with every non-overlapping occurrence of `old_s` replaced by `new_s`, and a NUL terminator, to `buf`
+/// @param ref The source text
+/// @param old_s The text to replace
+/// @param new_s The replacement
+/// @param buf The output buffer, only written to if the result fits
+/// @param buf_size Size of `buf` in bytes
+/// @return The length of the result; it was written only if this is less than `buf_size`
+uint64_t kstring_ref_replace_buf(kstring_ref_t ref, kstring_ref_t old_s, kstring_ref_t new_s, char* buf, uint64_t buf_size);
+
+// A fixed set of keywords (HTTP methods, header names, SQL keywords...) compiled
+// into a minimal perfect hash, so a lookup costs one hash and one comparison
+// whatever the size of the set.
+typedef struct {
+    uint64_t __seed;
+    uint32_t* __displacements;
+    struct __kiln_keyword_slot* __slots;
+    char* __bytes;
+    uint32_t __n_slots;
+    uint32_t __n_buckets;
+    bool __ok;
+} kstring_keyword_set_t;
+
+/// @brief Builds a minimal perfect hash over a fixed list of keywords
+/// @param keywords The keywords, they are copied so the array may be freed afterwards
+/// @param n Number of keywords
+/// @return The set, free it with `kstring_keyword_set_free`. If it could not be built (allocation failure, or more
+/// than 2^32 bytes of keywords) it matches nothing and `kstring_keyword_set_ok` returns false
+kstring_keyword_set_t kstring_keyword_set_new(const kstring_ref_t* keywords, size_t n);
+
+/// @brief Frees the memory of a keyword set
+/// @param set 
+void kstring_keyword_set_free(kstring_keyword_set_t* set);
+
+/// @brief Tells a set that was built apart from one that failed to build
+/// @param set 
+/// @return true if `kstring_keyword_set_new` built the set (also for an empty keyword list), false if it failed
+bool kstring_keyword_set_ok(const kstring_keyword_set_t* set);
+
+/// @brief Looks `string` up in the set: one hash, one length check and one memcmp
+/// @param set 
+/// @param string 
+/// @return Index of the keyword in the array passed to `kstring_keyword_set_new` (the lowest one for duplicates), -1 if it is not in the set
+int64_t kstring_keyword_set_lookup(const kstring_keyword_set_t* set, kstring_ref_t string);
+
+// Work-stealing thread pool for bulk work over arrays of strings. Pass NULL
+// wherever a pool is expected to use the built-in one (one thread per core,
+// also used by the `_par_` functions and `kstring_ref_sort_parallel`).
+typedef struct kiln_pool kiln_pool_t;
+
+/// @brief A range of items for `kiln_string_parallel_for`
+/// @param ctx The context pointer passed to `kiln_string_parallel_for`
+/// @param begin First item of the range
+/// @param end One past the last item of the range
+typedef void (*kiln_range_fn_t)(void* ctx, size_t begin, size_t end);
+
+/// @brief A transform for `kiln_string_parallel_map`
+/// @param string The string at `index`, which may be modified
+/// @param index Its position in the array
+/// @param ctx The context pointer passed to `kiln_string_parallel_map`
+typedef void (*kiln_string_map_fn_t)(kiln_string_t* string, size_t index, void* ctx);
+
+/// @brief A transform for `kstring_ref_parallel_map`
+/// @param ref The string at `index`
+/// @param index Its position in the array
+/// @param ctx The context pointer passed to `kstring_ref_parallel_map`
+typedef void (*kstring_ref_map_fn_t)(kstring_ref_t ref, size_t index, void* ctx);
+
+/// @brief Creates a work-stealing thread pool
+/// @param n_threads Number of threads that run tasks, including the one that submits a job; 0 to use every core
+/// @return The pool, free it with `kiln_pool_free`. NULL on allocation failure (NULL is accepted everywhere as the built-in pool)
+kiln_pool_t* kiln_pool_new(size_t n_threads);
+
+/// @brief Stops the threads of a pool and frees it. Must not be called while a job is running on it
+/// @param pool The pool, NULL does nothing (the built-in pool is never freed)
+void kiln_pool_free(kiln_pool_t* pool);
+
+/// @brief Returns the number of threads that run tasks on `pool` (workers + the submitting thread)
+/// @param pool The pool, NULL for the built-in one
+/// @return Always at least 1
+size_t kiln_pool_thread_count(kiln_pool_t* pool);
+
+/// @brief Calls `fn(ctx, begin, end)` over consecutive ranges covering [0, n), running them concurrently on `pool`,
+/// and waits for all of them. Idle threads steal ranges from busy ones, so uneven ranges balance out.
+/// @param pool The pool, NULL for the built-in one
+/// @param n Number of items
+/// @param grain Items per range, 0 to pick one from `n` and the thread count
+/// @param fn Called once per range; ranges never overlap
+/// @param ctx Passed through to `fn`
+void kiln_string_parallel_for(kiln_pool_t* pool, size_t n, size_t grain, kiln_range_fn_t fn, void* ctx);
+
+/// @brief Calls `fn(&strings[i], i, ctx)` for every string, concurrently on `pool`.
+/// Work is split by byte size, so arrays mixing short and very long strings still balance.
+/// @param pool The pool, NULL for the built-in one
+/// @param strings The strings, each one is only ever touched by the call for its own index
+/// @param n Number of strings
+/// @param fn The transform
+/// @param ctx Passed through to `fn`
+void kiln_string_parallel_map(kiln_pool_t* pool, kiln_string_t* strings, size_t n, kiln_string_map_fn_t fn, void* ctx);
+
+/// @brief Calls `fn(refs[i], i, ctx)` for every ref, concurrently on `pool`. Write results to index `i` of an
+/// output array to keep them in input order.
+/// @param pool The pool, NULL for the built-in one
+/// @param refs The strings
+/// @param n Number of strings
+/// @param fn The transform
+/// @param ctx Passed through to `fn`
+void kstring_ref_parallel_map(kiln_pool_t* pool, const kstring_ref_t* refs, size_t n, kstring_ref_map_fn_t fn, void* ctx);
+
+/// @brief `kiln_string_to_ascii_lower` on every string, concurrently on `pool`
+/// @param pool The pool, NULL for the built-in one
+/// @param strings
+/// @param n Number of strings
+void kiln_string_parallel_to_ascii_lower(kiln_pool_t* pool, kiln_string_t* strings, size_t n);
+
+/// @brief `kiln_string_to_ascii_upper` on every string, concurrently on `pool`
+/// @param pool The pool, NULL for the built-in one
+/// @param strings
+/// @param n Number of strings
+void kiln_string_parallel_to_ascii_upper(kiln_pool_t* pool, kiln_string_t* strings, size_t n);
+
+/// @brief `kiln_string_trim_inplace` on every string, concurrently on `pool`
+/// @param pool The pool, NULL for the built-in one
+/// @param strings
+/// @param n Number of strings
+void kiln_string_parallel_trim_inplace(kiln_pool_t* pool, kiln_string_t* strings, size_t n);
+
+/// @brief `kiln_string_replace` on every string, concurrently on `pool`
+/// @param pool The pool, NULL for the built-in one
+/// @param strings
+/// @param n Number of strings
+/// @param old_s
+/// @param new_s
+void kiln_string_parallel_replace(kiln_pool_t* pool, kiln_string_t* strings, size_t n, const char* old_s, const char* new_s);
+
+/// @brief `kstring_ref_hash` of every ref, concurrently on `pool`
+/// @param pool The pool, NULL for the built-in one
+/// @param refs
+/// @param n Number of strings
+/// @param out Receives the n hashes, `out[i]` is the hash of `refs[i]`
+void kstring_ref_parallel_hash(kiln_pool_t* pool, const kstring_ref_t* refs, size_t n, uint64_t* out);
+
+// Append-only column of strings stored as one byte blob plus an offsets array
+// (Arrow large_utf8 layout): string i is data[offsets[i], offsets[i + 1]).
+// Far fewer allocations than an array of kiln_string_t, and O(1) access.
+typedef struct {
+    kiln_string_t __data;
+    uint64_t* __offsets;
+    uint64_t __count;
+    uint64_t __offsets_capacity;
+} kiln_string_vec_t;
+
+/// @brief Creates an empty string vector with room for `n_strings` strings totalling `n_bytes` bytes
+/// @param n_strings Number of strings to reserve room for
+/// @param n_bytes Total bytes to reserve room for
+/// @return The vector, free it with `kiln_string_vec_free`
+kiln_string_vec_t kiln_string_vec_with_capacity(size_t n_strings, size_t n_bytes);
+
+/// @brief Creates an empty string vector
+/// @return The vector, free it with `kiln_string_vec_free`
+kiln_string_vec_t kiln_string_vec_new(void);
+
+/// @brief Frees the memory of a string vector
+/// @param vec
+void kiln_string_vec_free(kiln_string_vec_t* vec);
+
+/// @brief Removes every string but keeps the allocated memory
+/// @param vec
+void kiln_string_vec_clear(kiln_string_vec_t* vec);
+
+/// @brief Makes room for `n_strings` more strings totalling `n_bytes` more bytes, so that many pushes don't reallocate
+/// @param vec
+/// @param n_strings Number of strings that will be pushed
+/// @param n_bytes Total bytes that will be pushed
+/// @return false if an allocation failed
+bool kiln_string_vec_reserve(kiln_string_vec_t* vec, uint64_t n_strings, uint64_t n_bytes);
+
+/// @brief Appends a copy of `string` to the end of the vector
+/// @param vec
+/// @param string The bytes to append
+void kiln_string_vec_push(kiln_string_vec_t* vec, kstring_ref_t string);
+
+/// @brief Appends every remaining piece of a split to the vector. The blob is grown once up front,
+/// since the pieces are never longer than the string being split
+/// @param vec
+/// @param iter The split, it is exhausted afterwards
+/// @return The number of strings appended
+uint64_t kiln_string_vec_push_split(kiln_string_vec_t* vec, kstring_split_iter_t* iter);
+
+/// @brief Finds the first string equal to `string`, scanning the vector front to back.
+/// Lengths come from the offsets array, so only strings of the right length are compared
+/// @param vec
+/// @param string The string to look for
+/// @return Its index, -1 if it is not in the vector
+int64_t kiln_string_vec_index_of(const kiln_string_vec_t* vec, kstring_ref_t string);
+
+/// @brief Writes the offsets as 32-bit values, for the Arrow utf8/binary layout (the native one is large_utf8)
+/// @param vec
+/// @param out Receives `kiln_string_vec_len(vec) + 1` offsets
+/// @return false (and nothing is written) if the blob is larger than INT32_MAX bytes
+bool kiln_string_vec_export_offsets32(const kiln_string_vec_t* vec, uint32_t* out);
+
+
+/// @brief Returns the number of strings in the vector
+/// @param vec
+/// @return The number of strings
+KILN_STRING_INLINE uint64_t kiln_string_vec_len(const kiln_string_vec_t* vec);
+
+/// @brief Returns string `index` of the vector. Not NUL terminated, and only valid until the next push
+/// @param vec
+/// @param index Must be less than `kiln_string_vec_len(vec)`
+/// @return A kstring_ref_t into the blob
+KILN_STRING_INLINE kstring_ref_t kiln_string_vec_get(const kiln_string_vec_t* vec, uint64_t index);
+
+/// @brief Returns the blob holding every string's bytes back to back
+/// @param vec
+/// @return The blob, `kiln_string_vec_data_len(vec)` bytes long
+KILN_STRING_INLINE const char* kiln_string_vec_data(const kiln_string_vec_t* vec);
+
+/// @brief Returns the total number of bytes of all strings
+/// @param vec
+/// @return The length of the blob
+KILN_STRING_INLINE uint64_t kiln_string_vec_data_len(const kiln_string_vec_t* vec);
+
+/// @brief Returns the offsets array
+/// @param vec
+/// @return `kiln_string_vec_len(vec) + 1` offsets into the blob, the first one is 0. NULL only if allocation failed
+KILN_STRING_INLINE const uint64_t* kiln_string_vec_offsets(const kiln_string_vec_t* vec);
+
+// Read-only string vector over a file written by `kiln_string_vec_save`. The
+// offsets and the blob are used straight from the mapping, without parsing.
+typedef struct {
+    const char* __data;
+    const uint64_t* __offsets;
+    uint64_t __count;
+    void* __map;
+    uint64_t __map_len;
+} kiln_string_vec_view_t;
+
+/// @brief Writes a string vector to `path` in a format `kiln_string_vec_view_open` maps without parsing:
+/// a 64 byte header (magic, version, counts, checksum), the offsets array and the blob, each 64 byte aligned.
+/// An existing file is replaced atomically: the bytes go to a temporary file next to it that is renamed
+/// over `path` once complete, so views of the old file stay valid and readers never see a partial file
+/// @param vec The vector to save
+/// @param path Where to write it
+/// @return false on I/O error, errno tells why
+bool kiln_string_vec_save(const kiln_string_vec_t* vec, const char* path);
+
+/// @brief Maps a file written by `kiln_string_vec_save` and gives access to its strings in place.
+/// Nothing is parsed or copied; the pages are read in on first access
+/// @param view Set to the view, close it with `kiln_string_vec_view_close`
+/// @param path The file to map
+/// @param verify Also check that the offsets are in order and that the checksum matches, which reads the
+/// whole file. Without it only the header is checked, so the file must come from a trusted writer
+/// @return false if the file could not be mapped or is not a valid string vector file
+bool kiln_string_vec_view_open(kiln_string_vec_view_t* view, const char* path, bool verify);
+
+/// @brief Gives access to the strings of a `kiln_string_vec_save` file that is already in memory
+/// (read into a buffer, or mapped by the caller). The view borrows `bytes`, which must outlive it
+/// @param view Set to the view
+/// @param bytes The whole file, 8 byte aligned
+/// @param verify See `kiln_string_vec_view_open`
+/// @return false if `bytes` is not a valid string vector file
+bool kiln_string_vec_view_from_buffer(kiln_string_vec_view_t* view, kstring_ref_t bytes, bool verify);
+
+/// @brief Unmaps a view opened with `kiln_string_vec_view_open`. Refs taken from it become invalid
+/// @param view
+void kiln_string_vec_view_close(kiln_string_vec_view_t* view);
+
+/// @brief Copies a view into a new, growable string vector (two memcpys, no per-string work)
+/// @param view
+/// @return The vector, free it with `kiln_string_vec_free`
+kiln_string_vec_t kiln_string_vec_from_view(const kiln_string_vec_view_t* view);
+
+
+/// @brief Returns the number of strings in the view
+/// @param view
+/// @return The number of strings
+KILN_STRING_INLINE uint64_t kiln_string_vec_view_len(const kiln_string_vec_view_t* view);
+
+/// @brief Returns string `index` of the view. The bytes are read only and not NUL terminated
+/// @param view
+/// @param index Must be less than `kiln_string_vec_view_len(view)`
+/// @return A kstring_ref_t into the file, valid until the view is closed
+KILN_STRING_INLINE kstring_ref_t kiln_string_vec_view_get(const kiln_string_vec_view_t* view, uint64_t index);
+
+// Collects kstring_ref_t pieces of an output (headers, body fragments...) so they
+// can be written with one writev instead of being concatenated first.
+typedef struct {
+    kstring_ref_t* __refs;
+    size_t __count;
+    size_t __capacity;
+    uint64_t __total;
+    // Set when a push could not be stored, makes write and collect fail until the next clear
+    bool __failed;
+} kiln_iov_builder_t;
+
+/// @brief Writes the bytes of `refs` to `fd` in order, as if they had been concatenated, without copying them.
+/// Refs are passed to writev in batches of up to IOV_MAX; partial writes and EINTR are retried until
+/// everything is written
+/// @param fd A file descriptor open for writing. With a non-blocking fd, EAGAIN is returned as an error
+/// @param refs The pieces to write
+/// @param n Number of pieces
+/// @return true if every byte was written, false on error (errno tells why; an unknown prefix may have been written)
+bool kiln_write_refs(int fd, const kstring_ref_t* refs, size_t n);
+
+/// @brief Creates an empty builder that collects refs for `kiln_iov_builder_write` without copying their bytes
+/// @return The builder, free it with `kiln_iov_builder_free`
+kiln_iov_builder_t kiln_iov_builder_new(void);
+
+/// @brief Frees the memory of a builder (not the bytes its refs point to)
+/// @param builder
+void kiln_iov_builder_free(kiln_iov_builder_t* builder);
+
+/// @brief Removes every ref but keeps the allocated memory, so a builder can be reused per response.
+/// Also forgets a failed push
+/// @param builder
+void kiln_iov_builder_clear(kiln_iov_builder_t* builder);
+
+/// @brief Appends a ref. Only the ref is stored, its bytes must stay valid until the builder is written.
+/// A ref that starts where the previous one ends is merged into it, and empty refs are dropped.
+/// If the ref array can't grow, the builder is marked failed and every later write or collect fails,
+/// so the output is never silently missing a piece
+/// @param builder
+/// @param ref The bytes to append
+void kiln_iov_builder_push(kiln_iov_builder_t* builder, kstring_ref_t ref);
+
+/// @brief Returns the number of bytes collected so far
+/// @param builder
+/// @return The total length of every ref pushed since the last clear
+uint64_t kiln_iov_builder_len(const kiln_iov_builder_t* builder);
+
+/// @brief Writes every collected ref to `fd` with `kiln_write_refs`
+/// @param builder
+/// @param fd A file descriptor open for writing
+/// @return true if every byte was written, false on error (errno tells why). Fails with ENOMEM without
+/// writing anything if a push since the last clear could not be stored
+bool kiln_iov_builder_write(const kiln_iov_builder_t* builder, int fd);
+
+/// @brief Appends every collected ref to `string`, for when the pieces have to end up in one buffer after all
+/// @param string The kiln_string_t to append to, grown once
+/// @param builder
+/// @return false, with `string` unchanged, if a push since the last clear could not be stored or the string
+/// could not grow
+bool kiln_iov_builder_collect_into(kiln_string_t* string, const kiln_iov_builder_t* builder);
+
+
+#if defined(KILN_STRING_HEADER_ONLY) || defined(KILN_STRING_IMPLEMENTATION)
+
+KILN_STRING_INLINE_DEF kiln_string_t kstring_ref_to_kiln_string(kstring_ref_t str_ref) {
+	return kiln_string_from_kstring_ref(str_ref);
+}
+
+KILN_STRING_INLINE_DEF kstring_ref_t kiln_string_to_kstring_ref(const kiln_string_t* string) {
+	kstring_ref_t ref;
+	ref.__length = string->__length;
+	ref.ptr = string->ptr;
+	return ref;
+}
+
+KILN_STRING_INLINE_DEF kstring_ref_t kstring_ref_from_kiln_string(const kiln_string_t* string) {
+	return kiln_string_to_kstring_ref(string);
+}
+
+KILN_STRING_INLINE_DEF kstring_ref_t kstring_ref_from_cstr(char* string) {
+    return (kstring_ref_t) {
+        .__length = strlen(string),
+        .ptr = string,
+    };
+}
+
+KILN_STRING_INLINE_DEF void kiln_string_free(kiln_string_t* str) {
+	if (str->__capacity & KILN_STRING_MAPPED) {
+		__kiln_string_unmap(str);
+	} else {
+		free(str->ptr);
+	}
+	str->ptr = NULL;
+}
+
+KILN_STRING_INLINE_DEF void kiln_string_push_cstr(kiln_string_t* string, char* cstr) {
+	uint64_t length = strlen(cstr);
+	kstring_ref_t str_ref = {
+		.__length = length,
+		.ptr = cstr
+	};
+
+	kiln_string_push_kstring_ref(string, str_ref);
+}
+
+KILN_STRING_INLINE_DEF kstring_ref_t kiln_string_substring(const kiln_string_t* string, int64_t start_idx, int64_t end_idx) {
+    kstring_ref_t ref = {string->ptr, string->__length};
+    return kstring_ref_substring(ref, start_idx, end_idx);
+}
+
+KILN_STRING_INLINE_DEF bool kstring_ref_equals_cstr(kstring_ref_t string, const char* other) {
+    uint64_t other_len = strlen(other);
+    
+    if (string.__length != other_len) {
+        return false;
+    }
+    
+    return memcmp(string.ptr, other, string.__length) == 0;
+}
+
+KILN_STRING_INLINE_DEF bool kstring_ref_equals_kiln_string(kstring_ref_t string, const kiln_string_t* other) {
+    kstring_ref_t ref = kiln_string_to_kstring_ref(other);
+    
+    if (string.__length != ref.__length) {
+        return false;
+    }
+    
+    return memcmp(string.ptr, ref.ptr, string.__length) == 0;
+}
+
+KILN_STRING_INLINE_DEF bool kstring_ref_equals(kstring_ref_t s1, kstring_ref_t s2) {    
+    if (s1.__length != s2.__length) {
+        return false;
+    }
+    return memcmp(s1.ptr, s2.ptr, s1.__length) == 0;
+}
+
+KILN_STRING_INLINE_DEF bool kiln_string_equals_cstr(const kiln_string_t* string, const char* other) {
+    kstring_ref_t ref = {string->ptr, string->__length};
+    return kstring_ref_equals_cstr(ref, other);
+}
+
+KILN_STRING_INLINE_DEF bool kiln_string_equals_kstring_ref(const kiln_string_t* string, kstring_ref_t other) {
+    kstring_ref_t ref = {string->ptr, string->__length};
+    return kstring_ref_equals(ref, other);
+}
+
+KILN_STRING_INLINE_DEF bool kiln_string_equals(const kiln_string_t* s1, const kiln_string_t* s2) {
+	kstring_ref_t ref_1 = {s1->ptr, s1->__length};
+	kstring_ref_t ref_2 = {s2->ptr, s2->__length};
+	return kstring_ref_equals(ref_1, ref_2);
+}
+
+KILN_STRING_INLINE_DEF int32_t kiln_string_compare(const kiln_string_t* s1, const kiln_string_t* s2) {
+    kstring_ref_t r1 = {s1->ptr, s1->__length};
+    kstring_ref_t r2 = {s2->ptr, s2->__length};
+    return kstring_ref_compare(r1, r2);
+}
+
+KILN_STRING_INLINE_DEF int64_t kiln_string_find(const kiln_string_t* string, const char* target) {
+    kstring_ref_t ref = {string->ptr, string->__length};
+    return kstring_ref_find(ref, target);
+}
+
+KILN_STRING_INLINE_DEF int64_t kiln_string_rfind(const kiln_string_t* string, const char* target) {
+    kstring_ref_t ref = {string->ptr, string->__length};
+    return kstring_ref_rfind(ref, target);
+}
+
+KILN_STRING_INLINE_DEF void kiln_string_partition(const kiln_string_t* string, const char* delimiter, kstring_ref_t output_buffer[2]) {
+    kstring_ref_t ref = {string->ptr, string->__length};
+    kstring_ref_partition(ref, delimiter, output_buffer);
+}
+
+KILN_STRING_INLINE_DEF void kiln_string_rpartition(const kiln_string_t* string, const char* delimiter, kstring_ref_t output_buffer[2]) {
+    kstring_ref_t ref = {string->ptr, string->__length};
+    kstring_ref_rpartition(ref, delimiter, output_buffer);
+}
+
+KILN_STRING_INLINE_DEF kstring_ref_t kiln_key_to_kstring_ref(const kiln_key_t* key) {
+    return (kstring_ref_t) {
+        .ptr = (char*)key->__bytes,
+        .__length = key->__length,
+    };
+}
+
+KILN_STRING_INLINE_DEF uint64_t kiln_key_hash(const kiln_key_t* key) {
+    return key->__hash;
+}
+
+KILN_STRING_INLINE_DEF uint64_t kiln_key_length(const kiln_key_t* key) {
+    return key->__length;
+}
+
+KILN_STRING_INLINE_DEF bool kiln_key_equals(const kiln_key_t* k1, const kiln_key_t* k2) {
+    if (k1 == k2) {
+        return true;
+    }
+    if (k1->__hash != k2->__hash || k1->__length != k2->__length) {
+        return false;
+    }
+    return memcmp(k1->__bytes, k2->__bytes, k1->__length) == 0;
+}
+
+KILN_STRING_INLINE_DEF bool kiln_key_equals_hashed_ref(const kiln_key_t* key, kstring_ref_t str_ref, uint64_t hash) {
+    if (key->__hash != hash || key->__length != str_ref.__length) {
+        return false;
+    }
+    return memcmp(key->__bytes, str_ref.ptr, str_ref.__length) == 0;
+}
+
+KILN_STRING_INLINE_DEF bool kiln_key_equals_kstring_ref(const kiln_key_t* key, kstring_ref_t str_ref) {
+    if (key->__length != str_ref.__length) {
+        return false;
+    }
+    return memcmp(key->__bytes, str_ref.ptr, str_ref.__length) == 0;
+}
+
+KILN_STRING_INLINE_DEF uint64_t kiln_string_vec_len(const kiln_string_vec_t* vec) {
+    return vec->__count;
+}
+
+KILN_STRING_INLINE_DEF kstring_ref_t kiln_string_vec_get(const kiln_string_vec_t* vec, uint64_t index) {
+    uint64_t start = vec->__offsets[index];
+    return (kstring_ref_t){ .ptr = vec->__data.ptr + start, .__length = vec->__offsets[index + 1] - start };
+}
+
+KILN_STRING_INLINE_DEF const char* kiln_string_vec_data(const kiln_string_vec_t* vec) {
+    return vec->__data.ptr;
+}
+
+KILN_STRING_INLINE_DEF uint64_t kiln_string_vec_data_len(const kiln_string_vec_t* vec) {
+    return vec->__data.__length;
+}
+
+KILN_STRING_INLINE_DEF const uint64_t* kiln_string_vec_offsets(const kiln_string_vec_t* vec) {
+    return vec->__offsets;
+}
+
+KILN_STRING_INLINE_DEF uint64_t kiln_string_vec_view_len(const kiln_string_vec_view_t* view) {
+    return view->__count;
+}
+
+KILN_STRING_INLINE_DEF kstring_ref_t kiln_string_vec_view_get(const kiln_string_vec_view_t* view, uint64_t index) {
+    uint64_t start = view->__offsets[index];
+    return (kstring_ref_t){ .ptr = (char*)view->__data + start, .__length = view->__offsets[index + 1] - start };
+}
 
+#endif // KILN_STRING_HEADER_ONLY || KILN_STRING_IMPLEMENTATION
 
 #endif // KILN_STRING_H
\ No newline at end of file
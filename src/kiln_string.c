@@ -4,8 +4,15 @@
 #include <stdbool.h>
 #include <ctype.h>
 #include <stddef.h>
+#include <stdatomic.h>
+#if defined(__GLIBC__) || defined(__linux__)
+#include <malloc.h>
+#define KILN_STRING_HAVE_USABLE_SIZE 1
+#endif
 
+#define KILN_STRING_IMPLEMENTATION
 #include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
 
 /// @brief Copies the data from string to it's own internal buffer
 /// @param string 
@@ -19,7 +26,9 @@ kiln_string_t kiln_string_from_cstr(const char* string) {
 	};
 
 	k_str.ptr = (char*) malloc(length + 1);
+	KILN_STATS_ALLOC(length + 1);
 	memcpy(k_str.ptr, string, length);
+	KILN_STATS_COPY(length);
 	k_str.ptr[length] = '\0';
 
 	return k_str;
@@ -28,14 +37,16 @@ kiln_string_t kiln_string_from_cstr(const char* string) {
 /// @brief Creates a string from a kstring_ref_t by compying the contents. 
 /// @param str_ref 
 /// @return 
-inline kiln_string_t kiln_string_from_kstring_ref(kstring_ref_t str_ref) {
+kiln_string_t kiln_string_from_kstring_ref(kstring_ref_t str_ref) {
 	kiln_string_t str = {
 		.__length = str_ref.__length,
 		.__capacity = (str_ref.__length + 1)
 	};
 
 	str.ptr = (char*) malloc(str.__capacity);
+	KILN_STATS_ALLOC(str.__capacity);
 	memcpy(str.ptr, str_ref.ptr, str.__length);
+	KILN_STATS_COPY(str.__length);
 	str.ptr[str.__length] = '\0';
 
 	return str;
@@ -45,81 +56,218 @@ inline kiln_string_t kiln_string_from_kstring_ref(kstring_ref_t str_ref) {
 /// @param capacity 
 /// @return 
 kiln_string_t kiln_string_with_capacity(size_t capacity) {
-    return (kiln_string_t) {
+    kiln_string_t str = {
         .ptr = malloc(capacity),
         .__length = 0,
         .__capacity = capacity,
     };
+    if (str.ptr == NULL) {
+        str.__capacity = 0;
+        return str;
+    }
+    KILN_STATS_ALLOC(capacity);
+    return str;
 }
 
-/// @brief Creates a string from a kstring_ref_t by compying the contents. 
-/// @param str_ref 
-/// @return 
-inline kiln_string_t kstring_ref_to_kiln_string(kstring_ref_t str_ref) {
-	return kiln_string_from_kstring_ref(str_ref);
+
+/// @brief Appends the content of a kstring_ref_t to a KilnString
+/// @param string The kiln_string_t to append to
+/// @param str_ref The kstring_ref_t to append
+void kiln_string_push_kstring_ref(kiln_string_t* string, kstring_ref_t str_ref) {
+    uint64_t new_length = string->__length + str_ref.__length;
+    
+    if (!__kiln_string_grow(string, new_length + 1)) {
+        return;
+    }
+    
+    memcpy(string->ptr + string->__length, str_ref.ptr, str_ref.__length);
+    KILN_STATS_COPY(str_ref.__length);
+    
+    string->__length = new_length;
+    
+    string->ptr[string->__length] = '\0';
 }
 
-inline kstring_ref_t kiln_string_to_kstring_ref(const kiln_string_t* string) {
-	kstring_ref_t ref;
-	ref.__length = string->__length;
-	ref.ptr = string->ptr;
-	return ref;
+
+/// @brief Total length of `refs` joined with `sep` between them
+static uint64_t joined_length(const kstring_ref_t* refs, size_t n, kstring_ref_t sep) {
+    uint64_t total = n > 0 ? (uint64_t)(n - 1) * sep.__length : 0;
+    for (size_t i = 0; i < n; i++) {
+        total += refs[i].__length;
+    }
+    return total;
 }
 
-inline kstring_ref_t kstring_ref_from_kiln_string(const kiln_string_t* string) {
-	return kiln_string_to_kstring_ref(string);
+/// @brief Copies `refs` joined with `sep` to `out`, which must hold `joined_length` bytes
+static void join_into(char* out, const kstring_ref_t* refs, size_t n, kstring_ref_t sep) {
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0) {
+            memcpy(out, sep.ptr, sep.__length);
+            out += sep.__length;
+        }
+        memcpy(out, refs[i].ptr, refs[i].__length);
+        out += refs[i].__length;
+    }
 }
 
-inline kstring_ref_t kstring_ref_from_cstr(char* string) {
-    return (kstring_ref_t) {
-        .__length = strlen(string),
-        .ptr = string,
+/// @brief Appends `refs` to `string` with `sep` between consecutive pieces.
+/// The total length is computed first, so the string grows at most once
+/// @param string The kiln_string_t to append to
+/// @param refs The pieces
+/// @param n Number of pieces
+/// @param sep The separator, may be empty
+void kiln_string_push_join(kiln_string_t* string, const kstring_ref_t* refs, size_t n, kstring_ref_t sep) {
+    uint64_t added = joined_length(refs, n, sep);
+    if (!__kiln_string_grow(string, string->__length + added + 1)) {
+        return;
+    }
+
+    join_into(string->ptr + string->__length, refs, n, sep);
+    KILN_STATS_COPY(added);
+    string->__length += added;
+    string->ptr[string->__length] = '\0';
+}
+
+/// @brief Appends all of `refs` to `string`, growing it at most once
+/// @param string The kiln_string_t to append to
+/// @param refs The pieces
+/// @param n Number of pieces
+void kiln_string_push_concat(kiln_string_t* string, const kstring_ref_t* refs, size_t n) {
+    kstring_ref_t no_sep = { .ptr = "", .__length = 0 };
+    kiln_string_push_join(string, refs, n, no_sep);
+}
+
+/// @brief Creates a string holding `refs` with `sep` between consecutive pieces, with one exact-size allocation
+/// @param refs The pieces
+/// @param n Number of pieces
+/// @param sep The separator, may be empty
+/// @return The joined string (empty if n is 0)
+kiln_string_t kiln_string_join(const kstring_ref_t* refs, size_t n, kstring_ref_t sep) {
+    uint64_t length = joined_length(refs, n, sep);
+    kiln_string_t str = {
+        .__length = length,
+        .__capacity = length + 1
     };
+
+    str.ptr = (char*) malloc(str.__capacity);
+    if (str.ptr == NULL) {
+        return (kiln_string_t) {0};
+    }
+    KILN_STATS_ALLOC(str.__capacity);
+    join_into(str.ptr, refs, n, sep);
+    KILN_STATS_COPY(length);
+    str.ptr[length] = '\0';
+
+    return str;
 }
 
-/// @brief Frees the memory allocated by the kiln string. Sets the pointer to NULL
-/// @param str 
-/// @return 
-inline void kiln_string_free(kiln_string_t* str) {
-	free(str->ptr);
-	str->ptr = NULL;
+/// @brief Creates a string holding all of `refs` back to back, with one exact-size allocation
+/// @param refs The pieces
+/// @param n Number of pieces
+/// @return The concatenated string (empty if n is 0)
+kiln_string_t kiln_string_concat(const kstring_ref_t* refs, size_t n) {
+    kstring_ref_t no_sep = { .ptr = "", .__length = 0 };
+    return kiln_string_join(refs, n, no_sep);
 }
 
-/// @brief Appends the content of a char* to a KilnString
-/// @param string 
-/// @param cstr 
-inline void kiln_string_push_cstr(kiln_string_t* string, char* cstr) {
-	uint64_t length = strlen(cstr);
-	kstring_ref_t str_ref = {
-		.__length = length,
-		.ptr = cstr
-	};
 
-	kiln_string_push_kstring_ref(string, str_ref);
+static _Atomic int growth_policy = KILN_GROWTH_DOUBLE;
+
+/// @brief Sets how `kiln_string_t`s grow when an append runs out of capacity. Applies process wide
+/// @param policy See `kiln_string_growth_t`
+void kiln_string_set_growth_policy(kiln_string_growth_t policy) {
+    atomic_store_explicit(&growth_policy, (int)policy, memory_order_relaxed);
 }
 
+/// @brief Returns the growth policy set with `kiln_string_set_growth_policy` (KILN_GROWTH_DOUBLE by default)
+kiln_string_growth_t kiln_string_get_growth_policy(void) {
+    return (kiln_string_growth_t)atomic_load_explicit(&growth_policy, memory_order_relaxed);
+}
 
-/// @brief Appends the content of a kstring_ref_t to a KilnString
-/// @param string The kiln_string_t to append to
-/// @param str_ref The kstring_ref_t to append
-void kiln_string_push_kstring_ref(kiln_string_t* string, kstring_ref_t str_ref) {
-    uint64_t new_length = string->__length + str_ref.__length;
-    
-    if (new_length + 1 > string->__capacity) {
-        uint64_t new_capacity = string->__capacity * 2;
-        if (new_capacity < new_length + 1) {
-            new_capacity = new_length + 1;
+/// @brief Grows `string` so that it can hold at least `min_capacity` bytes (including the NUL terminator).
+/// Capacity grows geometrically (by the current `kiln_string_growth_t`) so repeated appends stay amortised O(1).
+/// Once the new capacity reaches `kiln_string_get_map_threshold`, the buffer moves to (or stays in) an mmap'd
+/// mapping that grows with mremap; if mapping fails the heap is used instead
+/// @return false if the allocation failed, `string` is left untouched in that case
+bool __kiln_string_grow(kiln_string_t* string, uint64_t min_capacity) {
+    uint64_t capacity = __kiln_string_capacity(string);
+    if (min_capacity <= capacity) {
+        return true;
+    }
+
+    kiln_string_growth_t policy = kiln_string_get_growth_policy();
+    uint64_t new_capacity = policy == KILN_GROWTH_DOUBLE
+        ? capacity * 2
+        : capacity + capacity / 2;
+    if (new_capacity < min_capacity) {
+        new_capacity = min_capacity;
+    }
+
+    uint64_t map_threshold = kiln_string_get_map_threshold();
+    if ((string->__capacity & KILN_STRING_MAPPED) || (map_threshold != 0 && new_capacity >= map_threshold)) {
+        if (__kiln_string_map_grow(string, new_capacity)) {
+            KILN_STATS_GROWTH();
+            KILN_STATS_SLACK(__kiln_string_capacity(string) - min_capacity);
+            return true;
         }
-        
-        string->ptr = (char*)realloc(string->ptr, new_capacity);
-        string->__capacity = new_capacity;
+        if (string->__capacity & KILN_STRING_MAPPED) {
+            return false;
+        }
+        // Could not map, fall through to the heap
     }
-    
-    memcpy(string->ptr + string->__length, str_ref.ptr, str_ref.__length);
-    
-    string->__length = new_length;
-    
+
+    char* grown = (char*)realloc(string->ptr, new_capacity);
+    if (grown == NULL) {
+        return false;
+    }
+#ifdef KILN_STRING_HAVE_USABLE_SIZE
+    if (policy == KILN_GROWTH_SIZE_CLASS) {
+        // The allocator rounded the request up to a size class anyway, use all of it
+        new_capacity = malloc_usable_size(grown);
+    }
+#endif
+
+    KILN_STATS_REALLOC(new_capacity);
+    KILN_STATS_GROWTH();
+    KILN_STATS_SLACK(new_capacity - min_capacity);
+
+    string->ptr = grown;
+    string->__capacity = new_capacity;
+    return true;
+}
+
+/// @brief Makes sure `string` can take `additional` more bytes without reallocating.
+/// Grows by the current growth policy, so a series of reserves stays amortised O(1)
+/// @param string The kiln_string_t to grow
+/// @param additional Number of bytes that will be appended
+/// @return false if the allocation failed, `string` is left untouched in that case
+bool kiln_string_reserve(kiln_string_t* string, uint64_t additional) {
+    return __kiln_string_grow(string, string->__length + additional + 1);
+}
+
+/// @brief Reallocates `string` so that its capacity is exactly its length plus the NUL terminator.
+/// Useful for long-lived strings after `kiln_string_trim_inplace`, `kiln_string_remove_suffix` etc.
+/// @param string The kiln_string_t to shrink. Left as it is if the reallocation fails
+void kiln_string_shrink_to_fit(kiln_string_t* string) {
+    uint64_t new_capacity = string->__length + 1;
+    if (string->ptr == NULL || __kiln_string_capacity(string) <= new_capacity) {
+        return;
+    }
+    // Some in place edits only shorten __length, make sure the kept bytes end in a NUL
     string->ptr[string->__length] = '\0';
+    if (string->__capacity & KILN_STRING_MAPPED) {
+        __kiln_string_map_shrink(string, new_capacity);
+        return;
+    }
+
+    char* shrunk = (char*)realloc(string->ptr, new_capacity);
+    if (shrunk == NULL) {
+        return;
+    }
+    KILN_STATS_REALLOC(new_capacity);
+
+    string->ptr = shrunk;
+    string->__capacity = new_capacity;
 }
 
 
@@ -128,55 +276,63 @@ void kiln_string_push_kstring_ref(kiln_string_t* string, kstring_ref_t str_ref)
 /// @param suffix The suffix to check for
 /// @return true if the string ends with the suffix, false otherwise
 bool kiln_string_ends_with(const kiln_string_t* string, const char* suffix) {
-    uint64_t suffix_len = strlen(suffix);
-    
-    if (suffix_len > string->__length) {
-        return false;
-    }
-    
-    return memcmp(string->ptr + (string->__length - suffix_len), suffix, suffix_len) == 0;
+    kstring_ref_t ref = {string->ptr, string->__length};
+    return kstring_ref_ends_with_ref(ref, kstring_ref_from_cstr((char*)suffix));
 }
 
 /// @brief Checks if a kiln_string_t starts with the specified prefix
 /// @param string The string to check
 /// @param prefix The prefix to check for
 /// @return true if the string starts with the prefix, false otherwise
-bool kiln_string_starts_with(const kiln_string_t* string, const char* prefix) {    
-    uint64_t prefix_len = strlen(prefix);
-    
-    if (prefix_len > string->__length) {
-        return false;
-    }
-    
-    return memcmp(string->ptr, prefix, prefix_len) == 0;
+bool kiln_string_starts_with(const kiln_string_t* string, const char* prefix) {
+    kstring_ref_t ref = {string->ptr, string->__length};
+    return kstring_ref_starts_with_ref(ref, kstring_ref_from_cstr((char*)prefix));
 }
 
 /// @brief Checks if a kstring_ref_t ends with the specified suffix
 /// @param string The string reference to check
 /// @param suffix The suffix to check for
 /// @return true if the string ends with the suffix, false otherwise
-bool kstring_ref_ends_with(kstring_ref_t string, const char* suffix) {    
-    uint64_t suffix_len = strlen(suffix);
-    
-    if (suffix_len > string.__length) {
+bool kstring_ref_ends_with(kstring_ref_t string, const char* suffix) {
+    return kstring_ref_ends_with_ref(string, kstring_ref_from_cstr((char*)suffix));
+}
+
+/// @brief Checks if a kstring_ref_t ends with the specified suffix
+/// @param string The string reference to check
+/// @param suffix The suffix to check for
+/// @return true if the string ends with the suffix, false otherwise
+bool kstring_ref_ends_with_ref(kstring_ref_t string, kstring_ref_t suffix) {
+    if (suffix.__length > string.__length) {
         return false;
     }
-    
-    return memcmp(string.ptr + (string.__length - suffix_len), suffix, suffix_len) == 0;
+    if (suffix.__length == 0) {
+        return true;
+    }
+
+    return memcmp(string.ptr + (string.__length - suffix.__length), suffix.ptr, suffix.__length) == 0;
 }
 
 /// @brief Checks if a kstring_ref_t starts with the specified prefix
 /// @param string The string reference to check
 /// @param prefix The prefix to check for
 /// @return true if the string starts with the prefix, false otherwise
-bool kstring_ref_starts_with(kstring_ref_t string, const char* prefix) {    
-    uint64_t prefix_len = strlen(prefix);
-    
-    if (prefix_len > string.__length) {
+bool kstring_ref_starts_with(kstring_ref_t string, const char* prefix) {
+    return kstring_ref_starts_with_ref(string, kstring_ref_from_cstr((char*)prefix));
+}
+
+/// @brief Checks if a kstring_ref_t starts with the specified prefix
+/// @param string The string reference to check
+/// @param prefix The prefix to check for
+/// @return true if the string starts with the prefix, false otherwise
+bool kstring_ref_starts_with_ref(kstring_ref_t string, kstring_ref_t prefix) {
+    if (prefix.__length > string.__length) {
         return false;
     }
-    
-    return memcmp(string.ptr, prefix, prefix_len) == 0;
+    if (prefix.__length == 0) {
+        return true;
+    }
+
+    return memcmp(string.ptr, prefix.ptr, prefix.__length) == 0;
 }
 
 /// @brief Removes the specified suffix from the string if it has the suffix, does nothing if otherwise
@@ -215,6 +371,7 @@ bool kiln_string_remove_prefix(kiln_string_t* string, kstring_ref_t prefix) {
 
     if (kstring_ref_equals(ref, prefix)) {
         memmove(string->ptr, &string->ptr[prefix.__length], length_after);
+        KILN_STATS_MOVE(length_after);
         string->__length = length_after;
         return true;
     }
@@ -248,78 +405,6 @@ kstring_ref_t kstring_ref_substring(kstring_ref_t string, int64_t start_idx, int
     return result;
 }
 
-/// @brief Gets a substring from the KilnString
-/// @param string The kiln_string_t to extract substring from
-/// @param start_idx -1 to default to the start (or 0)
-/// @param end_idx -1 to default to the end
-/// @return A kstring_ref_t pointing to the requested substring
-inline kstring_ref_t kiln_string_substring(const kiln_string_t* string, int64_t start_idx, int64_t end_idx) {
-    kstring_ref_t ref = {string->ptr, string->__length};
-    return kstring_ref_substring(ref, start_idx, end_idx);
-}
-
-/// @brief Checks if a kstring_ref_t equals a C-style string
-/// @param string The kstring_ref_t to compare
-/// @param other The C-style string to compare against
-/// @return true if the strings are equal, false otherwise
-inline bool kstring_ref_equals_cstr(kstring_ref_t string, const char* other) {
-    uint64_t other_len = strlen(other);
-    
-    if (string.__length != other_len) {
-        return false;
-    }
-    
-    return memcmp(string.ptr, other, string.__length) == 0;
-}
-
-/// @brief Checks if a kstring_ref_t equals kiln_string_t
-/// @param string The kstring_ref_t to compare
-/// @param other The kiln string to compare against
-/// @return true if the strings are equal, false otherwise
-inline bool kstring_ref_equals_kiln_string(kstring_ref_t string, const kiln_string_t* other) {
-    kstring_ref_t ref = kiln_string_to_kstring_ref(other);
-    
-    if (string.__length != ref.__length) {
-        return false;
-    }
-    
-    return memcmp(string.ptr, other, string.__length) == 0;
-}
-
-/// @brief Checks if two StringRefs are equal
-/// @param s1 The first kstring_ref_t to compare
-/// @param s2 The second kstring_ref_t to compare
-/// @return true if the strings are equal, false otherwise
-inline bool kstring_ref_equals(kstring_ref_t s1, kstring_ref_t s2) {    
-    if (s1.__length != s2.__length) {
-        return false;
-    }
-    return memcmp(s1.ptr, s2.ptr, s1.__length) == 0;
-}
-
-/// @brief Checks if a kiln_string_t equals a C-style string
-/// @param string The kiln_string_t to compare
-/// @param other The C-style string to compare against
-/// @return true if the strings are equal, false otherwise
-inline bool kiln_string_equals_cstr(const kiln_string_t* string, const char* other) {
-    kstring_ref_t ref = {string->ptr, string->__length};
-    return kstring_ref_equals_cstr(ref, other);
-}
-
-inline bool kiln_string_equals_kstring_ref(const kiln_string_t* string, kstring_ref_t other) {
-    kstring_ref_t ref = {string->ptr, string->__length};
-    return kstring_ref_equals(ref, other);
-}
-
-/// @brief Checks if two KilnStrings are equalg
-/// @param s1 The first kiln_string_t to compare
-/// @param s2 The first kiln_string_t to compare
-/// @return true if the strings are equal, false otherwise
-inline bool kiln_string_equals(const kiln_string_t* s1, const kiln_string_t* s2) {
-	kstring_ref_t ref_1 = {s1->ptr, s1->__length};
-	kstring_ref_t ref_2 = {s2->ptr, s2->__length};
-	return kstring_ref_equals(ref_1, ref_2);
-}
 
 /// @brief Compares two StringRefs lexicographically
 /// @param s1 First kstring_ref_t to compare
@@ -328,7 +413,7 @@ inline bool kiln_string_equals(const kiln_string_t* s1, const kiln_string_t* s2)
 int32_t kstring_ref_compare(kstring_ref_t s1, kstring_ref_t s2) {
     uint64_t min_len = s1.__length < s2.__length ? s1.__length : s2.__length;
     
-    int result = memcmp(s1.ptr, s2.ptr, min_len);
+    int result = __kiln_kernels->compare(s1.ptr, s2.ptr, min_len);
     
     if (result != 0) {
         return result;
@@ -341,15 +426,6 @@ int32_t kstring_ref_compare(kstring_ref_t s1, kstring_ref_t s2) {
     return 0;
 }
 
-/// @brief Compares two KilnStrings lexicographically
-/// @param s1 First kiln_string_t to compare
-/// @param s2 Second kiln_string_t to compare
-/// @return 0 if equal, negative if s1 < s2, positive if s1 > s2
-inline int32_t kiln_string_compare(const kiln_string_t* s1, const kiln_string_t* s2) {
-    kstring_ref_t r1 = {s1->ptr, s1->__length};
-    kstring_ref_t r2 = {s2->ptr, s2->__length};
-    return kstring_ref_compare(r1, r2);
-}
 
 /// @brief Converts ASCII characters in a kiln_string_t to lowercase, ignoring non-ASCII characters
 /// @param string The kiln_string_t to convert
@@ -358,12 +434,7 @@ void kiln_string_to_ascii_lower(kiln_string_t* string) {
         return;
     }
     
-    for (uint64_t i = 0; i < string->__length; i++) {
-        unsigned char c = (unsigned char)string->ptr[i];
-        if (c >= 'A' && c <= 'Z') {
-            string->ptr[i] = c + 32;
-        }
-    }
+    __kiln_kernels->to_lower(string->ptr, string->ptr, string->__length);
 }
 
 /// @brief Converts ASCII characters in a kiln_string_t to uppercase, ignoring non-ASCII characters
@@ -373,10 +444,34 @@ void kiln_string_to_ascii_upper(kiln_string_t* string) {
         return;
     }
     
-    for (uint64_t i = 0; i < string->__length; i++) {
-        unsigned char c = (unsigned char)string->ptr[i];
-        if (c >= 'a' && c <= 'z') {
-            string->ptr[i] = c - 32;
+    __kiln_kernels->to_upper(string->ptr, string->ptr, string->__length);
+}
+
+/// @brief Upper cases the UTF-8 text p[start, len) in place (ASCII and the Latin-1 letters)
+void __kiln_unicode_upper_tail(char* p, uint64_t start, uint64_t len) {
+    uint64_t i = start;
+    while (i < len) {
+        unsigned char c = (unsigned char)p[i];
+        
+        if (c <= 127) {
+            p[i] = toupper(c);
+            i++;
+        } else if (c >= 192 && c <= 223) {
+            if (i + 1 < len) {
+                unsigned char c2 = (unsigned char)p[i+1];
+                if (c == 195 && c2 >= 160 && c2 <= 182) { 
+                    p[i+1] = c2 - 32; 
+                } else if (c == 195 && c2 >= 184 && c2 <= 191) { 
+                    p[i+1] = c2 - 32; 
+                }
+            }
+            i += 2;
+        } else if (c >= 224 && c <= 239) {
+            i += 3; 
+        } else if (c >= 240 && c <= 247) {
+            i += 4;
+        } else {
+            i++;
         }
     }
 }
@@ -388,46 +483,40 @@ void kiln_string_to_unicode_upper(kiln_string_t* string) {
         return;
     }
     
-    // First check if it's a simple ASCII string for fast path
-    bool is_ascii = true;
-    for (uint64_t i = 0; i < string->__length; i++) {
-        if ((unsigned char)string->ptr[i] > 127) {
-            is_ascii = false;
-            break;
-        }
-    }
+    // The leading ASCII run (usually the whole string) goes through the vector kernel
+    uint64_t ascii_len = __kiln_kernels->ascii_prefix(string->ptr, string->__length);
+    __kiln_kernels->to_upper(string->ptr, string->ptr, ascii_len);
     
-    if (is_ascii) {
-        // Fast path for ASCII
-        for (uint64_t i = 0; i < string->__length; i++) {
-            string->ptr[i] = toupper((unsigned char)string->ptr[i]);
-        }
-    } else {
-        // Handle UTF-8 encoding
-        uint64_t i = 0;
-        while (i < string->__length) {
-            unsigned char c = (unsigned char)string->ptr[i];
-            
-            if (c <= 127) {
-                string->ptr[i] = toupper(c);
-                i++;
-            } else if (c >= 192 && c <= 223) {
-                if (i + 1 < string->__length) {
-                    unsigned char c2 = (unsigned char)string->ptr[i+1];
-                    if (c == 195 && c2 >= 160 && c2 <= 182) { 
-                        string->ptr[i+1] = c2 - 32; 
-                    } else if (c == 195 && c2 >= 184 && c2 <= 191) { 
-                        string->ptr[i+1] = c2 - 32; 
-                    }
+    if (ascii_len < string->__length) {
+        __kiln_unicode_upper_tail(string->ptr, ascii_len, string->__length);
+    }
+}
+
+/// @brief Lower cases the UTF-8 text p[start, len) in place (ASCII and the Latin-1 letters)
+void __kiln_unicode_lower_tail(char* p, uint64_t start, uint64_t len) {
+    uint64_t i = start;
+    while (i < len) {
+        unsigned char c = (unsigned char)p[i];
+        
+        if (c <= 127) {
+            p[i] = tolower(c);
+            i++;
+        } else if (c >= 192 && c <= 223) {
+            if (i + 1 < len) {
+                unsigned char c2 = (unsigned char)p[i+1];
+                if (c == 195 && c2 >= 128 && c2 <= 150) { 
+                    p[i+1] = c2 + 32; 
+                } else if (c == 195 && c2 >= 152 && c2 <= 159) {
+                    p[i+1] = c2 + 32;
                 }
-                i += 2;
-            } else if (c >= 224 && c <= 239) {
-                i += 3; 
-            } else if (c >= 240 && c <= 247) {
-                i += 4;
-            } else {
-                i++;
             }
+            i += 2; 
+        } else if (c >= 224 && c <= 239) {
+            i += 3;
+        } else if (c >= 240 && c <= 247) {
+            i += 4;
+        } else {
+            i++;
         }
     }
 }
@@ -439,57 +528,19 @@ void kiln_string_to_unicode_lower(kiln_string_t* string) {
         return;
     }
     
-    // First check if it's a simple ASCII string for fast path
-    bool is_ascii = true;
-    for (uint64_t i = 0; i < string->__length; i++) {
-        if ((unsigned char)string->ptr[i] > 127) {
-            is_ascii = false;
-            break;
-        }
-    }
+    // The leading ASCII run (usually the whole string) goes through the vector kernel
+    uint64_t ascii_len = __kiln_kernels->ascii_prefix(string->ptr, string->__length);
+    __kiln_kernels->to_lower(string->ptr, string->ptr, ascii_len);
     
-    if (is_ascii) {
-        // Fast path for ASCII
-        for (uint64_t i = 0; i < string->__length; i++) {
-            string->ptr[i] = tolower((unsigned char)string->ptr[i]);
-        }
-    } else {
-        // Handle UTF-8 encoding
-        uint64_t i = 0;
-        while (i < string->__length) {
-            unsigned char c = (unsigned char)string->ptr[i];
-            
-            if (c <= 127) {
-                string->ptr[i] = tolower(c);
-                i++;
-            } else if (c >= 192 && c <= 223) {
-                if (i + 1 < string->__length) {
-                    unsigned char c2 = (unsigned char)string->ptr[i+1];
-                    if (c == 195 && c2 >= 128 && c2 <= 150) { 
-                        string->ptr[i+1] = c2 + 32; 
-                    } else if (c == 195 && c2 >= 152 && c2 <= 159) {
-                        string->ptr[i+1] = c2 + 32;
-                    }
-                }
-                i += 2; 
-            } else if (c >= 224 && c <= 239) {
-                i += 3;
-            } else if (c >= 240 && c <= 247) {
-                i += 4;
-            } else {
-                i++;
-            }
-        }
+    if (ascii_len < string->__length) {
+        __kiln_unicode_lower_tail(string->ptr, ascii_len, string->__length);
     }
 }
 
 /// @brief Removes whitespace from the beginning and end of a kiln_string_t in place
 /// @param string The kiln_string_t to trim
 void kiln_string_trim_inplace(kiln_string_t* string) {
-    uint64_t start = 0;
-    while (start < string->__length && isspace((unsigned char)string->ptr[start])) {
-        start++;
-    }
+    uint64_t start = __kiln_kernels->space_prefix(string->ptr, string->__length);
     
     if (start == string->__length) {
         string->ptr[0] = '\0';
@@ -497,15 +548,11 @@ void kiln_string_trim_inplace(kiln_string_t* string) {
         return;
     }
     
-    uint64_t end = string->__length - 1;
-    while (end > start && isspace((unsigned char)string->ptr[end])) {
-        end--;
-    }
-    
-    uint64_t new_length = end - start + 1;
+    uint64_t new_length = string->__length - start - __kiln_kernels->space_suffix(string->ptr + start, string->__length - start);
     
     if (start > 0) {
         memmove(string->ptr, string->ptr + start, new_length);
+        KILN_STATS_MOVE(new_length);
     }
     
     string->ptr[new_length] = '\0';
@@ -522,10 +569,7 @@ kstring_ref_t kstring_ref_trim(kstring_ref_t string) {
         return result;
     }
     
-    uint64_t start = 0;
-    while (start < string.__length && isspace((unsigned char)string.ptr[start])) {
-        start++;
-    }
+    uint64_t start = __kiln_kernels->space_prefix(string.ptr, string.__length);
     
     if (start == string.__length) {
         result.ptr = string.ptr + string.__length;
@@ -533,13 +577,8 @@ kstring_ref_t kstring_ref_trim(kstring_ref_t string) {
         return result;
     }
     
-    uint64_t end = string.__length - 1;
-    while (end > start && isspace((unsigned char)string.ptr[end])) {
-        end--;
-    }
-    
     result.ptr = string.ptr + start;
-    result.__length = end - start + 1;
+    result.__length = string.__length - start - __kiln_kernels->space_suffix(result.ptr, string.__length - start);
     
     return result;
 }
@@ -558,53 +597,68 @@ kstring_ref_t kiln_string_trim(const kiln_string_t* string) {
 /// @param old_s
 /// @param new_s
 void kiln_string_replace(kiln_string_t* string, const char* old_s, const char* new_s) {
-	const size_t old_len = strlen(old_s);
-	if (old_len == 0) {
+	kiln_string_replace_ref(string, kstring_ref_from_cstr((char*)old_s), kstring_ref_from_cstr((char*)new_s));
+}
+
+/// @brief Replaces all non-overlapping instances of old_s (left to right) with new_s
+/// @param string The kiln_string_t to edit
+/// @param old_s The text to replace, nothing happens if it is empty
+/// @param new_s The replacement
+void kiln_string_replace_ref(kiln_string_t* string, kstring_ref_t old_s, kstring_ref_t new_s) {
+	const size_t old_len = old_s.__length;
+	if (old_len == 0 || old_len > string->__length) {
 		return;
 	}
 	
-	const size_t new_len = strlen(new_s);
+	const size_t new_len = new_s.__length;
 	
 	size_t count = 0;
-	const char* pos = string->ptr;
-	while ((pos = strstr(pos, old_s)) != NULL) {
+	uint64_t pos = 0;
+	int64_t found;
+	while (pos + old_len <= string->__length &&
+	       (found = __kiln_kernels->find(string->ptr + pos, string->__length - pos, old_s.ptr, old_len)) >= 0) {
 		count++;
-		pos += old_len;
+		pos += (uint64_t)found + old_len;
 	}
 	
 	if (count == 0) {
 		return;
 	}
 	
-	const size_t new_total_len = string->__length + count * (new_len - old_len);
+	const size_t new_total_len = string->__length - count * old_len + count * new_len;
 	
 	size_t new_capacity = new_total_len + 1;
-	if (new_capacity < string->__capacity) {
-		new_capacity = string->__capacity;
+	if (new_capacity < __kiln_string_capacity(string)) {
+		new_capacity = __kiln_string_capacity(string);
 	}
 	
 	char* new_buffer = (char*)malloc(new_capacity);
 	if (!new_buffer) {
 		return;
 	}
+	KILN_STATS_ALLOC(new_capacity);
+	KILN_STATS_SLACK(new_capacity - (new_total_len + 1));
+	KILN_STATS_COPY(new_total_len);
 	
-	char* src = string->ptr;
+	// Runs between matches are copied with memcpy
 	char* dst = new_buffer;
-	const char* end = string->ptr + string->__length;
-	
-	while (src < end) {
-		if (src + old_len <= end && strncmp(src, old_s, old_len) == 0) {
-			memcpy(dst, new_s, new_len);
-			dst += new_len;
-			src += old_len;
-		} else {
-			*dst++ = *src++;
+	pos = 0;
+	for (size_t i = 0; i < count; i++) {
+		found = __kiln_kernels->find(string->ptr + pos, string->__length - pos, old_s.ptr, old_len);
+		memcpy(dst, string->ptr + pos, (size_t)found);
+		dst += found;
+		if (new_len > 0) {
+			memcpy(dst, new_s.ptr, new_len);
 		}
+		dst += new_len;
+		pos += (uint64_t)found + old_len;
 	}
+	memcpy(dst, string->ptr + pos, string->__length - pos);
+	dst += string->__length - pos;
 	
 	*dst = '\0';
 	
-	free(string->ptr);
+	kiln_string_free(string);
 	string->ptr = new_buffer;
 	string->__length = new_total_len;
 	string->__capacity = new_capacity;
@@ -616,20 +670,22 @@ void kiln_string_replace(kiln_string_t* string, const char* old_s, const char* n
 /// @param target The substring to find
 /// @return Returns `-1` if target is not in `string`
 int64_t kstring_ref_find(kstring_ref_t string, const char* target) {
-    uint64_t target_len = strlen(target);
-    if (target_len == 0) {
+    return kstring_ref_find_ref(string, kstring_ref_from_cstr((char*)target));
+}
+
+/// @brief Returns the index of the first character of the first occurance of `target`. 
+/// @param string The kstring_ref_t to search in
+/// @param target The substring to find
+/// @return Returns `-1` if target is not in `string`, 0 if target is empty
+int64_t kstring_ref_find_ref(kstring_ref_t string, kstring_ref_t target) {
+    if (target.__length == 0) {
         return 0;
     }
-    if (target_len > string.__length) {
+    if (target.__length > string.__length) {
         return -1;
     }
 
-    char* found = strstr(string.ptr, target);
-    if (found == NULL) {
-        return -1;
-    }
-    
-    return (int64_t)(found - string.ptr);
+    return __kiln_kernels->find(string.ptr, string.__length, target.ptr, target.__length);
 }
 
 /// @brief Finds the last occurrence of a target string within a StringRef
@@ -637,22 +693,22 @@ int64_t kstring_ref_find(kstring_ref_t string, const char* target) {
 /// @param target The string to search for
 /// @return The position of the last occurrence, or -1 if not found
 int64_t kstring_ref_rfind(kstring_ref_t string, const char* target) {
-    size_t target_len = strlen(target);
+    return kstring_ref_rfind_ref(string, kstring_ref_from_cstr((char*)target));
+}
+
+/// @brief Finds the last occurrence of a target string within a StringRef
+/// @param string The kstring_ref_t to search in
+/// @param target The string to search for
+/// @return The position of the last occurrence, or -1 if not found (or target is empty)
+int64_t kstring_ref_rfind_ref(kstring_ref_t string, kstring_ref_t target) {
+    size_t target_len = target.__length;
     
     if (target_len == 0 || target_len > string.__length) {
         return -1;
     }
     
     for (int64_t i = string.__length - target_len; i >= 0; i--) {
-        bool match = true;
-        
-        for (size_t j = 0; j < target_len; j++) {
-            if (string.ptr[i + j] != target[j]) {
-                match = false;
-                break;
-            }
-        }        
-        if (match) {
+        if (string.ptr[i] == target.ptr[0] && memcmp(string.ptr + i, target.ptr, target_len) == 0) {
             return i;
         }
     }
@@ -660,31 +716,22 @@ int64_t kstring_ref_rfind(kstring_ref_t string, const char* target) {
     return -1;
 }
 
-/// @brief Returns the index of the first character of the first occurance of `target` in a KilnString. 
-/// @param string The kiln_string_t to search in
-/// @param target The substring to find
-/// @return Returns `-1` if target is not in `string`
-inline int64_t kiln_string_find(const kiln_string_t* string, const char* target) {
-    kstring_ref_t ref = {string->ptr, string->__length};
-    return kstring_ref_find(ref, target);
-}
 
-/// @brief Returns the index of the first character of the last occurance of `target` in a KilnString. 
-/// @param string The kiln_string_t to search in
-/// @param target The substring to find
-/// @return Returns `-1` if target is not in `string`
-inline int64_t kiln_string_rfind(const kiln_string_t* string, const char* target) {
-    kstring_ref_t ref = {string->ptr, string->__length};
-    return kstring_ref_rfind(ref, target);
+/// @brief Partitions a kstring_ref_t into two parts based on the first occurrence of a delimiter
+/// @param string The kstring_ref_t to be partitioned
+/// @param delimiter The delimiter string to search for
+/// @param output_buffer Array of 2 kstring_ref_t's to store the results - first part before delimiter, second part after delimiter
+void kstring_ref_partition(kstring_ref_t string, const char* delimiter, kstring_ref_t output_buffer[2]) {
+    kstring_ref_partition_ref(string, kstring_ref_from_cstr((char*)delimiter), output_buffer);
 }
 
 /// @brief Partitions a kstring_ref_t into two parts based on the first occurrence of a delimiter
 /// @param string The kstring_ref_t to be partitioned
 /// @param delimiter The delimiter string to search for
 /// @param output_buffer Array of 2 kstring_ref_t's to store the results - first part before delimiter, second part after delimiter
-void kstring_ref_partition(kstring_ref_t string, const char* delimiter, kstring_ref_t output_buffer[2]) {
+void kstring_ref_partition_ref(kstring_ref_t string, kstring_ref_t delimiter, kstring_ref_t output_buffer[2]) {
     // Find the first occurrence of the delimiter
-    int64_t delimiter_pos = kstring_ref_find(string, delimiter);
+    int64_t delimiter_pos = kstring_ref_find_ref(string, delimiter);
     
     if (delimiter_pos == -1) {
         // Delimiter not found, first part is the entire string, second part is empty
@@ -699,7 +746,7 @@ void kstring_ref_partition(kstring_ref_t string, const char* delimiter, kstring_
         };
         
         // Second part: after delimiter to end
-        size_t delimiter_len = strlen(delimiter);
+        size_t delimiter_len = delimiter.__length;
         output_buffer[1] = (kstring_ref_t){
             .ptr = string.ptr + delimiter_pos + delimiter_len,
             .__length = string.__length - delimiter_pos - delimiter_len
@@ -712,8 +759,16 @@ void kstring_ref_partition(kstring_ref_t string, const char* delimiter, kstring_
 /// @param delimiter The delimiter string to search for from the end
 /// @param output_buffer Array of 2 kstring_ref_t's to store the results - first part before last delimiter, second part after last delimiter
 void kstring_ref_rpartition(kstring_ref_t string, const char* delimiter, kstring_ref_t output_buffer[2]) {
+    kstring_ref_rpartition_ref(string, kstring_ref_from_cstr((char*)delimiter), output_buffer);
+}
+
+/// @brief Partitions a kstring_ref_t into two parts based on the last occurrence of a delimiter
+/// @param string The kstring_ref_t to be partitioned
+/// @param delimiter The delimiter string to search for from the end
+/// @param output_buffer Array of 2 kstring_ref_t's to store the results - first part before last delimiter, second part after last delimiter
+void kstring_ref_rpartition_ref(kstring_ref_t string, kstring_ref_t delimiter, kstring_ref_t output_buffer[2]) {
     // Find the last occurrence of the delimiter
-    int64_t delimiter_pos = kstring_ref_rfind(string, delimiter);
+    int64_t delimiter_pos = kstring_ref_rfind_ref(string, delimiter);
     
     if (delimiter_pos == -1) {
         // Delimiter not found, first part is the entire string, second part is empty
@@ -728,7 +783,7 @@ void kstring_ref_rpartition(kstring_ref_t string, const char* delimiter, kstring
         };
         
         // Second part: after last delimiter to end
-        size_t delimiter_len = strlen(delimiter);
+        size_t delimiter_len = delimiter.__length;
         output_buffer[1] = (kstring_ref_t){
             .ptr = string.ptr + delimiter_pos + delimiter_len,
             .__length = string.__length - delimiter_pos - delimiter_len
@@ -736,20 +791,122 @@ void kstring_ref_rpartition(kstring_ref_t string, const char* delimiter, kstring
     }
 }
 
-/// @brief Partitions a kiln_string_t into two parts based on the first occurrence of a delimiter
-/// @param string The kstring_ref_t to be partitioned
-/// @param delimiter The delimiter string to search for
-/// @param output_buffer Array of 2 kstring_ref_t's to store the results - first part before delimiter, second part after delimiter
-inline void kiln_string_partition(const kiln_string_t* string, const char* delimiter, kstring_ref_t output_buffer[2]) {
-    kstring_ref_t ref = {string->ptr, string->__length};
-    kstring_ref_partition(ref, delimiter, output_buffer);
+/// @brief Creates an iterator over the pieces of `string` between occurrences of `sep`.
+/// Like Python's str.split(sep): n separators give n + 1 pieces, including empty ones
+/// @param string The kstring_ref_t to split, it must outlive the iterator
+/// @param sep The separator. If it is empty the whole string comes back as a single piece
+/// @return The iterator, see `kstring_split_iter_next`
+kstring_split_iter_t kstring_ref_split(kstring_ref_t string, kstring_ref_t sep) {
+    return (kstring_split_iter_t) {
+        .__rest = string,
+        .__sep = sep,
+        .__done = false,
+    };
 }
 
-/// @brief Partitions a kiln_string_t into two parts based on the last occurrence of a delimiter
-/// @param string The kstring_ref_t to be partitioned
-/// @param delimiter The delimiter string to search for from the end
-/// @param output_buffer Array of 2 kstring_ref_t's to store the results - first part before last delimiter, second part after last delimiter
-inline void kiln_string_rpartition(const kiln_string_t* string, const char* delimiter, kstring_ref_t output_buffer[2]) {
-    kstring_ref_t ref = {string->ptr, string->__length};
-    kstring_ref_rpartition(ref, delimiter, output_buffer);
-}
\ No newline at end of file
+/// @brief Returns the next piece of a split
+/// @param iter 
+/// @param out Set to the piece, a span into the string being split
+/// @return false once every piece has been returned
+bool kstring_split_iter_next(kstring_split_iter_t* iter, kstring_ref_t* out) {
+    if (iter->__done) {
+        return false;
+    }
+
+    kstring_ref_t rest = iter->__rest;
+    int64_t pos = iter->__sep.__length > 0 && iter->__sep.__length <= rest.__length
+        ? __kiln_kernels->find(rest.ptr, rest.__length, iter->__sep.ptr, iter->__sep.__length)
+        : -1;
+
+    if (pos == -1) {
+        *out = rest;
+        iter->__done = true;
+        return true;
+    }
+
+    *out = (kstring_ref_t){ .ptr = rest.ptr, .__length = (uint64_t)pos };
+    uint64_t skip = (uint64_t)pos + iter->__sep.__length;
+    iter->__rest = (kstring_ref_t){ .ptr = rest.ptr + skip, .__length = rest.__length - skip };
+    return true;
+}
+
+
+/// @brief Checks if every byte of the string is below 0x80
+/// @param string The kstring_ref_t to check
+/// @return true if the string is pure ASCII (also true for an empty string)
+bool kstring_ref_is_ascii(kstring_ref_t string) {
+    return __kiln_kernels->ascii_prefix(string.ptr, string.__length) == string.__length;
+}
+
+/// @brief Checks if the string is well formed UTF-8 (no overlongs, surrogates or code points above U+10FFFF)
+/// @param string The kstring_ref_t to check
+/// @return true if the string is valid UTF-8
+bool kstring_ref_is_valid_utf8(kstring_ref_t string) {
+    const unsigned char* p = (const unsigned char*)string.ptr;
+    uint64_t len = string.__length;
+    uint64_t i = 0;
+
+    while (i < len) {
+        // Skip ASCII runs with the vector kernel
+        i += __kiln_kernels->ascii_prefix((const char*)p + i, len - i);
+        if (i == len) {
+            break;
+        }
+
+        unsigned char c = p[i];
+        uint64_t n;
+        unsigned char lo = 0x80, hi = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF) {
+            n = 1;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            n = 2;
+            if (c == 0xE0) lo = 0xA0;
+            if (c == 0xED) hi = 0x9F;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            n = 3;
+            if (c == 0xF0) lo = 0x90;
+            if (c == 0xF4) hi = 0x8F;
+        } else {
+            return false;
+        }
+
+        if (len - i <= n) {
+            return false;
+        }
+        if (p[i + 1] < lo || p[i + 1] > hi) {
+            return false;
+        }
+        for (uint64_t j = 2; j <= n; j++) {
+            if ((p[i + j] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += n + 1;
+    }
+
+    return true;
+}
+
+/// @brief Hashes the bytes of a kstring_ref_t with a seed. The result is the same on every CPU
+/// and every dispatch tier, so it can be stored or sent between machines.
+/// @param string The kstring_ref_t to hash
+/// @param seed Any 64 bit value. The seed is mixed in nonlinearly, so inputs that collide under one seed
+/// are not more likely than any other pair to collide under another
+/// @return A 64 bit hash
+uint64_t kstring_ref_hash_seeded(kstring_ref_t string, uint64_t seed) {
+    return __kiln_kernels->hash(string.ptr, string.__length, seed);
+}
+
+/// @brief Hashes the bytes of a kstring_ref_t (seed 0)
+/// @param string The kstring_ref_t to hash
+/// @return A 64 bit hash
+uint64_t kstring_ref_hash(kstring_ref_t string) {
+    return __kiln_kernels->hash(string.ptr, string.__length, 0);
+}
+
+/// @brief Hashes the contents of a kiln_string_t, same result as `kstring_ref_hash` on the same bytes
+/// @param string The kiln_string_t to hash
+/// @return A 64 bit hash
+uint64_t kiln_string_hash(const kiln_string_t* string) {
+    return __kiln_kernels->hash(string->ptr, string->__length, 0);
+}
@@ -0,0 +1,109 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+/// @brief Appends the padded base64 encoding (standard alphabet) of `ref` to `string`.
+/// The output size is known up front, so the string grows at most once and the kernel writes straight into it
+/// @param string The kiln_string_t to append to
+/// @param ref The raw bytes
+void kiln_string_push_base64(kiln_string_t* string, kstring_ref_t ref) {
+    uint64_t out_len = (ref.__length + 2) / 3 * 4;
+    if (!__kiln_string_grow(string, string->__length + out_len + 1)) {
+        return;
+    }
+    __kiln_kernels->base64_encode(ref.ptr, ref.__length, string->ptr + string->__length);
+    string->__length += out_len;
+    string->ptr[string->__length] = '\0';
+}
+
+/// @brief Appends the lowercase hex encoding of `ref` to `string`, two digits per byte.
+/// The string grows at most once and the kernel writes straight into it
+/// @param string The kiln_string_t to append to
+/// @param ref The raw bytes
+void kiln_string_push_hex(kiln_string_t* string, kstring_ref_t ref) {
+    uint64_t out_len = ref.__length * 2;
+    if (!__kiln_string_grow(string, string->__length + out_len + 1)) {
+        return;
+    }
+    __kiln_kernels->hex_encode(ref.ptr, ref.__length, string->ptr + string->__length);
+    string->__length += out_len;
+    string->ptr[string->__length] = '\0';
+}
+
+/// @brief Appends the bytes encoded by the base64 text `ref` to `string`.
+/// Padding is optional, but if present it must make the length a multiple of 4. Whitespace is not skipped
+/// @param string The kiln_string_t to append to
+/// @param ref The base64 text (standard alphabet)
+/// @return false if `ref` is not valid base64, `string` is left unchanged in that case
+bool kstring_ref_base64_decode_into(kiln_string_t* string, kstring_ref_t ref) {
+    const unsigned char* p = (const unsigned char*)ref.ptr;
+    uint64_t len = ref.__length;
+    if (len % 4 == 0 && len > 0 && p[len - 1] == '=') {
+        len -= (p[len - 2] == '=') ? 2 : 1;
+    }
+    if (len % 4 == 1) {
+        return false;
+    }
+
+    uint64_t out_len = len / 4 * 3 + (len % 4 == 0 ? 0 : len % 4 - 1);
+    if (!__kiln_string_grow(string, string->__length + out_len + 1)) {
+        return false;
+    }
+    char* out = string->ptr + string->__length;
+
+    uint64_t full = len / 4 * 4;
+    if (!__kiln_kernels->base64_decode(ref.ptr, full, out)) {
+        goto invalid;
+    }
+
+    if (full < len) {
+        // The last 2 or 3 characters are decoded as a quad padded with 'A' (zero)
+        char quad[4] = { 'A', 'A', 'A', 'A' };
+        unsigned char bytes[3];
+        memcpy(quad, ref.ptr + full, len - full);
+        if (!__kiln_base64_decode_scalar(quad, 4, (char*)bytes)) {
+            goto invalid;
+        }
+        // The unused low bits of the last character must be zero (canonical encoding)
+        if (bytes[2] != 0 || (len - full == 2 && bytes[1] != 0)) {
+            goto invalid;
+        }
+        memcpy(out + full / 4 * 3, bytes, len - full - 1);
+    }
+
+    string->__length += out_len;
+    string->ptr[string->__length] = '\0';
+    return true;
+
+invalid:
+    string->ptr[string->__length] = '\0';
+    return false;
+}
+
+/// @brief Appends the bytes encoded by the hex text `ref` to `string`. Upper and lowercase digits are accepted
+/// @param string The kiln_string_t to append to
+/// @param ref The hex text, two digits per byte
+/// @return false if `ref` has an odd length or a non hex character, `string` is left unchanged in that case
+bool kstring_ref_hex_decode_into(kiln_string_t* string, kstring_ref_t ref) {
+    if (ref.__length % 2 != 0) {
+        return false;
+    }
+    uint64_t out_len = ref.__length / 2;
+    if (!__kiln_string_grow(string, string->__length + out_len + 1)) {
+        return false;
+    }
+
+    if (!__kiln_kernels->hex_decode(ref.ptr, out_len, string->ptr + string->__length)) {
+        string->ptr[string->__length] = '\0';
+        return false;
+    }
+
+    string->__length += out_len;
+    string->ptr[string->__length] = '\0';
+    return true;
+}
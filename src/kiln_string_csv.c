@@ -0,0 +1,162 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// The reader classifies the input 64 bytes at a time into a bitmask of quotes
+// and a bitmask of separators (the delimiter and '\n'). A prefix XOR of the
+// quote mask gives, for every byte, whether it is inside a quoted field, so
+// separators inside quotes drop out with one AND and fields are then read off
+// the remaining bits with ctz. Doubled quotes ("") toggle twice and need no
+// special handling. Field contents are never copied or unescaped unless asked.
+
+/// @brief Bit i of the result is the XOR of bits 0..i of x
+static inline uint64_t prefix_xor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/// @brief Loads and classifies the block at `__next_block`, leaving its unquoted separators in `__sep_bits`
+static void csv_load_block(kiln_csv_reader_t* reader) {
+    const char* base = reader->__input.ptr + reader->__next_block;
+    uint64_t remaining = reader->__input.__length - reader->__next_block;
+
+    // The last partial block is padded with zeros. A zero is a separator when the delimiter is '\0',
+    // so the bits past the end of the input are cleared before they are used
+    char padded[64];
+    uint64_t live = ~0ull;
+    if (remaining < 64) {
+        memset(padded, 0, sizeof(padded));
+        memcpy(padded, base, remaining);
+        base = padded;
+        live = (1ull << remaining) - 1;
+    }
+
+    uint64_t seps;
+    uint64_t quotes = __kiln_kernels->csv_masks(base, reader->__delimiter, &seps) & live;
+    seps &= live;
+    uint64_t in_quotes = prefix_xor(quotes) ^ reader->__quote_carry;
+    reader->__quote_carry = (uint64_t)((int64_t)in_quotes >> 63);
+    reader->__sep_bits = seps & ~in_quotes;
+    reader->__block_base = reader->__next_block;
+    reader->__next_block += 64;
+}
+
+/// @brief Fills `field` for the bytes [start, end)
+static void csv_make_field(const kiln_csv_reader_t* reader, uint64_t start, uint64_t end, bool end_of_record, kiln_csv_field_t* field) {
+    const char* p = reader->__input.ptr;
+
+    // CRLF line endings
+    if (end_of_record && end > start && p[end - 1] == '\r') {
+        end--;
+    }
+
+    field->end_of_record = end_of_record;
+    field->quoted = end > start && p[start] == '"';
+    field->needs_unescape = false;
+
+    if (field->quoted) {
+        start++;
+        if (end > start && p[end - 1] == '"') {
+            end--;
+        }
+        field->needs_unescape = memchr(p + start, '"', end - start) != NULL;
+    }
+
+    field->value = (kstring_ref_t){ .ptr = reader->__input.ptr + start, .__length = end - start };
+}
+
+/// @brief Creates a reader over CSV (or TSV, with '\t') data. The input is only read, never copied,
+/// so it must outlive the reader and the fields it returns
+/// @param input The whole document, e.g. a buffer or an mmap'd file
+/// @param delimiter The field separator, usually ',' or '\t'
+/// @return The reader
+kiln_csv_reader_t kiln_csv_reader_new(kstring_ref_t input, char delimiter) {
+    return (kiln_csv_reader_t) {
+        .__input = input,
+        .__field_start = 0,
+        .__block_base = 0,
+        .__next_block = 0,
+        .__sep_bits = 0,
+        .__quote_carry = 0,
+        .__delimiter = delimiter,
+        .__last_was_newline = true,
+        .__done = input.__length == 0,
+    };
+}
+
+/// @brief Reads the next field. Both "\n" and "\r\n" end a record
+/// @param reader 
+/// @param field Set to the field, see `kiln_csv_field_t`
+/// @return false once the input is exhausted
+bool kiln_csv_reader_next(kiln_csv_reader_t* reader, kiln_csv_field_t* field) {
+    if (reader->__done) {
+        return false;
+    }
+
+    while (reader->__sep_bits == 0) {
+        if (reader->__next_block >= reader->__input.__length) {
+            // A trailing field without a separator after it. An input that ends with
+            // '\n' has no empty record after it, one that ends with the delimiter has an empty last field
+            reader->__done = true;
+            uint64_t len = reader->__input.__length;
+            if (reader->__field_start == len && reader->__last_was_newline) {
+                return false;
+            }
+            csv_make_field(reader, reader->__field_start, len, true, field);
+            return true;
+        }
+        csv_load_block(reader);
+    }
+
+    uint64_t end = reader->__block_base + (uint64_t)__builtin_ctzll(reader->__sep_bits);
+    reader->__sep_bits &= reader->__sep_bits - 1;
+
+    bool newline = reader->__input.ptr[end] == '\n';
+    csv_make_field(reader, reader->__field_start, end, newline, field);
+    reader->__field_start = end + 1;
+    reader->__last_was_newline = newline;
+    return true;
+}
+
+/// @brief Appends the value of a field to `string`, turning doubled quotes ("") back into single ones
+/// @param string The kiln_string_t to append to
+/// @param field A field returned by `kiln_csv_reader_next`
+void kiln_csv_field_unescape_into(kiln_string_t* string, kiln_csv_field_t field) {
+    if (!field.needs_unescape) {
+        kiln_string_push_kstring_ref(string, field.value);
+        return;
+    }
+
+    if (!__kiln_string_grow(string, string->__length + field.value.__length + 1)) {
+        return;
+    }
+
+    const char* p = field.value.ptr;
+    const char* end = p + field.value.__length;
+    char* out = string->ptr + string->__length;
+    while (p < end) {
+        const char* quote = memchr(p, '"', (size_t)(end - p));
+        size_t run = quote == NULL ? (size_t)(end - p) : (size_t)(quote - p) + 1;
+        memcpy(out, p, run);
+        KILN_STATS_COPY(run);
+        out += run;
+        p += run;
+        // Skip the second quote of a pair
+        if (quote != NULL && p < end && *p == '"') {
+            p++;
+        }
+    }
+
+    string->__length = (uint64_t)(out - string->ptr);
+    string->ptr[string->__length] = '\0';
+}
@@ -0,0 +1,113 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// Picks the kernel table once at load time. Until the constructor has run
+// (e.g. calls from other constructors) the scalar kernels are used.
+
+const __kiln_kernels_t* __kiln_kernels = &__kiln_kernels_scalar;
+
+static kiln_string_isa_t active_isa = KILN_STRING_ISA_SCALAR;
+static uint32_t cpu_features = 0;
+
+static const __kiln_kernels_t* kernels_for_isa(kiln_string_isa_t isa) {
+    switch (isa) {
+#ifdef KILN_STRING_HAVE_X86_KERNELS
+        case KILN_STRING_ISA_SSE42: return &__kiln_kernels_sse42;
+        case KILN_STRING_ISA_AVX2: return &__kiln_kernels_avx2;
+        case KILN_STRING_ISA_AVX512: return &__kiln_kernels_avx512;
+#endif
+        default: return &__kiln_kernels_scalar;
+    }
+}
+
+static uint32_t detect_cpu_features(void) {
+    uint32_t features = 0;
+#ifdef KILN_STRING_HAVE_X86_KERNELS
+    // libgcc also checks XGETBV, so AVX/AVX-512 are only reported when the OS saves the registers
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) features |= KILN_CPU_SSE42;
+    if (__builtin_cpu_supports("avx2")) features |= KILN_CPU_AVX2;
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) features |= KILN_CPU_AVX512BW;
+    if (__builtin_cpu_supports("avx512vbmi")) features |= KILN_CPU_AVX512VBMI;
+#endif
+    return features;
+}
+
+__attribute__((constructor))
+static void kiln_string_dispatch_init(void) {
+    cpu_features = detect_cpu_features();
+    kiln_string_isa_t isa = kiln_string_best_isa();
+
+    // KILN_STRING_ISA=scalar|sse4.2|avx2|avx512 forces a lower tier, mostly for benchmarking.
+    // Asking for a tier the CPU lacks keeps the best supported one.
+    const char* forced = getenv("KILN_STRING_ISA");
+    if (forced != NULL) {
+        for (int i = KILN_STRING_ISA_SCALAR; i <= KILN_STRING_ISA_AVX512; i++) {
+            if (strcmp(forced, kiln_string_isa_name((kiln_string_isa_t)i)) == 0 && i <= (int)isa) {
+                isa = (kiln_string_isa_t)i;
+                break;
+            }
+        }
+    }
+
+    kiln_string_set_isa(isa);
+}
+
+/// @brief Returns the string-relevant instruction set extensions of the running CPU
+/// @return A bitmask of `KILN_CPU_*` flags
+uint32_t kiln_string_cpu_features(void) {
+    return cpu_features;
+}
+
+/// @brief Returns the highest kernel tier the running CPU supports
+/// @return The best kiln_string_isa_t
+kiln_string_isa_t kiln_string_best_isa(void) {
+    if ((cpu_features & KILN_CPU_AVX512BW) && (cpu_features & KILN_CPU_AVX2)) {
+        return KILN_STRING_ISA_AVX512;
+    }
+    if (cpu_features & KILN_CPU_AVX2) {
+        return KILN_STRING_ISA_AVX2;
+    }
+    if (cpu_features & KILN_CPU_SSE42) {
+        return KILN_STRING_ISA_SSE42;
+    }
+    return KILN_STRING_ISA_SCALAR;
+}
+
+/// @brief Returns the kernel tier currently in use
+/// @return The active kiln_string_isa_t
+kiln_string_isa_t kiln_string_get_isa(void) {
+    return active_isa;
+}
+
+/// @brief Switches every dispatched kernel to the given tier. Not thread safe, call it before
+/// other threads use the library.
+/// @param isa The tier to use
+/// @return false (and nothing changes) if the CPU does not support `isa`
+bool kiln_string_set_isa(kiln_string_isa_t isa) {
+    if (isa < KILN_STRING_ISA_SCALAR || isa > kiln_string_best_isa()) {
+        return false;
+    }
+    active_isa = isa;
+    __kiln_kernels = kernels_for_isa(isa);
+    return true;
+}
+
+/// @brief Returns the name of a tier, as accepted by the KILN_STRING_ISA environment variable
+/// @param isa The tier
+/// @return A static string, "unknown" for values outside the enum
+const char* kiln_string_isa_name(kiln_string_isa_t isa) {
+    switch (isa) {
+        case KILN_STRING_ISA_SCALAR: return "scalar";
+        case KILN_STRING_ISA_SSE42: return "sse4.2";
+        case KILN_STRING_ISA_AVX2: return "avx2";
+        case KILN_STRING_ISA_AVX512: return "avx512";
+    }
+    return "unknown";
+}
@@ -0,0 +1,169 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+static const char upper_hex_digits[] = "0123456789ABCDEF";
+
+// Every byte except the RFC 3986 unreserved characters (A-Z a-z 0-9 - . _ ~)
+static __kiln_byte_set_t url_unsafe;
+// & < > " '
+static __kiln_byte_set_t html_special;
+static pthread_once_t sets_once = PTHREAD_ONCE_INIT;
+
+static void sets_init(void) {
+    for (int c = 0; c < 256; c++) {
+        bool unreserved = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+                          c == '-' || c == '.' || c == '_' || c == '~';
+        if (!unreserved) {
+            __kiln_byte_set_add(&url_unsafe, (unsigned char)c);
+        }
+    }
+    const char* special = "&<>\"'";
+    for (const char* p = special; *p; p++) {
+        __kiln_byte_set_add(&html_special, (unsigned char)*p);
+    }
+}
+
+static const char* html_entity(unsigned char c) {
+    switch (c) {
+        case '&': return "&amp;";
+        case '<': return "&lt;";
+        case '>': return "&gt;";
+        case '"': return "&quot;";
+        default: return "&#39;";
+    }
+}
+
+/// @brief Appends `ref` to `string` percent-encoded: every byte other than A-Z a-z 0-9 - . _ ~ becomes %XX
+/// (uppercase hex, a space is %20). The exact output size is counted first, so the string grows at most once
+/// @param string The kiln_string_t to append to
+/// @param ref The raw bytes
+void kiln_string_push_url_encoded(kiln_string_t* string, kstring_ref_t ref) {
+    pthread_once(&sets_once, sets_init);
+    const char* end = ref.ptr + ref.__length;
+
+    uint64_t escaped = 0;
+    for (const char* p = ref.ptr; p < end; p++) {
+        p += __kiln_kernels->set_prefix(p, (uint64_t)(end - p), &url_unsafe);
+        escaped += p < end;
+    }
+    if (!__kiln_string_grow(string, string->__length + ref.__length + 2 * escaped + 1)) {
+        return;
+    }
+
+    const char* p = ref.ptr;
+    char* out = string->ptr + string->__length;
+    while (p < end) {
+        uint64_t run = __kiln_kernels->set_prefix(p, (uint64_t)(end - p), &url_unsafe);
+        memcpy(out, p, run);
+        KILN_STATS_COPY(run);
+        out += run;
+        p += run;
+        if (p == end) {
+            break;
+        }
+
+        unsigned char c = (unsigned char)*p++;
+        *out++ = '%';
+        *out++ = upper_hex_digits[c >> 4];
+        *out++ = upper_hex_digits[c & 0xf];
+    }
+
+    string->__length = (uint64_t)(out - string->ptr);
+    string->ptr[string->__length] = '\0';
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/// @brief Appends the percent-decoded bytes of `ref` to `string`. Runs without a '%' are copied with memcpy.
+/// '+' is left as is (this is RFC 3986 decoding, not form decoding)
+/// @param string The kiln_string_t to append to
+/// @param ref The encoded text
+/// @return false if a '%' is not followed by two hex digits, `string` is left unchanged in that case
+bool kstring_ref_url_decode_into(kiln_string_t* string, kstring_ref_t ref) {
+    // Decoding never makes the text longer
+    if (!__kiln_string_grow(string, string->__length + ref.__length + 1)) {
+        return false;
+    }
+
+    const char* p = ref.ptr;
+    const char* end = p + ref.__length;
+    char* out = string->ptr + string->__length;
+
+    while (p < end) {
+        const char* percent = memchr(p, '%', (size_t)(end - p));
+        size_t run = percent == NULL ? (size_t)(end - p) : (size_t)(percent - p);
+        memcpy(out, p, run);
+        KILN_STATS_COPY(run);
+        out += run;
+        p += run;
+        if (p == end) {
+            break;
+        }
+
+        int hi = end - p >= 3 ? hex_value(p[1]) : -1;
+        int lo = end - p >= 3 ? hex_value(p[2]) : -1;
+        if (hi < 0 || lo < 0) {
+            string->ptr[string->__length] = '\0';
+            return false;
+        }
+        *out++ = (char)(hi << 4 | lo);
+        p += 3;
+    }
+
+    string->__length = (uint64_t)(out - string->ptr);
+    string->ptr[string->__length] = '\0';
+    return true;
+}
+
+/// @brief Appends `ref` to `string` with & < > " ' replaced by &amp; &lt; &gt; &quot; &#39;, which is safe
+/// for both element content and quoted attribute values. The string grows at most once
+/// @param string The kiln_string_t to append to
+/// @param ref The raw text
+void kiln_string_push_html_escaped(kiln_string_t* string, kstring_ref_t ref) {
+    pthread_once(&sets_once, sets_init);
+    const char* end = ref.ptr + ref.__length;
+
+    uint64_t extra = 0;
+    for (const char* p = ref.ptr; p < end; p++) {
+        p += __kiln_kernels->set_prefix(p, (uint64_t)(end - p), &html_special);
+        if (p < end) {
+            extra += strlen(html_entity((unsigned char)*p)) - 1;
+        }
+    }
+    if (!__kiln_string_grow(string, string->__length + ref.__length + extra + 1)) {
+        return;
+    }
+
+    const char* p = ref.ptr;
+    char* out = string->ptr + string->__length;
+    while (p < end) {
+        uint64_t run = __kiln_kernels->set_prefix(p, (uint64_t)(end - p), &html_special);
+        memcpy(out, p, run);
+        KILN_STATS_COPY(run);
+        out += run;
+        p += run;
+        if (p == end) {
+            break;
+        }
+
+        const char* entity = html_entity((unsigned char)*p++);
+        size_t entity_len = strlen(entity);
+        memcpy(out, entity, entity_len);
+        out += entity_len;
+    }
+
+    string->__length = (uint64_t)(out - string->ptr);
+    string->ptr[string->__length] = '\0';
+}
@@ -0,0 +1,445 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// A compiled glob is the pattern split at its `*`s into segments of fixed
+// length. Every segment is a run of atoms (a literal byte, `?`, or a `[...]`
+// class stored as a 256-bit bitmap). The first segment must match at the start
+// of the input, the last one at the end, and the ones in between are placed
+// greedily at their leftmost match, which is enough for globs since `*`
+// can absorb anything that is skipped. A middle segment made only of literals
+// is searched for with the find kernel. Any other middle segment is scanned with
+// Shift-And: a 256-entry table gives, for every byte, the bitmask of atoms it
+// can stand for, so one shift, OR and AND per input byte tracks every partial
+// match at once. Whenever no partial match is alive, the find kernel skips ahead
+// to the next occurrence of the segment's longest literal run, so patterns like
+// `*.log` or `access-*-2026??.gz` never look at most bytes twice.
+
+// Atoms per Shift-And state word. Longer segments use the first SHIFT_AND_ATOMS
+// as the filter and check the rest at each hit
+#define SHIFT_AND_ATOMS 64
+#define NO_MASK_TABLE UINT32_MAX
+
+// Strings per task when kstring_glob_match_many runs on the thread pool
+#define KSTRING_GLOB_BATCH_CHUNK 4096
+
+enum {
+    GLOB_LITERAL,
+    GLOB_ANY,
+    GLOB_CLASS,
+};
+
+struct __kiln_glob_atom {
+    uint8_t kind;
+    uint8_t byte;
+    uint32_t class_idx;
+};
+
+struct __kiln_glob_segment {
+    uint32_t first_atom;
+    uint32_t n_atoms;
+    // Longest run of literal atoms, relative to first_atom. anchor_len is 0 if there is none
+    uint32_t anchor_offset;
+    uint32_t anchor_len;
+    // Index of the segment's 256-entry Shift-And table in __masks, NO_MASK_TABLE if it has none
+    uint32_t mask_table;
+};
+
+static inline bool class_has(const uint64_t* bitmap, unsigned char c) {
+    return (bitmap[c >> 6] >> (c & 63)) & 1;
+}
+
+static inline void class_add_range(uint64_t* bitmap, unsigned char lo, unsigned char hi) {
+    for (unsigned int c = lo; c <= hi; c++) {
+        bitmap[c >> 6] |= 1ull << (c & 63);
+    }
+}
+
+/// @brief Parses a `[...]` class starting at p[i] == '['
+/// @return The index just past the closing `]`, or 0 if the class is unterminated
+static size_t parse_class(const char* p, size_t len, size_t i, uint64_t bitmap[4]) {
+    size_t j = i + 1;
+    bool negate = false;
+    if (j < len && (p[j] == '!' || p[j] == '^')) {
+        negate = true;
+        j++;
+    }
+
+    memset(bitmap, 0, 4 * sizeof(uint64_t));
+    bool first = true;
+    while (j < len && (p[j] != ']' || first)) {
+        first = false;
+        if (p[j] == '\\' && j + 1 < len) {
+            j++;
+        }
+        unsigned char lo = (unsigned char)p[j];
+        unsigned char hi = lo;
+        if (j + 2 < len && p[j + 1] == '-' && p[j + 2] != ']') {
+            j += 2;
+            if (p[j] == '\\' && j + 1 < len) {
+                j++;
+            }
+            hi = (unsigned char)p[j];
+        }
+        if (lo <= hi) {
+            class_add_range(bitmap, lo, hi);
+        }
+        j++;
+    }
+    if (j >= len) {
+        return 0;
+    }
+
+    if (negate) {
+        for (int w = 0; w < 4; w++) {
+            bitmap[w] = ~bitmap[w];
+        }
+    }
+    return j + 1;
+}
+
+static void close_segment(kstring_glob_t* glob, struct __kiln_glob_segment* seg) {
+    seg->anchor_offset = 0;
+    seg->anchor_len = 0;
+    seg->mask_table = NO_MASK_TABLE;
+
+    uint32_t run_start = 0;
+    for (uint32_t k = 0; k <= seg->n_atoms; k++) {
+        if (k < seg->n_atoms && glob->__atoms[seg->first_atom + k].kind == GLOB_LITERAL) {
+            continue;
+        }
+        if (k - run_start > seg->anchor_len) {
+            seg->anchor_offset = run_start;
+            seg->anchor_len = k - run_start;
+        }
+        run_start = k + 1;
+    }
+}
+
+/// @brief Checks if the atom accepts byte `c`
+static inline bool atom_matches(const kstring_glob_t* glob, const struct __kiln_glob_atom* atom, unsigned char c) {
+    switch (atom->kind) {
+        case GLOB_LITERAL:
+            return c == atom->byte;
+        case GLOB_CLASS:
+            return class_has(glob->__classes + 4 * atom->class_idx, c);
+        default:
+            return true;
+    }
+}
+
+/// @brief Builds the Shift-And tables of the middle segments that are not plain literals
+/// (the first and last segments are only ever checked at one position)
+/// @return false on allocation failure
+static bool build_mask_tables(kstring_glob_t* glob) {
+    uint32_t n_tables = 0;
+    for (size_t k = 1; k + 1 < glob->__n_segments; k++) {
+        struct __kiln_glob_segment* seg = &glob->__segments[k];
+        if (seg->anchor_len < seg->n_atoms) {
+            seg->mask_table = n_tables++;
+        }
+    }
+    if (n_tables == 0) {
+        return true;
+    }
+
+    glob->__masks = calloc((size_t)n_tables * 256, sizeof(uint64_t));
+    if (glob->__masks == NULL) {
+        return false;
+    }
+    for (size_t k = 1; k + 1 < glob->__n_segments; k++) {
+        const struct __kiln_glob_segment* seg = &glob->__segments[k];
+        if (seg->mask_table == NO_MASK_TABLE) {
+            continue;
+        }
+        uint64_t* masks = glob->__masks + (size_t)seg->mask_table * 256;
+        uint32_t n = seg->n_atoms < SHIFT_AND_ATOMS ? seg->n_atoms : SHIFT_AND_ATOMS;
+        for (uint32_t a = 0; a < n; a++) {
+            const struct __kiln_glob_atom* atom = &glob->__atoms[seg->first_atom + a];
+            for (unsigned int c = 0; c < 256; c++) {
+                if (atom_matches(glob, atom, (unsigned char)c)) {
+                    masks[c] |= 1ull << a;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief Compiles a glob pattern given as a kstring_ref_t
+/// @param pattern The pattern (see `kstring_glob_compile`)
+/// @return The compiled glob, free it with `kstring_glob_free`
+kstring_glob_t kstring_glob_compile_ref(kstring_ref_t pattern) {
+    kstring_glob_t glob = { .__segments = NULL, .__atoms = NULL, .__classes = NULL, .__literals = NULL, .__masks = NULL, .__n_segments = 0, .__has_star = false };
+    if (pattern.__length >= UINT32_MAX) {
+        return glob;
+    }
+
+    size_t len = pattern.__length;
+    const char* p = pattern.ptr;
+    glob.__segments = malloc((len + 1) * sizeof(struct __kiln_glob_segment));
+    glob.__atoms = malloc((len > 0 ? len : 1) * sizeof(struct __kiln_glob_atom));
+    glob.__classes = malloc((len / 2 + 1) * 4 * sizeof(uint64_t));
+    glob.__literals = malloc(len > 0 ? len : 1);
+    if (glob.__segments == NULL || glob.__atoms == NULL || glob.__classes == NULL || glob.__literals == NULL) {
+        kstring_glob_free(&glob);
+        return glob;
+    }
+
+    uint32_t n_atoms = 0;
+    uint32_t n_classes = 0;
+    struct __kiln_glob_segment* seg = &glob.__segments[0];
+    seg->first_atom = 0;
+    seg->n_atoms = 0;
+    glob.__n_segments = 1;
+
+    size_t i = 0;
+    while (i < len) {
+        char c = p[i];
+        struct __kiln_glob_atom atom = { .kind = GLOB_LITERAL, .byte = (uint8_t)c, .class_idx = 0 };
+
+        if (c == '*') {
+            // Consecutive stars are one star
+            while (i < len && p[i] == '*') {
+                i++;
+            }
+            glob.__has_star = true;
+            close_segment(&glob, seg);
+            seg = &glob.__segments[glob.__n_segments++];
+            seg->first_atom = n_atoms;
+            seg->n_atoms = 0;
+            continue;
+        } else if (c == '?') {
+            atom.kind = GLOB_ANY;
+            i++;
+        } else if (c == '[') {
+            size_t end = parse_class(p, len, i, glob.__classes + 4 * n_classes);
+            if (end == 0) {
+                // Unterminated class, `[` is a literal
+                i++;
+            } else {
+                atom.kind = GLOB_CLASS;
+                atom.class_idx = n_classes++;
+                i = end;
+            }
+        } else if (c == '\\' && i + 1 < len) {
+            atom.byte = (uint8_t)p[i + 1];
+            i += 2;
+        } else {
+            i++;
+        }
+
+        glob.__literals[n_atoms] = (char)atom.byte;
+        glob.__atoms[n_atoms++] = atom;
+        seg->n_atoms++;
+    }
+    close_segment(&glob, seg);
+
+    if (!build_mask_tables(&glob)) {
+        kstring_glob_free(&glob);
+    }
+    return glob;
+}
+
+/// @brief Compiles a glob pattern. `*` matches any run of bytes (including `/`), `?` any single byte,
+/// `[abc]`, `[a-z]` and `[!...]` / `[^...]` a byte from (or not from) a set, and `\` escapes the next character
+/// @param pattern The NUL terminated pattern
+/// @return The compiled glob, free it with `kstring_glob_free`
+kstring_glob_t kstring_glob_compile(const char* pattern) {
+    kstring_ref_t ref = { .ptr = (char*)pattern, .__length = strlen(pattern) };
+    return kstring_glob_compile_ref(ref);
+}
+
+/// @brief Frees the memory of a compiled glob
+/// @param glob 
+void kstring_glob_free(kstring_glob_t* glob) {
+    free(glob->__segments);
+    free(glob->__atoms);
+    free(glob->__classes);
+    free(glob->__literals);
+    free(glob->__masks);
+    glob->__segments = NULL;
+    glob->__atoms = NULL;
+    glob->__classes = NULL;
+    glob->__literals = NULL;
+    glob->__masks = NULL;
+    glob->__n_segments = 0;
+}
+
+/// @brief Checks atoms [from, seg->n_atoms) of a segment against the bytes at `s` (which has at least seg->n_atoms bytes)
+static inline bool segment_matches_from(const kstring_glob_t* glob, const struct __kiln_glob_segment* seg, const char* s, uint32_t from) {
+    const struct __kiln_glob_atom* atoms = glob->__atoms + seg->first_atom;
+    for (uint32_t k = from; k < seg->n_atoms; k++) {
+        if (!atom_matches(glob, &atoms[k], (unsigned char)s[k])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Checks a segment against the bytes at `s` (which has at least seg->n_atoms bytes)
+static inline bool segment_matches_at(const kstring_glob_t* glob, const struct __kiln_glob_segment* seg, const char* s) {
+    return segment_matches_from(glob, seg, s, 0);
+}
+
+/// @brief Shift-And scan for a segment with a mask table, see `segment_find`
+static int64_t segment_shift_and(const kstring_glob_t* glob, const struct __kiln_glob_segment* seg, const char* s, uint64_t from, uint64_t to) {
+    const uint64_t* masks = glob->__masks + (size_t)seg->mask_table * 256;
+    uint32_t n_filter = seg->n_atoms < SHIFT_AND_ATOMS ? seg->n_atoms : SHIFT_AND_ATOMS;
+    const uint64_t accept = 1ull << (n_filter - 1);
+    const char* anchor = glob->__literals + seg->first_atom + seg->anchor_offset;
+    uint64_t last = to - seg->n_atoms;
+
+    uint64_t state = 0;
+    // Skipping is only allowed once the scan has passed the last anchor the find kernel returned,
+    // so no byte is searched twice and the whole scan stays linear
+    uint64_t skip_from = from;
+    for (uint64_t i = from; i < to; i++) {
+        if (state == 0) {
+            if (i > last) {
+                return -1;
+            }
+            if (seg->anchor_len > 0 && i >= skip_from) {
+                // No partial match is alive, so the next one starts where the next anchor occurrence puts it
+                int64_t found = __kiln_kernels->find(s + i + seg->anchor_offset, last - i + seg->anchor_len, anchor, seg->anchor_len);
+                if (found < 0) {
+                    return -1;
+                }
+                i += (uint64_t)found;
+                skip_from = i + seg->anchor_len;
+            }
+        }
+
+        state = ((state << 1) | 1) & masks[(unsigned char)s[i]];
+        if (state & accept) {
+            uint64_t start = i + 1 - n_filter;
+            if (seg->n_atoms == n_filter) {
+                return (int64_t)start;
+            }
+            // Hits come in order, so once one doesn't fit before `to` none will
+            if (start > last) {
+                return -1;
+            }
+            if (segment_matches_from(glob, seg, s + start, n_filter)) {
+                return (int64_t)start;
+            }
+        }
+    }
+    return -1;
+}
+
+/// @brief Finds the leftmost position in [from, to) where the segment matches entirely inside [from, to)
+/// @return The position, or -1
+static int64_t segment_find(const kstring_glob_t* glob, const struct __kiln_glob_segment* seg, const char* s, uint64_t from, uint64_t to) {
+    if (to - from < seg->n_atoms) {
+        return -1;
+    }
+    if (seg->mask_table != NO_MASK_TABLE) {
+        return segment_shift_and(glob, seg, s, from, to);
+    }
+    if (seg->n_atoms == 0) {
+        return (int64_t)from;
+    }
+
+    // A plain literal, the find kernel does all the work
+    const char* literal = glob->__literals + seg->first_atom;
+    int64_t found = __kiln_kernels->find(s + from, to - from, literal, seg->n_atoms);
+    return found < 0 ? -1 : (int64_t)(from + (uint64_t)found);
+}
+
+/// @brief Checks if a whole kstring_ref_t matches the glob. `*` never backtracks and each segment between
+/// `*`s is found in one left to right pass (the find kernel for literals, Shift-And otherwise), so the cost
+/// is linear in the input for segments of up to 64 atoms. Longer segments also check their atoms past the
+/// 64th at each hit of the first 64
+/// @param glob 
+/// @param string 
+/// @return true if it matches
+bool kstring_glob_match(const kstring_glob_t* glob, kstring_ref_t string) {
+    if (glob->__segments == NULL) {
+        return false;
+    }
+
+    const struct __kiln_glob_segment* segs = glob->__segments;
+    const char* s = string.ptr;
+    uint64_t n = string.__length;
+
+    if (!glob->__has_star) {
+        return n == segs[0].n_atoms && segment_matches_at(glob, &segs[0], s);
+    }
+
+    const struct __kiln_glob_segment* head = &segs[0];
+    const struct __kiln_glob_segment* tail = &segs[glob->__n_segments - 1];
+    if (n < (uint64_t)head->n_atoms + tail->n_atoms) {
+        return false;
+    }
+    if (!segment_matches_at(glob, head, s) || !segment_matches_at(glob, tail, s + n - tail->n_atoms)) {
+        return false;
+    }
+
+    uint64_t pos = head->n_atoms;
+    uint64_t end = n - tail->n_atoms;
+    for (size_t k = 1; k + 1 < glob->__n_segments; k++) {
+        int64_t found = segment_find(glob, &segs[k], s, pos, end);
+        if (found < 0) {
+            return false;
+        }
+        pos = (uint64_t)found + segs[k].n_atoms;
+    }
+    return true;
+}
+
+typedef struct {
+    const kstring_glob_t* glob;
+    const kstring_ref_t* strings;
+    size_t n;
+    bool* out;
+    size_t* counts;
+} glob_batch_ctx_t;
+
+static size_t glob_match_range(const kstring_glob_t* glob, const kstring_ref_t* strings, size_t start, size_t end, bool* out) {
+    size_t count = 0;
+    for (size_t i = start; i < end; i++) {
+        bool matched = kstring_glob_match(glob, strings[i]);
+        count += matched;
+        if (out != NULL) {
+            out[i] = matched;
+        }
+    }
+    return count;
+}
+
+static void glob_batch_task(void* ctx, size_t task_idx) {
+    glob_batch_ctx_t* batch = ctx;
+    size_t start = task_idx * KSTRING_GLOB_BATCH_CHUNK;
+    size_t end = start + KSTRING_GLOB_BATCH_CHUNK < batch->n ? start + KSTRING_GLOB_BATCH_CHUNK : batch->n;
+    batch->counts[task_idx] = glob_match_range(batch->glob, batch->strings, start, end, batch->out);
+}
+
+/// @brief Matches many strings against one glob. Large batches are split across the built-in thread pool
+/// @param glob 
+/// @param strings The strings to test
+/// @param n Number of strings
+/// @param out If not NULL, out[i] is set to whether strings[i] matches
+/// @return The number of strings that match
+size_t kstring_glob_match_many(const kstring_glob_t* glob, const kstring_ref_t* strings, size_t n, bool* out) {
+    size_t n_tasks = (n + KSTRING_GLOB_BATCH_CHUNK - 1) / KSTRING_GLOB_BATCH_CHUNK;
+    size_t* counts = n_tasks > 1 && __kiln_parallel_thread_count() > 1 ? malloc(n_tasks * sizeof(size_t)) : NULL;
+    if (counts == NULL) {
+        return glob_match_range(glob, strings, 0, n, out);
+    }
+
+    glob_batch_ctx_t batch = { .glob = glob, .strings = strings, .n = n, .out = out, .counts = counts };
+    __kiln_parallel_run(n_tasks, glob_batch_task, &batch);
+
+    size_t count = 0;
+    for (size_t t = 0; t < n_tasks; t++) {
+        count += counts[t];
+    }
+    free(counts);
+    return count;
+}
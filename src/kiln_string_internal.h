@@ -0,0 +1,255 @@
+#ifndef KILN_STRING_INTERNAL_H
+#define KILN_STRING_INTERNAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../include/kiln_string.h"
+
+// Helpers shared between the translation units in `src/`. Nothing in here is
+// part of the public API.
+
+/// @brief A single unit of work for `__kiln_parallel_run`
+/// @param ctx The context pointer passed to `__kiln_parallel_run`
+/// @param task_idx The index of the task, in [0, n_tasks)
+typedef void (*__kiln_task_fn_t)(void* ctx, size_t task_idx);
+
+/// @brief Returns the number of threads that can run tasks concurrently (workers + the caller)
+/// @return Always at least 1
+size_t __kiln_parallel_thread_count(void);
+
+/// @brief Runs `fn(ctx, i)` for every i in [0, n_tasks) on the built-in thread pool and waits for all of them.
+/// The calling thread also executes tasks, and idle threads steal tasks from busy ones. Calls made
+/// from inside a task, or while another job is running, execute serially on the calling thread.
+/// @param n_tasks Number of tasks to run
+/// @param fn The task function
+/// @param ctx Passed through to `fn`
+void __kiln_parallel_run(size_t n_tasks, __kiln_task_fn_t fn, void* ctx);
+
+/// @brief Same as `__kiln_parallel_run` on a given pool, NULL for the built-in one
+void __kiln_pool_run(kiln_pool_t* pool, size_t n_tasks, __kiln_task_fn_t fn, void* ctx);
+
+/// @brief Grows `string` so that it can hold at least `min_capacity` bytes (including the NUL terminator).
+/// Capacity grows geometrically (by the current `kiln_string_growth_t`) so repeated appends stay amortised O(1).
+/// Once the new capacity reaches `kiln_string_get_map_threshold`, the buffer moves to (or stays in) an mmap'd
+/// mapping that grows with mremap; if mapping fails the heap is used instead
+/// @return false if the allocation failed, `string` is left untouched in that case
+bool __kiln_string_grow(kiln_string_t* string, uint64_t min_capacity);
+
+/// @brief The usable capacity of `string`, without the KILN_STRING_MAPPED flag
+static inline uint64_t __kiln_string_capacity(const kiln_string_t* string) {
+    return string->__capacity & ~(uint64_t)KILN_STRING_MAPPED;
+}
+
+/// @brief Moves `string` to an mmap'd buffer of at least `new_capacity` bytes, or grows its mapping with mremap
+/// @return false if mapping failed (or is unsupported), `string` is left untouched in that case
+bool __kiln_string_map_grow(kiln_string_t* string, uint64_t new_capacity);
+
+/// @brief Shrinks a mapped `string` to `new_capacity` bytes (rounded up to whole pages),
+/// moving it back to the heap if that is below the map threshold
+/// @return false if the new buffer could not be allocated, `string` is left untouched in that case
+bool __kiln_string_map_shrink(kiln_string_t* string, uint64_t new_capacity);
+
+/// @brief Case conversion for the part of a string after its leading ASCII run, see `kiln_string_to_unicode_upper`
+void __kiln_unicode_upper_tail(char* p, uint64_t start, uint64_t len);
+void __kiln_unicode_lower_tail(char* p, uint64_t start, uint64_t len);
+
+// Allocation and copy counters, compiled in with -DKILN_STRING_STATS. Every
+// macro expands to nothing otherwise.
+#ifdef KILN_STRING_STATS
+extern _Thread_local kiln_string_stats_t __kiln_string_stats;
+
+#define KILN_STATS_ALLOC(bytes) (__kiln_string_stats.allocations++, __kiln_string_stats.bytes_allocated += (bytes))
+#define KILN_STATS_REALLOC(bytes) (__kiln_string_stats.reallocations++, __kiln_string_stats.bytes_allocated += (bytes))
+#define KILN_STATS_GROWTH() (__kiln_string_stats.growth_events++)
+#define KILN_STATS_SLACK(bytes) (__kiln_string_stats.capacity_slack += (bytes))
+#define KILN_STATS_COPY(bytes) (__kiln_string_stats.bytes_copied += (bytes))
+#define KILN_STATS_MOVE(bytes) (__kiln_string_stats.bytes_moved += (bytes))
+#else
+#define KILN_STATS_ALLOC(bytes) ((void)0)
+#define KILN_STATS_REALLOC(bytes) ((void)0)
+#define KILN_STATS_GROWTH() ((void)0)
+#define KILN_STATS_SLACK(bytes) ((void)0)
+#define KILN_STATS_COPY(bytes) ((void)0)
+#define KILN_STATS_MOVE(bytes) ((void)0)
+#endif
+
+// A set of byte values. `bits` is the 256-bit membership bitmap used by the
+// scalar code; `low_rows` / `high_rows` hold the same set transposed for pshufb
+// lookups: bit h of low_rows[lo] is set when byte (h << 4 | lo) is a member,
+// and bit h of high_rows[lo] when byte ((h + 8) << 4 | lo) is.
+typedef struct {
+    uint64_t bits[4];
+    uint8_t low_rows[16];
+    uint8_t high_rows[16];
+} __kiln_byte_set_t;
+
+static inline void __kiln_byte_set_add(__kiln_byte_set_t* set, unsigned char c) {
+    set->bits[c >> 6] |= 1ull << (c & 63);
+    if (c < 0x80) {
+        set->low_rows[c & 0xf] |= (uint8_t)(1u << (c >> 4));
+    } else {
+        set->high_rows[c & 0xf] |= (uint8_t)(1u << ((c >> 4) - 8));
+    }
+}
+
+static inline bool __kiln_byte_set_contains(const __kiln_byte_set_t* set, unsigned char c) {
+    return (set->bits[c >> 6] >> (c & 63)) & 1;
+}
+
+// String kernels with a portable implementation plus SIMD variants. The best
+// table for the CPU is bound once at startup (see kiln_string_dispatch.c), and
+// every variant must return exactly what the scalar one does.
+typedef struct {
+    // Offset of the first occurrence of needle in hay, -1 if absent. needle_len is never 0
+    int64_t (*find)(const char* hay, uint64_t hay_len, const char* needle, uint64_t needle_len);
+    // memcmp-style three way compare of `len` bytes (only the sign is meaningful)
+    int (*compare)(const char* a, const char* b, uint64_t len);
+    // ASCII case conversion of `len` bytes from src to dst (which may be the same buffer), bytes >= 0x80 are left alone
+    void (*to_lower)(char* dst, const char* src, uint64_t len);
+    void (*to_upper)(char* dst, const char* src, uint64_t len);
+    // Number of leading / trailing whitespace bytes (' ', \t, \n, \v, \f, \r)
+    uint64_t (*space_prefix)(const char* p, uint64_t len);
+    uint64_t (*space_suffix)(const char* p, uint64_t len);
+    // Number of leading bytes < 0x80
+    uint64_t (*ascii_prefix)(const char* p, uint64_t len);
+    // 64-bit hash, identical on every tier
+    uint64_t (*hash)(const char* p, uint64_t len, uint64_t seed);
+    // Classifies a 64 byte block for the CSV reader: returns the bitmask of '"' bytes
+    // and stores the bitmask of `delim` and '\n' bytes in *sep_mask (bit i = block[i])
+    uint64_t (*csv_masks)(const char* block, char delim, uint64_t* sep_mask);
+    // Number of leading bytes that can go into a JSON string as they are (not '"', '\\' or < 0x20)
+    uint64_t (*json_clean_prefix)(const char* p, uint64_t len);
+    // Number of bytes JSON escaping adds: 1 per two character escape, 5 per \u00XX
+    uint64_t (*json_escape_extra)(const char* p, uint64_t len);
+    // Writes exactly 4 * ceil(len / 3) bytes of padded base64 (standard alphabet) to out
+    void (*base64_encode)(const char* in, uint64_t len, char* out);
+    // Writes exactly 2 * len lowercase hex digits to out
+    void (*hex_encode)(const char* in, uint64_t len, char* out);
+    // Decodes `len` base64 characters (standard alphabet, a multiple of 4, no padding) into 3 * len / 4 bytes at out.
+    // false if a character is not in the alphabet, out is then partly written
+    bool (*base64_decode)(const char* in, uint64_t len, char* out);
+    // Decodes 2 * len hex digits (either case) into len bytes at out. false on a non hex character
+    bool (*hex_decode)(const char* in, uint64_t len, char* out);
+    // Number of leading bytes that are not in `set`
+    uint64_t (*set_prefix)(const char* p, uint64_t len, const __kiln_byte_set_t* set);
+} __kiln_kernels_t;
+
+extern const __kiln_kernels_t __kiln_kernels_scalar;
+#if defined(__x86_64__) && defined(__GNUC__)
+#define KILN_STRING_HAVE_X86_KERNELS 1
+extern const __kiln_kernels_t __kiln_kernels_sse42;
+extern const __kiln_kernels_t __kiln_kernels_avx2;
+extern const __kiln_kernels_t __kiln_kernels_avx512;
+#endif
+
+// The table in use, starts out as the scalar one
+extern const __kiln_kernels_t* __kiln_kernels;
+
+// Scalar kernels, also used by the SIMD variants for short tails
+int64_t __kiln_find_scalar(const char* hay, uint64_t hay_len, const char* needle, uint64_t needle_len);
+uint64_t __kiln_space_prefix_scalar(const char* p, uint64_t len);
+uint64_t __kiln_space_suffix_scalar(const char* p, uint64_t len);
+uint64_t __kiln_ascii_prefix_scalar(const char* p, uint64_t len);
+void __kiln_to_lower_scalar(char* dst, const char* src, uint64_t len);
+void __kiln_to_upper_scalar(char* dst, const char* src, uint64_t len);
+uint64_t __kiln_json_clean_prefix_scalar(const char* p, uint64_t len);
+uint64_t __kiln_json_escape_extra_scalar(const char* p, uint64_t len);
+void __kiln_base64_encode_scalar(const char* in, uint64_t len, char* out);
+void __kiln_hex_encode_scalar(const char* in, uint64_t len, char* out);
+bool __kiln_base64_decode_scalar(const char* in, uint64_t len, char* out);
+bool __kiln_hex_decode_scalar(const char* in, uint64_t len, char* out);
+uint64_t __kiln_set_prefix_scalar(const char* p, uint64_t len, const __kiln_byte_set_t* set);
+
+/// @brief Bytes JSON escaping adds for `c`: 0 if it is copied as is, 1 for \" \\ \b \f \n \r \t, 5 for \u00XX
+static inline uint64_t __kiln_json_escape_extra(unsigned char c) {
+    if (c == '"' || c == '\\') {
+        return 1;
+    }
+    if (c >= 0x20) {
+        return 0;
+    }
+    return (c == '\b' || c == '\t' || c == '\n' || c == '\f' || c == '\r') ? 1 : 5;
+}
+
+static inline bool __kiln_is_space(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// kstring_ref_hash runs two CRC32C lanes (so it can use the SSE4.2 crc32
+// instruction) over the input in 16 byte chunks and mixes them with the length.
+// CRC is linear, so each chunk first goes through a multiply keyed by the seed
+// (see __kiln_hash_chunk_a/b): without it a collision under one seed would be a
+// collision under every seed. Both lanes see both words of every chunk,
+// including the final 0-15 byte tail, so short strings get the full 64 bits.
+#define KILN_HASH_SEED_A 0x9e3779b9u
+#define KILN_HASH_SEED_B 0x85ebca6bu
+#define KILN_HASH_MUL 0x9fb21c651e98df25ull
+
+static inline uint64_t __kiln_load_le64(const char* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+/// @brief Loads the last 0-7 bytes of a string as a zero padded little-endian word
+static inline uint64_t __kiln_load_le_tail(const char* p, uint64_t len) {
+    uint64_t v = 0;
+    for (uint64_t i = 0; i < len; i++) {
+        v |= (uint64_t)(unsigned char)p[i] << (8 * i);
+    }
+    return v;
+}
+
+static inline uint64_t __kiln_hash_mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+/// @brief Derives the two lane keys from the seed
+static inline void __kiln_hash_keys(uint64_t seed, uint64_t* key_a, uint64_t* key_b) {
+    *key_a = __kiln_hash_mix64(seed ^ 0x243f6a8885a308d3ull);
+    *key_b = __kiln_hash_mix64(seed ^ 0x13198a2e03707344ull);
+}
+
+/// @brief The words that a 16 byte chunk (w0, w1) feeds into lane a and lane b.
+/// Each one depends on both words, nonlinearly on the key through the multiply's carries
+static inline uint64_t __kiln_hash_chunk_a(uint64_t w0, uint64_t w1, uint64_t key_a) {
+    return (w0 ^ key_a) * KILN_HASH_MUL + w1;
+}
+
+static inline uint64_t __kiln_hash_chunk_b(uint64_t w0, uint64_t w1, uint64_t key_b) {
+    return (w1 ^ key_b) * KILN_HASH_MUL + w0;
+}
+
+/// @brief Loads the last 0-15 bytes of a string as two zero padded little-endian words
+static inline void __kiln_hash_load_tail(const char* p, uint64_t len, uint64_t* w0, uint64_t* w1) {
+    if (len >= 8) {
+        *w0 = __kiln_load_le64(p);
+        *w1 = __kiln_load_le_tail(p + 8, len - 8);
+    } else {
+        *w0 = __kiln_load_le_tail(p, len);
+        *w1 = 0;
+    }
+}
+
+static inline uint64_t __kiln_hash_finish(uint32_t a, uint32_t b, uint64_t len) {
+    uint64_t h = ((uint64_t)a << 32 | b) ^ (len * 0x9e3779b97f4a7c15ull);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+#endif // KILN_STRING_INTERNAL_H
@@ -0,0 +1,223 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// Copying versions of the in place transforms, for sources that are only
+// borrowed. Every transform has two front ends: `*_into` appends the result to
+// a kiln_string_t, growing it at most once, and `*_buf` writes it to a caller
+// buffer snprintf style. Both write the result straight from the source, so
+// the copy and the transform are one pass.
+
+typedef enum {
+    CASE_ASCII_LOWER,
+    CASE_ASCII_UPPER,
+    CASE_UNICODE_LOWER,
+    CASE_UNICODE_UPPER,
+} case_op_t;
+
+/// @brief Writes the case converted `ref` (ref.__length bytes) to out
+static void write_case(char* out, kstring_ref_t ref, case_op_t op) {
+    bool lower = op == CASE_ASCII_LOWER || op == CASE_UNICODE_LOWER;
+    void (*convert)(char*, const char*, uint64_t) = lower ? __kiln_kernels->to_lower : __kiln_kernels->to_upper;
+
+    if (op == CASE_ASCII_LOWER || op == CASE_ASCII_UPPER) {
+        convert(out, ref.ptr, ref.__length);
+        return;
+    }
+
+    // The leading ASCII run (usually the whole string) is converted as it is copied
+    uint64_t ascii_len = __kiln_kernels->ascii_prefix(ref.ptr, ref.__length);
+    convert(out, ref.ptr, ascii_len);
+    if (ascii_len < ref.__length) {
+        memcpy(out + ascii_len, ref.ptr + ascii_len, ref.__length - ascii_len);
+        if (lower) {
+            __kiln_unicode_lower_tail(out, ascii_len, ref.__length);
+        } else {
+            __kiln_unicode_upper_tail(out, ascii_len, ref.__length);
+        }
+    }
+}
+
+static void case_into(kiln_string_t* string, kstring_ref_t ref, case_op_t op) {
+    if (!__kiln_string_grow(string, string->__length + ref.__length + 1)) {
+        return;
+    }
+    write_case(string->ptr + string->__length, ref, op);
+    KILN_STATS_COPY(ref.__length);
+    string->__length += ref.__length;
+    string->ptr[string->__length] = '\0';
+}
+
+static uint64_t case_buf(kstring_ref_t ref, char* buf, uint64_t buf_size, case_op_t op) {
+    if (ref.__length < buf_size) {
+        write_case(buf, ref, op);
+        buf[ref.__length] = '\0';
+    }
+    return ref.__length;
+}
+
+/// @brief Appends `ref` to `string` with ASCII letters lowercased, other bytes are copied as they are
+/// @param string The kiln_string_t to append to (must not be the memory `ref` points into)
+/// @param ref The source text
+void kstring_ref_to_ascii_lower_into(kiln_string_t* string, kstring_ref_t ref) {
+    case_into(string, ref, CASE_ASCII_LOWER);
+}
+
+/// @brief Appends `ref` to `string` with ASCII letters uppercased, other bytes are copied as they are
+/// @param string The kiln_string_t to append to (must not be the memory `ref` points into)
+/// @param ref The source text
+void kstring_ref_to_ascii_upper_into(kiln_string_t* string, kstring_ref_t ref) {
+    case_into(string, ref, CASE_ASCII_UPPER);
+}
+
+/// @brief Appends `ref` to `string` lowercased like `kiln_string_to_unicode_lower`
+/// @param string The kiln_string_t to append to (must not be the memory `ref` points into)
+/// @param ref The source text
+void kstring_ref_to_unicode_lower_into(kiln_string_t* string, kstring_ref_t ref) {
+    case_into(string, ref, CASE_UNICODE_LOWER);
+}
+
+/// @brief Appends `ref` to `string` uppercased like `kiln_string_to_unicode_upper`
+/// @param string The kiln_string_t to append to (must not be the memory `ref` points into)
+/// @param ref The source text
+void kstring_ref_to_unicode_upper_into(kiln_string_t* string, kstring_ref_t ref) {
+    case_into(string, ref, CASE_UNICODE_UPPER);
+}
+
+/// @brief Writes `ref` with ASCII letters lowercased and a NUL terminator to `buf`
+/// @param ref The source text
+/// @param buf The output buffer, only written to if the result fits
+/// @param buf_size Size of `buf` in bytes
+/// @return The length of the result; it was written only if this is less than `buf_size`
+uint64_t kstring_ref_to_ascii_lower_buf(kstring_ref_t ref, char* buf, uint64_t buf_size) {
+    return case_buf(ref, buf, buf_size, CASE_ASCII_LOWER);
+}
+
+/// @brief Writes `ref` with ASCII letters uppercased and a NUL terminator to `buf`
+/// @param ref The source text
+/// @param buf The output buffer, only written to if the result fits
+/// @param buf_size Size of `buf` in bytes
+/// @return The length of the result; it was written only if this is less than `buf_size`
+uint64_t kstring_ref_to_ascii_upper_buf(kstring_ref_t ref, char* buf, uint64_t buf_size) {
+    return case_buf(ref, buf, buf_size, CASE_ASCII_UPPER);
+}
+
+/// @brief Writes `ref` lowercased like `kiln_string_to_unicode_lower` and a NUL terminator to `buf`
+/// @param ref The source text
+/// @param buf The output buffer, only written to if the result fits
+/// @param buf_size Size of `buf` in bytes
+/// @return The length of the result; it was written only if this is less than `buf_size`
+uint64_t kstring_ref_to_unicode_lower_buf(kstring_ref_t ref, char* buf, uint64_t buf_size) {
+    return case_buf(ref, buf, buf_size, CASE_UNICODE_LOWER);
+}
+
+/// @brief Writes `ref` uppercased like `kiln_string_to_unicode_upper` and a NUL terminator to `buf`
+/// @param ref The source text
+/// @param buf The output buffer, only written to if the result fits
+/// @param buf_size Size of `buf` in bytes
+/// @return The length of the result; it was written only if this is less than `buf_size`
+uint64_t kstring_ref_to_unicode_upper_buf(kstring_ref_t ref, char* buf, uint64_t buf_size) {
+    return case_buf(ref, buf, buf_size, CASE_UNICODE_UPPER);
+}
+
+/// @brief Appends `ref` without its leading and trailing whitespace to `string`
+/// @param string The kiln_string_t to append to (must not be the memory `ref` points into)
+/// @param ref The source text
+void kstring_ref_trim_into(kiln_string_t* string, kstring_ref_t ref) {
+    kstring_ref_t trimmed = kstring_ref_trim(ref);
+    if (trimmed.__length > 0) {
+        kiln_string_push_kstring_ref(string, trimmed);
+    }
+}
+
+/// @brief Writes `ref` without its leading and trailing whitespace and a NUL terminator to `buf`
+/// @param ref The source text
+/// @param buf The output buffer, only written to if the result fits
+/// @param buf_size Size of `buf` in bytes
+/// @return The length of the result; it was written only if this is less than `buf_size`
+uint64_t kstring_ref_trim_buf(kstring_ref_t ref, char* buf, uint64_t buf_size) {
+    kstring_ref_t trimmed = kstring_ref_trim(ref);
+    if (trimmed.__length < buf_size) {
+        if (trimmed.__length > 0) {
+            memcpy(buf, trimmed.ptr, trimmed.__length);
+        }
+        KILN_STATS_COPY(trimmed.__length);
+        buf[trimmed.__length] = '\0';
+    }
+    return trimmed.__length;
+}
+
+/// @brief Length of `ref` with every non-overlapping `old_s` (left to right) replaced by `new_s`
+static uint64_t replaced_length(kstring_ref_t ref, kstring_ref_t old_s, kstring_ref_t new_s) {
+    if (old_s.__length == 0) {
+        return ref.__length;
+    }
+
+    uint64_t count = 0;
+    uint64_t pos = 0;
+    while (pos + old_s.__length <= ref.__length) {
+        int64_t found = __kiln_kernels->find(ref.ptr + pos, ref.__length - pos, old_s.ptr, old_s.__length);
+        if (found < 0) {
+            break;
+        }
+        count++;
+        pos += (uint64_t)found + old_s.__length;
+    }
+    return ref.__length - count * old_s.__length + count * new_s.__length;
+}
+
+/// @brief Writes `ref` with every non-overlapping `old_s` replaced by `new_s` to `out`, copying the runs in between with memcpy
+static void write_replaced(char* out, kstring_ref_t ref, kstring_ref_t old_s, kstring_ref_t new_s) {
+    uint64_t pos = 0;
+    while (old_s.__length > 0 && pos + old_s.__length <= ref.__length) {
+        int64_t found = __kiln_kernels->find(ref.ptr + pos, ref.__length - pos, old_s.ptr, old_s.__length);
+        if (found < 0) {
+            break;
+        }
+        memcpy(out, ref.ptr + pos, (uint64_t)found);
+        out += found;
+        memcpy(out, new_s.ptr, new_s.__length);
+        out += new_s.__length;
+        pos += (uint64_t)found + old_s.__length;
+    }
+    memcpy(out, ref.ptr + pos, ref.__length - pos);
+}
+
+/// @brief Appends `ref` with every non-overlapping occurrence of `old_s` replaced by `new_s` to `string`.
+/// Matches are found left to right like `kiln_string_replace`; an empty `old_s` copies `ref` unchanged
+/// @param string The kiln_string_t to append to (must not be the memory `ref` points into)
+/// @param ref The source text
+/// @param old_s The text to replace
+/// @param new_s The replacement
+void kstring_ref_replace_into(kiln_string_t* string, kstring_ref_t ref, kstring_ref_t old_s, kstring_ref_t new_s) {
+    uint64_t length = replaced_length(ref, old_s, new_s);
+    if (!__kiln_string_grow(string, string->__length + length + 1)) {
+        return;
+    }
+    write_replaced(string->ptr + string->__length, ref, old_s, new_s);
+    KILN_STATS_COPY(length);
+    string->__length += length;
+    string->ptr[string->__length] = '\0';
+}
+
+/// @brief Writes `ref` with every non-overlapping occurrence of `old_s` replaced by `new_s`, and a NUL terminator, to `buf`
+/// @param ref The source text
+/// @param old_s The text to replace
+/// @param new_s The replacement
+/// @param buf The output buffer, only written to if the result fits
+/// @param buf_size Size of `buf` in bytes
+/// @return The length of the result; it was written only if this is less than `buf_size`
+uint64_t kstring_ref_replace_buf(kstring_ref_t ref, kstring_ref_t old_s, kstring_ref_t new_s, char* buf, uint64_t buf_size) {
+    uint64_t length = replaced_length(ref, old_s, new_s);
+    if (length < buf_size) {
+        write_replaced(buf, ref, old_s, new_s);
+        KILN_STATS_COPY(length);
+        buf[length] = '\0';
+    }
+    return length;
+}
@@ -0,0 +1,181 @@
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// Scatter-gather output. Refs are handed to writev as they are, IOV_MAX at a
+// time, so the bytes go from wherever they live straight to the kernel.
+
+#ifndef IOV_MAX
+// The POSIX minimum
+#define IOV_MAX 16
+#endif
+
+// Keeps the byte count of one writev well below SSIZE_MAX (Linux moves at most ~2 GiB per call anyway)
+#define WRITE_MAX_BATCH_BYTES ((uint64_t)1 << 30)
+
+/// @brief Writes the bytes of `refs` to `fd` in order, as if they had been concatenated, without copying them.
+/// Refs are passed to writev in batches of up to IOV_MAX; partial writes and EINTR are retried until
+/// everything is written
+/// @param fd A file descriptor open for writing. With a non-blocking fd, EAGAIN is returned as an error
+/// @param refs The pieces to write
+/// @param n Number of pieces
+/// @return true if every byte was written, false on error (errno tells why; an unknown prefix may have been written)
+bool kiln_write_refs(int fd, const kstring_ref_t* refs, size_t n) {
+    struct iovec iov[IOV_MAX];
+    size_t ref_idx = 0;
+    uint64_t ref_offset = 0;
+
+    for (;;) {
+        // Fill a batch starting at the unwritten part of refs[ref_idx]
+        int n_iov = 0;
+        uint64_t batch_bytes = 0;
+        size_t i = ref_idx;
+        uint64_t offset = ref_offset;
+        while (i < n && n_iov < IOV_MAX && batch_bytes < WRITE_MAX_BATCH_BYTES) {
+            uint64_t len = refs[i].__length - offset;
+            if (len > WRITE_MAX_BATCH_BYTES - batch_bytes) {
+                len = WRITE_MAX_BATCH_BYTES - batch_bytes;
+            }
+            if (len > 0) {
+                iov[n_iov].iov_base = refs[i].ptr + offset;
+                iov[n_iov].iov_len = len;
+                n_iov++;
+                batch_bytes += len;
+            }
+            if (offset + len < refs[i].__length) {
+                break;
+            }
+            i++;
+            offset = 0;
+        }
+        if (n_iov == 0) {
+            return true;
+        }
+
+        ssize_t written = writev(fd, iov, n_iov);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        // Move the cursor past what the kernel took
+        uint64_t left = (uint64_t)written;
+        while (ref_idx < n && left >= refs[ref_idx].__length - ref_offset) {
+            left -= refs[ref_idx].__length - ref_offset;
+            ref_idx++;
+            ref_offset = 0;
+        }
+        ref_offset += left;
+    }
+}
+
+/// @brief Creates an empty builder that collects refs for `kiln_iov_builder_write` without copying their bytes
+/// @return The builder, free it with `kiln_iov_builder_free`
+kiln_iov_builder_t kiln_iov_builder_new(void) {
+    return (kiln_iov_builder_t) {
+        .__refs = NULL,
+        .__count = 0,
+        .__capacity = 0,
+        .__total = 0,
+        .__failed = false,
+    };
+}
+
+/// @brief Frees the memory of a builder (not the bytes its refs point to)
+/// @param builder
+void kiln_iov_builder_free(kiln_iov_builder_t* builder) {
+    free(builder->__refs);
+    *builder = kiln_iov_builder_new();
+}
+
+/// @brief Removes every ref but keeps the allocated memory, so a builder can be reused per response.
+/// Also forgets a failed push
+/// @param builder
+void kiln_iov_builder_clear(kiln_iov_builder_t* builder) {
+    builder->__count = 0;
+    builder->__total = 0;
+    builder->__failed = false;
+}
+
+/// @brief Appends a ref. Only the ref is stored, its bytes must stay valid until the builder is written.
+/// A ref that starts where the previous one ends is merged into it, and empty refs are dropped.
+/// If the ref array can't grow, the builder is marked failed and every later write or collect fails,
+/// so the output is never silently missing a piece
+/// @param builder
+/// @param ref The bytes to append
+void kiln_iov_builder_push(kiln_iov_builder_t* builder, kstring_ref_t ref) {
+    if (ref.__length == 0) {
+        return;
+    }
+
+    if (builder->__count > 0) {
+        kstring_ref_t* last = &builder->__refs[builder->__count - 1];
+        if (last->ptr + last->__length == ref.ptr) {
+            last->__length += ref.__length;
+            builder->__total += ref.__length;
+            return;
+        }
+    }
+
+    if (builder->__count == builder->__capacity) {
+        size_t new_capacity = builder->__capacity > 0 ? builder->__capacity * 2 : 16;
+        kstring_ref_t* grown = new_capacity <= SIZE_MAX / sizeof(kstring_ref_t)
+            ? realloc(builder->__refs, new_capacity * sizeof(kstring_ref_t))
+            : NULL;
+        if (grown == NULL) {
+            builder->__failed = true;
+            return;
+        }
+        builder->__refs = grown;
+        builder->__capacity = new_capacity;
+    }
+
+    builder->__refs[builder->__count++] = ref;
+    builder->__total += ref.__length;
+}
+
+/// @brief Returns the number of bytes collected so far
+/// @param builder
+/// @return The total length of every ref pushed since the last clear
+uint64_t kiln_iov_builder_len(const kiln_iov_builder_t* builder) {
+    return builder->__total;
+}
+
+/// @brief Writes every collected ref to `fd` with `kiln_write_refs`
+/// @param builder
+/// @param fd A file descriptor open for writing
+/// @return true if every byte was written, false on error (errno tells why). Fails with ENOMEM without
+/// writing anything if a push since the last clear could not be stored
+bool kiln_iov_builder_write(const kiln_iov_builder_t* builder, int fd) {
+    if (builder->__failed) {
+        errno = ENOMEM;
+        return false;
+    }
+    return kiln_write_refs(fd, builder->__refs, builder->__count);
+}
+
+/// @brief Appends every collected ref to `string`, for when the pieces have to end up in one buffer after all
+/// @param string The kiln_string_t to append to, grown once
+/// @param builder
+/// @return false, with `string` unchanged, if a push since the last clear could not be stored or the string
+/// could not grow
+bool kiln_iov_builder_collect_into(kiln_string_t* string, const kiln_iov_builder_t* builder) {
+    if (builder->__failed) {
+        return false;
+    }
+    uint64_t length = string->__length;
+    kiln_string_push_concat(string, builder->__refs, builder->__count);
+    return string->__length == length + builder->__total;
+}
@@ -0,0 +1,171 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/// @brief Appends `ref` to `string` escaped for use inside a JSON string literal (the quotes are not added).
+/// The exact output size is counted first, so the string grows at most once; clean runs are copied with memcpy
+/// @param string The kiln_string_t to append to
+/// @param ref The raw bytes
+void kiln_string_push_json_escaped(kiln_string_t* string, kstring_ref_t ref) {
+    uint64_t extra = __kiln_kernels->json_escape_extra(ref.ptr, ref.__length);
+    if (!__kiln_string_grow(string, string->__length + ref.__length + extra + 1)) {
+        return;
+    }
+
+    const char* p = ref.ptr;
+    const char* end = p + ref.__length;
+    char* out = string->ptr + string->__length;
+
+    while (p < end) {
+        uint64_t run = __kiln_kernels->json_clean_prefix(p, (uint64_t)(end - p));
+        memcpy(out, p, run);
+        KILN_STATS_COPY(run);
+        out += run;
+        p += run;
+        if (p == end) {
+            break;
+        }
+
+        unsigned char c = (unsigned char)*p++;
+        *out++ = '\\';
+        switch (c) {
+            case '"': *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '\b': *out++ = 'b'; break;
+            case '\f': *out++ = 'f'; break;
+            case '\n': *out++ = 'n'; break;
+            case '\r': *out++ = 'r'; break;
+            case '\t': *out++ = 't'; break;
+            default:
+                *out++ = 'u';
+                *out++ = '0';
+                *out++ = '0';
+                *out++ = hex_digits[c >> 4];
+                *out++ = hex_digits[c & 0xf];
+                break;
+        }
+    }
+
+    string->__length = (uint64_t)(out - string->ptr);
+    string->ptr[string->__length] = '\0';
+}
+
+/// @brief Parses the 4 hex digits at p
+/// @return The value, or -1 if they are not all hex digits
+static int32_t parse_hex4(const char* p) {
+    int32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        int32_t digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return -1;
+        value = value << 4 | digit;
+    }
+    return value;
+}
+
+static char* write_utf8(char* out, uint32_t cp) {
+    if (cp < 0x80) {
+        *out++ = (char)cp;
+    } else if (cp < 0x800) {
+        *out++ = (char)(0xC0 | (cp >> 6));
+        *out++ = (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = (char)(0xE0 | (cp >> 12));
+        *out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = (char)(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = (char)(0xF0 | (cp >> 18));
+        *out++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = (char)(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+/// @brief Appends the unescaped contents of a JSON string literal (without its quotes) to `string`.
+/// \uXXXX escapes are written as UTF-8, including surrogate pairs. Runs without a backslash are copied with memcpy
+/// @param string The kiln_string_t to append to
+/// @param ref The escaped text
+/// @return false if `ref` has an invalid escape or lone surrogate, `string` is left unchanged in that case
+bool kstring_ref_json_unescape_into(kiln_string_t* string, kstring_ref_t ref) {
+    // Unescaping never makes the text longer (\uXXXX is 6 bytes for at most 3, a pair 12 for 4)
+    if (!__kiln_string_grow(string, string->__length + ref.__length + 1)) {
+        return false;
+    }
+
+    const char* p = ref.ptr;
+    const char* end = p + ref.__length;
+    char* out = string->ptr + string->__length;
+
+    while (p < end) {
+        const char* backslash = memchr(p, '\\', (size_t)(end - p));
+        size_t run = backslash == NULL ? (size_t)(end - p) : (size_t)(backslash - p);
+        memcpy(out, p, run);
+        KILN_STATS_COPY(run);
+        out += run;
+        p += run;
+        if (p == end) {
+            break;
+        }
+
+        if (end - p < 2) {
+            goto invalid;
+        }
+        char c = p[1];
+        p += 2;
+        switch (c) {
+            case '"': *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '/': *out++ = '/'; break;
+            case 'b': *out++ = '\b'; break;
+            case 'f': *out++ = '\f'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+            case 'u': {
+                if (end - p < 4) {
+                    goto invalid;
+                }
+                int32_t cp = parse_hex4(p);
+                p += 4;
+                if (cp < 0 || (cp >= 0xDC00 && cp <= 0xDFFF)) {
+                    goto invalid;
+                }
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    // High surrogate, must be followed by \u and a low surrogate
+                    if (end - p < 6 || p[0] != '\\' || p[1] != 'u') {
+                        goto invalid;
+                    }
+                    int32_t low = parse_hex4(p + 2);
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        goto invalid;
+                    }
+                    p += 6;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+                out = write_utf8(out, (uint32_t)cp);
+                break;
+            }
+            default:
+                goto invalid;
+        }
+    }
+
+    string->__length = (uint64_t)(out - string->ptr);
+    string->ptr[string->__length] = '\0';
+    return true;
+
+invalid:
+    string->ptr[string->__length] = '\0';
+    return false;
+}
@@ -0,0 +1,303 @@
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// Portable kernels, the baseline every SIMD tier must agree with.
+
+static const uint32_t crc32c_table[256] = {
+    0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c, 0x26a1e7e8, 0xd4ca64eb,
+    0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b, 0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24,
+    0x105ec76f, 0xe235446c, 0xf165b798, 0x030e349b, 0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+    0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54, 0x5d1d08bf, 0xaf768bbc, 0xbc267848, 0x4e4dfb4b,
+    0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a, 0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35,
+    0xaa64d611, 0x580f5512, 0x4b5fa6e6, 0xb93425e5, 0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+    0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45, 0xf779deae, 0x05125dad, 0x1642ae59, 0xe4292d5a,
+    0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a, 0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595,
+    0x417b1dbc, 0xb3109ebf, 0xa0406d4b, 0x522bee48, 0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+    0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687, 0x0c38d26c, 0xfe53516f, 0xed03a29b, 0x1f682198,
+    0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927, 0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38,
+    0xdbfc821c, 0x2997011f, 0x3ac7f2eb, 0xc8ac71e8, 0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+    0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096, 0xa65c047d, 0x5437877e, 0x4767748a, 0xb50cf789,
+    0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859, 0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46,
+    0x7198540d, 0x83f3d70e, 0x90a324fa, 0x62c8a7f9, 0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+    0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36, 0x3cdb9bdd, 0xceb018de, 0xdde0eb2a, 0x2f8b6829,
+    0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c, 0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93,
+    0x082f63b7, 0xfa44e0b4, 0xe9141340, 0x1b7f9043, 0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+    0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3, 0x55326b08, 0xa759e80b, 0xb4091bff, 0x466298fc,
+    0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c, 0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033,
+    0xa24bb5a6, 0x502036a5, 0x4370c551, 0xb11b4652, 0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+    0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d, 0xef087a76, 0x1d63f975, 0x0e330a81, 0xfc588982,
+    0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d, 0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622,
+    0x38cc2a06, 0xcaa7a905, 0xd9f75af1, 0x2b9cd9f2, 0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+    0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530, 0x0417b1db, 0xf67c32d8, 0xe52cc12c, 0x1747422f,
+    0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff, 0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0,
+    0xd3d3e1ab, 0x21b862a8, 0x32e8915c, 0xc083125f, 0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+    0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90, 0x9e902e7b, 0x6cfbad78, 0x7fab5e8c, 0x8dc0dd8f,
+    0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee, 0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1,
+    0x69e9f0d5, 0x9b8273d6, 0x88d28022, 0x7ab90321, 0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+    0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81, 0x34f4f86a, 0xc69f7b69, 0xd5cf889d, 0x27a40b9e,
+    0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e, 0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351,
+};
+
+static inline uint32_t crc32c_u64(uint32_t crc, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        crc = crc32c_table[(crc ^ (uint32_t)v) & 0xff] ^ (crc >> 8);
+        v >>= 8;
+    }
+    return crc;
+}
+
+int64_t __kiln_find_scalar(const char* hay, uint64_t hay_len, const char* needle, uint64_t needle_len) {
+    if (needle_len > hay_len) {
+        return -1;
+    }
+
+    const char* found;
+    if (needle_len == 1) {
+        found = memchr(hay, needle[0], hay_len);
+    } else {
+        found = memmem(hay, hay_len, needle, needle_len);
+    }
+    return found == NULL ? -1 : (int64_t)(found - hay);
+}
+
+static int compare_scalar(const char* a, const char* b, uint64_t len) {
+    return memcmp(a, b, len);
+}
+
+void __kiln_to_lower_scalar(char* dst, const char* src, uint64_t len) {
+    for (uint64_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)src[i];
+        dst[i] = (char)((c >= 'A' && c <= 'Z') ? c + 32 : c);
+    }
+}
+
+void __kiln_to_upper_scalar(char* dst, const char* src, uint64_t len) {
+    for (uint64_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)src[i];
+        dst[i] = (char)((c >= 'a' && c <= 'z') ? c - 32 : c);
+    }
+}
+
+uint64_t __kiln_space_prefix_scalar(const char* p, uint64_t len) {
+    uint64_t i = 0;
+    while (i < len && __kiln_is_space((unsigned char)p[i])) {
+        i++;
+    }
+    return i;
+}
+
+uint64_t __kiln_space_suffix_scalar(const char* p, uint64_t len) {
+    uint64_t i = 0;
+    while (i < len && __kiln_is_space((unsigned char)p[len - 1 - i])) {
+        i++;
+    }
+    return i;
+}
+
+uint64_t __kiln_ascii_prefix_scalar(const char* p, uint64_t len) {
+    uint64_t i = 0;
+    while (i + 8 <= len) {
+        uint64_t word;
+        memcpy(&word, p + i, 8);
+        if (word & 0x8080808080808080ull) {
+            break;
+        }
+        i += 8;
+    }
+    while (i < len && (unsigned char)p[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+static uint64_t hash_scalar(const char* p, uint64_t len, uint64_t seed) {
+    uint64_t key_a, key_b;
+    __kiln_hash_keys(seed, &key_a, &key_b);
+    uint32_t a = KILN_HASH_SEED_A;
+    uint32_t b = KILN_HASH_SEED_B;
+    uint64_t remaining = len;
+    uint64_t w0, w1;
+
+    while (remaining >= 16) {
+        w0 = __kiln_load_le64(p);
+        w1 = __kiln_load_le64(p + 8);
+        a = crc32c_u64(a, __kiln_hash_chunk_a(w0, w1, key_a));
+        b = crc32c_u64(b, __kiln_hash_chunk_b(w0, w1, key_b));
+        p += 16;
+        remaining -= 16;
+    }
+    __kiln_hash_load_tail(p, remaining, &w0, &w1);
+    a = crc32c_u64(a, __kiln_hash_chunk_a(w0, w1, key_a));
+    b = crc32c_u64(b, __kiln_hash_chunk_b(w0, w1, key_b));
+
+    return __kiln_hash_finish(a, b, len);
+}
+
+static uint64_t csv_masks_scalar(const char* block, char delim, uint64_t* sep_mask) {
+    uint64_t quotes = 0;
+    uint64_t seps = 0;
+    for (int i = 0; i < 64; i++) {
+        quotes |= (uint64_t)(block[i] == '"') << i;
+        seps |= (uint64_t)(block[i] == delim || block[i] == '\n') << i;
+    }
+    *sep_mask = seps;
+    return quotes;
+}
+
+uint64_t __kiln_json_clean_prefix_scalar(const char* p, uint64_t len) {
+    uint64_t i = 0;
+    while (i < len && __kiln_json_escape_extra((unsigned char)p[i]) == 0) {
+        i++;
+    }
+    return i;
+}
+
+uint64_t __kiln_json_escape_extra_scalar(const char* p, uint64_t len) {
+    uint64_t extra = 0;
+    for (uint64_t i = 0; i < len; i++) {
+        extra += __kiln_json_escape_extra((unsigned char)p[i]);
+    }
+    return extra;
+}
+
+static const char base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char hex_alphabet[] = "0123456789abcdef";
+
+void __kiln_base64_encode_scalar(const char* in, uint64_t len, char* out) {
+    const unsigned char* p = (const unsigned char*)in;
+    uint64_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        uint32_t v = (uint32_t)p[i] << 16 | (uint32_t)p[i + 1] << 8 | p[i + 2];
+        *out++ = base64_alphabet[v >> 18];
+        *out++ = base64_alphabet[(v >> 12) & 63];
+        *out++ = base64_alphabet[(v >> 6) & 63];
+        *out++ = base64_alphabet[v & 63];
+    }
+    if (len - i == 1) {
+        uint32_t v = (uint32_t)p[i] << 16;
+        *out++ = base64_alphabet[v >> 18];
+        *out++ = base64_alphabet[(v >> 12) & 63];
+        *out++ = '=';
+        *out++ = '=';
+    } else if (len - i == 2) {
+        uint32_t v = (uint32_t)p[i] << 16 | (uint32_t)p[i + 1] << 8;
+        *out++ = base64_alphabet[v >> 18];
+        *out++ = base64_alphabet[(v >> 12) & 63];
+        *out++ = base64_alphabet[(v >> 6) & 63];
+        *out++ = '=';
+    }
+}
+
+void __kiln_hex_encode_scalar(const char* in, uint64_t len, char* out) {
+    for (uint64_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)in[i];
+        out[2 * i] = hex_alphabet[c >> 4];
+        out[2 * i + 1] = hex_alphabet[c & 0xf];
+    }
+}
+
+// Decoding tables, 255 marks a byte that is not part of the alphabet
+static const uint8_t base64_values[256] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  62, 255, 255, 255,  63,
+     52,  53,  54,  55,  56,  57,  58,  59,  60,  61, 255, 255, 255, 255, 255, 255,
+    255,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,
+     15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25, 255, 255, 255, 255, 255,
+    255,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,
+     41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+static const uint8_t hex_values[256] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+      0,   1,   2,   3,   4,   5,   6,   7,   8,   9, 255, 255, 255, 255, 255, 255,
+    255,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255,  10,  11,  12,  13,  14,  15, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+bool __kiln_base64_decode_scalar(const char* in, uint64_t len, char* out) {
+    const unsigned char* p = (const unsigned char*)in;
+    // Four sextets at a time, any invalid byte sets bit 7 of the or
+    for (uint64_t i = 0; i < len; i += 4) {
+        uint32_t a = base64_values[p[i]];
+        uint32_t b = base64_values[p[i + 1]];
+        uint32_t c = base64_values[p[i + 2]];
+        uint32_t d = base64_values[p[i + 3]];
+        if ((a | b | c | d) & 0x80) {
+            return false;
+        }
+        uint32_t v = a << 18 | b << 12 | c << 6 | d;
+        *out++ = (char)(v >> 16);
+        *out++ = (char)(v >> 8);
+        *out++ = (char)v;
+    }
+    return true;
+}
+
+bool __kiln_hex_decode_scalar(const char* in, uint64_t len, char* out) {
+    const unsigned char* p = (const unsigned char*)in;
+    for (uint64_t i = 0; i < len; i++) {
+        uint8_t hi = hex_values[p[2 * i]];
+        uint8_t lo = hex_values[p[2 * i + 1]];
+        if ((hi | lo) & 0x80) {
+            return false;
+        }
+        out[i] = (char)(hi << 4 | lo);
+    }
+    return true;
+}
+
+uint64_t __kiln_set_prefix_scalar(const char* p, uint64_t len, const __kiln_byte_set_t* set) {
+    uint64_t i = 0;
+    while (i < len && !__kiln_byte_set_contains(set, (unsigned char)p[i])) {
+        i++;
+    }
+    return i;
+}
+
+const __kiln_kernels_t __kiln_kernels_scalar = {
+    .find = __kiln_find_scalar,
+    .compare = compare_scalar,
+    .to_lower = __kiln_to_lower_scalar,
+    .to_upper = __kiln_to_upper_scalar,
+    .space_prefix = __kiln_space_prefix_scalar,
+    .space_suffix = __kiln_space_suffix_scalar,
+    .ascii_prefix = __kiln_ascii_prefix_scalar,
+    .hash = hash_scalar,
+    .csv_masks = csv_masks_scalar,
+    .json_clean_prefix = __kiln_json_clean_prefix_scalar,
+    .json_escape_extra = __kiln_json_escape_extra_scalar,
+    .base64_encode = __kiln_base64_encode_scalar,
+    .hex_encode = __kiln_hex_encode_scalar,
+    .base64_decode = __kiln_base64_decode_scalar,
+    .hex_decode = __kiln_hex_decode_scalar,
+    .set_prefix = __kiln_set_prefix_scalar,
+};
@@ -0,0 +1,856 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// SSE4.2, AVX2 and AVX-512BW variants of the kernels in kiln_string_kernels.c.
+// Each function is compiled for its own target, so the rest of the library
+// can stay at the baseline ISA and this file is safe to link on any x86-64.
+
+#ifdef KILN_STRING_HAVE_X86_KERNELS
+
+#include <immintrin.h>
+
+#define KILN_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define KILN_TARGET_AVX2 __attribute__((target("avx2,sse4.2")))
+#define KILN_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx2,sse4.2")))
+
+// The first/last byte filter in `find` is quadratic on adversarial inputs. Once
+// failed verifications cost more than this, hand the rest to memmem, which is linear.
+#define KILN_FIND_WASTE_LIMIT(scanned) (4 * (scanned) + 4096)
+
+static inline uint64_t kiln_tail_mask64(uint64_t n) {
+    return n >= 64 ? ~0ull : (1ull << n) - 1;
+}
+
+// ---------------------------------------------------------------------------
+// SSE4.2 (16 byte vectors)
+
+KILN_TARGET_SSE42 static int64_t find_sse42(const char* hay, uint64_t hay_len, const char* needle, uint64_t needle_len) {
+    if (needle_len == 1 || needle_len > hay_len) {
+        return __kiln_find_scalar(hay, hay_len, needle, needle_len);
+    }
+
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+    uint64_t waste = 0;
+    uint64_t i = 0;
+
+    for (; i + needle_len - 1 + 16 <= hay_len; i += 16) {
+        __m128i block_first = _mm_loadu_si128((const __m128i*)(hay + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i*)(hay + i + needle_len - 1));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+
+        while (mask != 0) {
+            uint32_t bit = (uint32_t)__builtin_ctz(mask);
+            if (memcmp(hay + i + bit + 1, needle + 1, needle_len - 2) == 0) {
+                return (int64_t)(i + bit);
+            }
+            waste += needle_len;
+            mask &= mask - 1;
+        }
+        if (waste > KILN_FIND_WASTE_LIMIT(i)) {
+            break;
+        }
+    }
+
+    int64_t rest = __kiln_find_scalar(hay + i, hay_len - i, needle, needle_len);
+    return rest < 0 ? -1 : (int64_t)i + rest;
+}
+
+KILN_TARGET_SSE42 static int compare_sse42(const char* a, const char* b, uint64_t len) {
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        uint32_t diff = ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) & 0xffff;
+        if (diff != 0) {
+            uint32_t k = (uint32_t)__builtin_ctz(diff);
+            return (int)(unsigned char)a[i + k] - (int)(unsigned char)b[i + k];
+        }
+    }
+    return memcmp(a + i, b + i, len - i);
+}
+
+KILN_TARGET_SSE42 static inline __m128i case_mask_sse42(__m128i v, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+}
+
+KILN_TARGET_SSE42 static void to_lower_sse42(char* dst, const char* src, uint64_t len) {
+    const __m128i bit = _mm_set1_epi8(0x20);
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        v = _mm_xor_si128(v, _mm_and_si128(case_mask_sse42(v, 'A', 'Z'), bit));
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    }
+    __kiln_to_lower_scalar(dst + i, src + i, len - i);
+}
+
+KILN_TARGET_SSE42 static void to_upper_sse42(char* dst, const char* src, uint64_t len) {
+    const __m128i bit = _mm_set1_epi8(0x20);
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        v = _mm_xor_si128(v, _mm_and_si128(case_mask_sse42(v, 'a', 'z'), bit));
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    }
+    __kiln_to_upper_scalar(dst + i, src + i, len - i);
+}
+
+KILN_TARGET_SSE42 static inline uint32_t non_space_mask_sse42(const char* p) {
+    __m128i v = _mm_loadu_si128((const __m128i*)p);
+    __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), case_mask_sse42(v, '\t', '\r'));
+    return ~(uint32_t)_mm_movemask_epi8(ws) & 0xffff;
+}
+
+KILN_TARGET_SSE42 static uint64_t space_prefix_sse42(const char* p, uint64_t len) {
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint32_t non_ws = non_space_mask_sse42(p + i);
+        if (non_ws != 0) {
+            return i + (uint64_t)__builtin_ctz(non_ws);
+        }
+    }
+    return i + __kiln_space_prefix_scalar(p + i, len - i);
+}
+
+KILN_TARGET_SSE42 static uint64_t space_suffix_sse42(const char* p, uint64_t len) {
+    uint64_t n = 0;
+    for (; n + 16 <= len; n += 16) {
+        uint32_t non_ws = non_space_mask_sse42(p + len - n - 16);
+        if (non_ws != 0) {
+            return n + (uint64_t)(__builtin_clz(non_ws) - 16);
+        }
+    }
+    return n + __kiln_space_suffix_scalar(p, len - n);
+}
+
+KILN_TARGET_SSE42 static uint64_t ascii_prefix_sse42(const char* p, uint64_t len) {
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint32_t high = (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(p + i)));
+        if (high != 0) {
+            return i + (uint64_t)__builtin_ctz(high);
+        }
+    }
+    return i + __kiln_ascii_prefix_scalar(p + i, len - i);
+}
+
+KILN_TARGET_SSE42 static uint64_t hash_sse42(const char* p, uint64_t len, uint64_t seed) {
+    uint64_t key_a, key_b;
+    __kiln_hash_keys(seed, &key_a, &key_b);
+    uint32_t a = KILN_HASH_SEED_A;
+    uint32_t b = KILN_HASH_SEED_B;
+    uint64_t remaining = len;
+    uint64_t w0, w1;
+
+    while (remaining >= 16) {
+        w0 = __kiln_load_le64(p);
+        w1 = __kiln_load_le64(p + 8);
+        a = (uint32_t)_mm_crc32_u64(a, __kiln_hash_chunk_a(w0, w1, key_a));
+        b = (uint32_t)_mm_crc32_u64(b, __kiln_hash_chunk_b(w0, w1, key_b));
+        p += 16;
+        remaining -= 16;
+    }
+    __kiln_hash_load_tail(p, remaining, &w0, &w1);
+    a = (uint32_t)_mm_crc32_u64(a, __kiln_hash_chunk_a(w0, w1, key_a));
+    b = (uint32_t)_mm_crc32_u64(b, __kiln_hash_chunk_b(w0, w1, key_b));
+
+    return __kiln_hash_finish(a, b, len);
+}
+
+KILN_TARGET_SSE42 static uint64_t csv_masks_sse42(const char* block, char delim, uint64_t* sep_mask) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i sep = _mm_set1_epi8(delim);
+    const __m128i newline = _mm_set1_epi8('\n');
+    uint64_t quotes = 0;
+    uint64_t seps = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+        quotes |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)) << (16 * i);
+        seps |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, sep), _mm_cmpeq_epi8(v, newline))) << (16 * i);
+    }
+    *sep_mask = seps;
+    return quotes;
+}
+
+// JSON escaping: `needs` is every byte < 0x20 plus '"' and '\\', `short_esc` the ones
+// with a two character escape. Everything else in `needs` becomes \u00XX
+
+KILN_TARGET_SSE42 static inline __m128i json_needs_sse42(__m128i v, __m128i* short_esc) {
+    __m128i ctrl = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1f)), v);
+    __m128i special = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+    if (short_esc != NULL) {
+        // \b \t \n are 8, 9, 10 (v - 8 <= 2 unsigned); \f \r are 12, 13
+        __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(8));
+        __m128i named = _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(2)), shifted),
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\f')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+        *short_esc = _mm_or_si128(special, named);
+    }
+    return _mm_or_si128(ctrl, special);
+}
+
+KILN_TARGET_SSE42 static uint64_t json_clean_prefix_sse42(const char* p, uint64_t len) {
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint32_t needs = (uint32_t)_mm_movemask_epi8(json_needs_sse42(_mm_loadu_si128((const __m128i*)(p + i)), NULL));
+        if (needs != 0) {
+            return i + (uint64_t)__builtin_ctz(needs);
+        }
+    }
+    return i + __kiln_json_clean_prefix_scalar(p + i, len - i);
+}
+
+KILN_TARGET_SSE42 static uint64_t json_escape_extra_sse42(const char* p, uint64_t len) {
+    uint64_t extra = 0;
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i short_esc;
+        __m128i needs = json_needs_sse42(_mm_loadu_si128((const __m128i*)(p + i)), &short_esc);
+        uint32_t short_mask = (uint32_t)_mm_movemask_epi8(short_esc);
+        uint32_t long_mask = (uint32_t)_mm_movemask_epi8(needs) & ~short_mask;
+        extra += (uint64_t)__builtin_popcount(short_mask) + 5 * (uint64_t)__builtin_popcount(long_mask);
+    }
+    return extra + __kiln_json_escape_extra_scalar(p + i, len - i);
+}
+
+KILN_TARGET_SSE42 static void hex_encode_sse42(const char* in, uint64_t len, char* out) {
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+        __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, nibble));
+        _mm_storeu_si128((__m128i*)(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    __kiln_hex_encode_scalar(in + i, len - i, out + 2 * i);
+}
+
+// Base64 decoding after Muła and Lemire: pshufb lookups on the low and high
+// nibble of each character give two bit classes that only intersect for bytes
+// outside the alphabet, and a third lookup on the high nibble gives the offset
+// from the character to its 6-bit value ('/' is the one character that shares
+// a high nibble with '+' but not its offset). maddubs/madd then pack the four
+// sextets of each 32-bit lane into 3 bytes.
+#define KILN_BASE64_LUT_LO 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+#define KILN_BASE64_LUT_HI 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+#define KILN_BASE64_LUT_ROLL 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+#define KILN_BASE64_PACK 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+
+KILN_TARGET_SSE42 static bool base64_decode_sse42(const char* in, uint64_t len, char* out) {
+    const __m128i lut_lo = _mm_setr_epi8(KILN_BASE64_LUT_LO);
+    const __m128i lut_hi = _mm_setr_epi8(KILN_BASE64_LUT_HI);
+    const __m128i lut_roll = _mm_setr_epi8(KILN_BASE64_LUT_ROLL);
+    const __m128i pack = _mm_setr_epi8(KILN_BASE64_PACK);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    uint64_t i = 0;
+    uint64_t o = 0;
+
+    // 16 characters -> 12 bytes, the 16 byte store needs 4 more bytes of output after them
+    for (; i + 24 <= len; i += 16, o += 12) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi32(v, 4), nibble);
+        __m128i lo = _mm_and_si128(v, nibble);
+        if (!_mm_testz_si128(_mm_shuffle_epi8(lut_lo, lo), _mm_shuffle_epi8(lut_hi, hi))) {
+            return false;
+        }
+        __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('/')), hi));
+        __m128i sextets = _mm_add_epi8(v, roll);
+        __m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+        __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128((__m128i*)(out + o), _mm_shuffle_epi8(words, pack));
+    }
+    return __kiln_base64_decode_scalar(in + i, len - i, out + o);
+}
+
+// Hex digits are range checked ('0'-'9' and, with the case bit set, 'a'-'f'), then
+// maddubs joins each pair of nibbles into a byte.
+KILN_TARGET_SSE42 static inline __m128i hex_nibbles_sse42(__m128i v, __m128i* valid) {
+    __m128i digit = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    *valid = _mm_or_si128(is_digit, is_letter);
+    return _mm_blendv_epi8(_mm_add_epi8(letter, _mm_set1_epi8(10)), digit, is_digit);
+}
+
+KILN_TARGET_SSE42 static bool hex_decode_sse42(const char* in, uint64_t len, char* out) {
+    const __m128i join = _mm_set1_epi16(0x0110);
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i valid_a, valid_b;
+        __m128i a = hex_nibbles_sse42(_mm_loadu_si128((const __m128i*)(in + 2 * i)), &valid_a);
+        __m128i b = hex_nibbles_sse42(_mm_loadu_si128((const __m128i*)(in + 2 * i + 16)), &valid_b);
+        if (_mm_movemask_epi8(_mm_and_si128(valid_a, valid_b)) != 0xffff) {
+            return false;
+        }
+        __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(a, join), _mm_maddubs_epi16(b, join));
+        _mm_storeu_si128((__m128i*)(out + i), bytes);
+    }
+    return __kiln_hex_decode_scalar(in + 2 * i, len - i, out + i);
+}
+
+// Byte set membership with two pshufb lookups: the low nibble picks a row of
+// `low_rows` or `high_rows` (by the top bit of the byte) and the high nibble
+// picks the bit within that row. Works for any of the 256 possible members.
+KILN_TARGET_SSE42 static inline __m128i byte_set_match_sse42(__m128i v, __m128i low_rows, __m128i high_rows) {
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i bit_of = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    __m128i lo = _mm_and_si128(v, nibble);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+    __m128i rows = _mm_blendv_epi8(_mm_shuffle_epi8(low_rows, lo), _mm_shuffle_epi8(high_rows, lo), v);
+    __m128i bit = _mm_shuffle_epi8(bit_of, hi);
+    return _mm_cmpeq_epi8(_mm_and_si128(rows, bit), bit);
+}
+
+KILN_TARGET_SSE42 static uint64_t set_prefix_sse42(const char* p, uint64_t len, const __kiln_byte_set_t* set) {
+    const __m128i low_rows = _mm_loadu_si128((const __m128i*)set->low_rows);
+    const __m128i high_rows = _mm_loadu_si128((const __m128i*)set->high_rows);
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+        uint32_t hits = (uint32_t)_mm_movemask_epi8(byte_set_match_sse42(v, low_rows, high_rows));
+        if (hits != 0) {
+            return i + (uint64_t)__builtin_ctz(hits);
+        }
+    }
+    return i + __kiln_set_prefix_scalar(p + i, len - i, set);
+}
+
+const __kiln_kernels_t __kiln_kernels_sse42 = {
+    .find = find_sse42,
+    .compare = compare_sse42,
+    .to_lower = to_lower_sse42,
+    .to_upper = to_upper_sse42,
+    .space_prefix = space_prefix_sse42,
+    .space_suffix = space_suffix_sse42,
+    .ascii_prefix = ascii_prefix_sse42,
+    .hash = hash_sse42,
+    .csv_masks = csv_masks_sse42,
+    .json_clean_prefix = json_clean_prefix_sse42,
+    .json_escape_extra = json_escape_extra_sse42,
+    .base64_encode = __kiln_base64_encode_scalar,
+    .hex_encode = hex_encode_sse42,
+    .base64_decode = base64_decode_sse42,
+    .hex_decode = hex_decode_sse42,
+    .set_prefix = set_prefix_sse42,
+};
+
+// ---------------------------------------------------------------------------
+// AVX2 (32 byte vectors)
+
+KILN_TARGET_AVX2 static int64_t find_avx2(const char* hay, uint64_t hay_len, const char* needle, uint64_t needle_len) {
+    if (needle_len == 1 || needle_len > hay_len) {
+        return __kiln_find_scalar(hay, hay_len, needle, needle_len);
+    }
+
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[needle_len - 1]);
+    uint64_t waste = 0;
+    uint64_t i = 0;
+
+    for (; i + needle_len - 1 + 32 <= hay_len; i += 32) {
+        __m256i block_first = _mm256_loadu_si256((const __m256i*)(hay + i));
+        __m256i block_last = _mm256_loadu_si256((const __m256i*)(hay + i + needle_len - 1));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last)));
+
+        while (mask != 0) {
+            uint32_t bit = (uint32_t)__builtin_ctz(mask);
+            if (memcmp(hay + i + bit + 1, needle + 1, needle_len - 2) == 0) {
+                return (int64_t)(i + bit);
+            }
+            waste += needle_len;
+            mask &= mask - 1;
+        }
+        if (waste > KILN_FIND_WASTE_LIMIT(i)) {
+            break;
+        }
+    }
+
+    int64_t rest = __kiln_find_scalar(hay + i, hay_len - i, needle, needle_len);
+    return rest < 0 ? -1 : (int64_t)i + rest;
+}
+
+KILN_TARGET_AVX2 static int compare_avx2(const char* a, const char* b, uint64_t len) {
+    uint64_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        uint32_t diff = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+        if (diff != 0) {
+            uint32_t k = (uint32_t)__builtin_ctz(diff);
+            return (int)(unsigned char)a[i + k] - (int)(unsigned char)b[i + k];
+        }
+    }
+    return compare_sse42(a + i, b + i, len - i);
+}
+
+KILN_TARGET_AVX2 static inline __m256i case_mask_avx2(__m256i v, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v));
+}
+
+KILN_TARGET_AVX2 static void to_lower_avx2(char* dst, const char* src, uint64_t len) {
+    const __m256i bit = _mm256_set1_epi8(0x20);
+    uint64_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        v = _mm256_xor_si256(v, _mm256_and_si256(case_mask_avx2(v, 'A', 'Z'), bit));
+        _mm256_storeu_si256((__m256i*)(dst + i), v);
+    }
+    to_lower_sse42(dst + i, src + i, len - i);
+}
+
+KILN_TARGET_AVX2 static void to_upper_avx2(char* dst, const char* src, uint64_t len) {
+    const __m256i bit = _mm256_set1_epi8(0x20);
+    uint64_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        v = _mm256_xor_si256(v, _mm256_and_si256(case_mask_avx2(v, 'a', 'z'), bit));
+        _mm256_storeu_si256((__m256i*)(dst + i), v);
+    }
+    to_upper_sse42(dst + i, src + i, len - i);
+}
+
+KILN_TARGET_AVX2 static inline uint32_t non_space_mask_avx2(const char* p) {
+    __m256i v = _mm256_loadu_si256((const __m256i*)p);
+    __m256i ws = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), case_mask_avx2(v, '\t', '\r'));
+    return ~(uint32_t)_mm256_movemask_epi8(ws);
+}
+
+KILN_TARGET_AVX2 static uint64_t space_prefix_avx2(const char* p, uint64_t len) {
+    uint64_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        uint32_t non_ws = non_space_mask_avx2(p + i);
+        if (non_ws != 0) {
+            return i + (uint64_t)__builtin_ctz(non_ws);
+        }
+    }
+    return i + space_prefix_sse42(p + i, len - i);
+}
+
+KILN_TARGET_AVX2 static uint64_t space_suffix_avx2(const char* p, uint64_t len) {
+    uint64_t n = 0;
+    for (; n + 32 <= len; n += 32) {
+        uint32_t non_ws = non_space_mask_avx2(p + len - n - 32);
+        if (non_ws != 0) {
+            return n + (uint64_t)__builtin_clz(non_ws);
+        }
+    }
+    return n + space_suffix_sse42(p, len - n);
+}
+
+KILN_TARGET_AVX2 static uint64_t ascii_prefix_avx2(const char* p, uint64_t len) {
+    uint64_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        uint32_t high = (uint32_t)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(p + i)));
+        if (high != 0) {
+            return i + (uint64_t)__builtin_ctz(high);
+        }
+    }
+    return i + ascii_prefix_sse42(p + i, len - i);
+}
+
+KILN_TARGET_AVX2 static uint64_t csv_masks_avx2(const char* block, char delim, uint64_t* sep_mask) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i sep = _mm256_set1_epi8(delim);
+    const __m256i newline = _mm256_set1_epi8('\n');
+    __m256i lo = _mm256_loadu_si256((const __m256i*)block);
+    __m256i hi = _mm256_loadu_si256((const __m256i*)(block + 32));
+
+    uint64_t quotes = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, quote))
+        | (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, quote)) << 32;
+    *sep_mask = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(lo, sep), _mm256_cmpeq_epi8(lo, newline)))
+        | (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(hi, sep), _mm256_cmpeq_epi8(hi, newline))) << 32;
+    return quotes;
+}
+
+KILN_TARGET_AVX2 static inline __m256i json_needs_avx2(__m256i v, __m256i* short_esc) {
+    __m256i ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1f)), v);
+    __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+    if (short_esc != NULL) {
+        __m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(8));
+        __m256i named = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(2)), shifted),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\f')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+        *short_esc = _mm256_or_si256(special, named);
+    }
+    return _mm256_or_si256(ctrl, special);
+}
+
+KILN_TARGET_AVX2 static uint64_t json_clean_prefix_avx2(const char* p, uint64_t len) {
+    uint64_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        uint32_t needs = (uint32_t)_mm256_movemask_epi8(json_needs_avx2(_mm256_loadu_si256((const __m256i*)(p + i)), NULL));
+        if (needs != 0) {
+            return i + (uint64_t)__builtin_ctz(needs);
+        }
+    }
+    return i + json_clean_prefix_sse42(p + i, len - i);
+}
+
+KILN_TARGET_AVX2 static uint64_t json_escape_extra_avx2(const char* p, uint64_t len) {
+    uint64_t extra = 0;
+    uint64_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i short_esc;
+        __m256i needs = json_needs_avx2(_mm256_loadu_si256((const __m256i*)(p + i)), &short_esc);
+        uint32_t short_mask = (uint32_t)_mm256_movemask_epi8(short_esc);
+        uint32_t long_mask = (uint32_t)_mm256_movemask_epi8(needs) & ~short_mask;
+        extra += (uint64_t)__builtin_popcount(short_mask) + 5 * (uint64_t)__builtin_popcount(long_mask);
+    }
+    return extra + json_escape_extra_sse42(p + i, len - i);
+}
+
+// Base64 encoding after Wojciech Muła's AVX2 scheme: a byte shuffle spreads each
+// 3 input bytes over a 32-bit lane, mulhi/mullo by powers of two move the four
+// 6-bit fields into separate bytes, and a 16 entry pshufb table turns each
+// 6-bit value into the offset to its ASCII character.
+KILN_TARGET_AVX2 static void base64_encode_avx2(const char* in, uint64_t len, char* out) {
+    const __m256i spread = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i offsets = _mm256_setr_epi8(
+        65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+        65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+    uint64_t i = 0;
+    uint64_t o = 0;
+
+    // 24 input bytes per iteration, the 16 byte loads read up to in + i + 28
+    for (; i + 28 <= len; i += 24, o += 32) {
+        __m128i lo = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(in + i + 12));
+        __m256i v = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), spread);
+
+        __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+        __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+        __m256i sextets = _mm256_or_si256(t0, t1);
+
+        // 0..25 -> 'A', 26..51 -> 'a', 52..61 -> '0', 62 -> '+', 63 -> '/'
+        __m256i idx = _mm256_subs_epu8(sextets, _mm256_set1_epi8(51));
+        idx = _mm256_sub_epi8(idx, _mm256_cmpgt_epi8(sextets, _mm256_set1_epi8(25)));
+        __m256i chars = _mm256_add_epi8(sextets, _mm256_shuffle_epi8(offsets, idx));
+        _mm256_storeu_si256((__m256i*)(out + o), chars);
+    }
+    __kiln_base64_encode_scalar(in + i, len - i, out + o);
+}
+
+KILN_TARGET_AVX2 static void hex_encode_avx2(const char* in, uint64_t len, char* out) {
+    const __m256i digits = _mm256_setr_epi8(
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    uint64_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+        __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(v, nibble));
+        // unpack works per 128-bit lane, so put the halves back in order
+        __m256i first = _mm256_unpacklo_epi8(hi, lo);
+        __m256i second = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i*)(out + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256((__m256i*)(out + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    hex_encode_sse42(in + i, len - i, out + 2 * i);
+}
+
+KILN_TARGET_AVX2 static bool base64_decode_avx2(const char* in, uint64_t len, char* out) {
+    const __m256i lut_lo = _mm256_setr_epi8(KILN_BASE64_LUT_LO, KILN_BASE64_LUT_LO);
+    const __m256i lut_hi = _mm256_setr_epi8(KILN_BASE64_LUT_HI, KILN_BASE64_LUT_HI);
+    const __m256i lut_roll = _mm256_setr_epi8(KILN_BASE64_LUT_ROLL, KILN_BASE64_LUT_ROLL);
+    const __m256i pack = _mm256_setr_epi8(KILN_BASE64_PACK, KILN_BASE64_PACK);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    uint64_t i = 0;
+    uint64_t o = 0;
+
+    // 32 characters -> 24 bytes, the 32 byte store needs 8 more bytes of output after them
+    for (; i + 44 <= len; i += 32, o += 24) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi32(v, 4), nibble);
+        __m256i lo = _mm256_and_si256(v, nibble);
+        if (!_mm256_testz_si256(_mm256_shuffle_epi8(lut_lo, lo), _mm256_shuffle_epi8(lut_hi, hi))) {
+            return false;
+        }
+        __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')), hi));
+        __m256i sextets = _mm256_add_epi8(v, roll);
+        __m256i pairs = _mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x01400140));
+        __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        // 12 bytes at the start of each 128-bit lane, moved next to each other
+        __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(words, pack), _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        _mm256_storeu_si256((__m256i*)(out + o), bytes);
+    }
+    return base64_decode_sse42(in + i, len - i, out + o);
+}
+
+KILN_TARGET_AVX2 static inline __m256i hex_nibbles_avx2(__m256i v, __m256i* valid) {
+    __m256i digit = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+    __m256i letter = _mm256_sub_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+    *valid = _mm256_or_si256(is_digit, is_letter);
+    return _mm256_blendv_epi8(_mm256_add_epi8(letter, _mm256_set1_epi8(10)), digit, is_digit);
+}
+
+KILN_TARGET_AVX2 static bool hex_decode_avx2(const char* in, uint64_t len, char* out) {
+    const __m256i join = _mm256_set1_epi16(0x0110);
+    uint64_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i valid_a, valid_b;
+        __m256i a = hex_nibbles_avx2(_mm256_loadu_si256((const __m256i*)(in + 2 * i)), &valid_a);
+        __m256i b = hex_nibbles_avx2(_mm256_loadu_si256((const __m256i*)(in + 2 * i + 32)), &valid_b);
+        if ((uint32_t)_mm256_movemask_epi8(_mm256_and_si256(valid_a, valid_b)) != 0xffffffffu) {
+            return false;
+        }
+        // packus works per 128-bit lane, so put the quarters back in order
+        __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(a, join), _mm256_maddubs_epi16(b, join));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_permute4x64_epi64(bytes, 0xd8));
+    }
+    return hex_decode_sse42(in + 2 * i, len - i, out + i);
+}
+
+KILN_TARGET_AVX2 static uint64_t set_prefix_avx2(const char* p, uint64_t len, const __kiln_byte_set_t* set) {
+    const __m256i low_rows = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)set->low_rows));
+    const __m256i high_rows = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)set->high_rows));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i bit_of = _mm256_setr_epi8(
+        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    uint64_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+        __m256i lo = _mm256_and_si256(v, nibble);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+        __m256i rows = _mm256_blendv_epi8(_mm256_shuffle_epi8(low_rows, lo), _mm256_shuffle_epi8(high_rows, lo), v);
+        __m256i bit = _mm256_shuffle_epi8(bit_of, hi);
+        uint32_t hits = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(rows, bit), bit));
+        if (hits != 0) {
+            return i + (uint64_t)__builtin_ctz(hits);
+        }
+    }
+    return i + set_prefix_sse42(p + i, len - i, set);
+}
+
+const __kiln_kernels_t __kiln_kernels_avx2 = {
+    .find = find_avx2,
+    .compare = compare_avx2,
+    .to_lower = to_lower_avx2,
+    .to_upper = to_upper_avx2,
+    .space_prefix = space_prefix_avx2,
+    .space_suffix = space_suffix_avx2,
+    .ascii_prefix = ascii_prefix_avx2,
+    .hash = hash_sse42,
+    .csv_masks = csv_masks_avx2,
+    .json_clean_prefix = json_clean_prefix_avx2,
+    .json_escape_extra = json_escape_extra_avx2,
+    .base64_encode = base64_encode_avx2,
+    .hex_encode = hex_encode_avx2,
+    .base64_decode = base64_decode_avx2,
+    .hex_decode = hex_decode_avx2,
+    .set_prefix = set_prefix_avx2,
+};
+
+// ---------------------------------------------------------------------------
+// AVX-512BW (64 byte vectors, masked loads for the tails)
+
+KILN_TARGET_AVX512 static int64_t find_avx512(const char* hay, uint64_t hay_len, const char* needle, uint64_t needle_len) {
+    if (needle_len == 1 || needle_len > hay_len) {
+        return __kiln_find_scalar(hay, hay_len, needle, needle_len);
+    }
+
+    const __m512i first = _mm512_set1_epi8(needle[0]);
+    const __m512i last = _mm512_set1_epi8(needle[needle_len - 1]);
+    uint64_t waste = 0;
+    uint64_t i = 0;
+
+    for (; i + needle_len - 1 + 64 <= hay_len; i += 64) {
+        __m512i block_first = _mm512_loadu_si512((const void*)(hay + i));
+        __m512i block_last = _mm512_loadu_si512((const void*)(hay + i + needle_len - 1));
+        uint64_t mask = _mm512_cmpeq_epi8_mask(first, block_first) & _mm512_cmpeq_epi8_mask(last, block_last);
+
+        while (mask != 0) {
+            uint64_t bit = (uint64_t)__builtin_ctzll(mask);
+            if (memcmp(hay + i + bit + 1, needle + 1, needle_len - 2) == 0) {
+                return (int64_t)(i + bit);
+            }
+            waste += needle_len;
+            mask &= mask - 1;
+        }
+        if (waste > KILN_FIND_WASTE_LIMIT(i)) {
+            break;
+        }
+    }
+
+    int64_t rest = __kiln_find_scalar(hay + i, hay_len - i, needle, needle_len);
+    return rest < 0 ? -1 : (int64_t)i + rest;
+}
+
+KILN_TARGET_AVX512 static int compare_avx512(const char* a, const char* b, uint64_t len) {
+    for (uint64_t i = 0; i < len; i += 64) {
+        __mmask64 live = kiln_tail_mask64(len - i);
+        __m512i va = _mm512_maskz_loadu_epi8(live, a + i);
+        __m512i vb = _mm512_maskz_loadu_epi8(live, b + i);
+        uint64_t diff = _mm512_cmpneq_epi8_mask(va, vb);
+        if (diff != 0) {
+            uint64_t k = (uint64_t)__builtin_ctzll(diff);
+            return (int)(unsigned char)a[i + k] - (int)(unsigned char)b[i + k];
+        }
+    }
+    return 0;
+}
+
+KILN_TARGET_AVX512 static void to_lower_avx512(char* dst, const char* src, uint64_t len) {
+    const __m512i first = _mm512_set1_epi8('A');
+    const __m512i range = _mm512_set1_epi8(26);
+    const __m512i bit = _mm512_set1_epi8(0x20);
+    for (uint64_t i = 0; i < len; i += 64) {
+        __mmask64 live = kiln_tail_mask64(len - i);
+        __m512i v = _mm512_maskz_loadu_epi8(live, src + i);
+        __mmask64 upper = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(v, first), range);
+        if (dst == src) {
+            _mm512_mask_storeu_epi8(dst + i, live & upper, _mm512_add_epi8(v, bit));
+        } else {
+            _mm512_mask_storeu_epi8(dst + i, live, _mm512_mask_add_epi8(v, upper, v, bit));
+        }
+    }
+}
+
+KILN_TARGET_AVX512 static void to_upper_avx512(char* dst, const char* src, uint64_t len) {
+    const __m512i first = _mm512_set1_epi8('a');
+    const __m512i range = _mm512_set1_epi8(26);
+    const __m512i bit = _mm512_set1_epi8(0x20);
+    for (uint64_t i = 0; i < len; i += 64) {
+        __mmask64 live = kiln_tail_mask64(len - i);
+        __m512i v = _mm512_maskz_loadu_epi8(live, src + i);
+        __mmask64 lower = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(v, first), range);
+        if (dst == src) {
+            _mm512_mask_storeu_epi8(dst + i, live & lower, _mm512_sub_epi8(v, bit));
+        } else {
+            _mm512_mask_storeu_epi8(dst + i, live, _mm512_mask_sub_epi8(v, lower, v, bit));
+        }
+    }
+}
+
+KILN_TARGET_AVX512 static inline uint64_t space_mask_avx512(__m512i v) {
+    __mmask64 space = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(' '));
+    __mmask64 control = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(v, _mm512_set1_epi8('\t')), _mm512_set1_epi8('\r' - '\t' + 1));
+    return space | control;
+}
+
+KILN_TARGET_AVX512 static uint64_t space_prefix_avx512(const char* p, uint64_t len) {
+    for (uint64_t i = 0; i < len; i += 64) {
+        __mmask64 live = kiln_tail_mask64(len - i);
+        uint64_t non_ws = ~space_mask_avx512(_mm512_maskz_loadu_epi8(live, p + i)) & live;
+        if (non_ws != 0) {
+            return i + (uint64_t)__builtin_ctzll(non_ws);
+        }
+    }
+    return len;
+}
+
+KILN_TARGET_AVX512 static uint64_t space_suffix_avx512(const char* p, uint64_t len) {
+    uint64_t n = 0;
+    for (; n + 64 <= len; n += 64) {
+        uint64_t non_ws = ~space_mask_avx512(_mm512_loadu_si512((const void*)(p + len - n - 64)));
+        if (non_ws != 0) {
+            return n + (uint64_t)__builtin_clzll(non_ws);
+        }
+    }
+    return n + space_suffix_avx2(p, len - n);
+}
+
+KILN_TARGET_AVX512 static uint64_t ascii_prefix_avx512(const char* p, uint64_t len) {
+    for (uint64_t i = 0; i < len; i += 64) {
+        __mmask64 live = kiln_tail_mask64(len - i);
+        uint64_t high = _mm512_movepi8_mask(_mm512_maskz_loadu_epi8(live, p + i));
+        if (high != 0) {
+            return i + (uint64_t)__builtin_ctzll(high);
+        }
+    }
+    return len;
+}
+
+KILN_TARGET_AVX512 static uint64_t csv_masks_avx512(const char* block, char delim, uint64_t* sep_mask) {
+    __m512i v = _mm512_loadu_si512((const void*)block);
+    *sep_mask = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(delim)) | _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\n'));
+    return _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('"'));
+}
+
+KILN_TARGET_AVX512 static inline uint64_t json_needs_avx512(__m512i v, uint64_t* short_esc) {
+    uint64_t ctrl = _mm512_cmplt_epu8_mask(v, _mm512_set1_epi8(0x20));
+    uint64_t special = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('"')) | _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\\'));
+    if (short_esc != NULL) {
+        uint64_t named = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(v, _mm512_set1_epi8(8)), _mm512_set1_epi8(3))
+            | _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\f')) | _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\r'));
+        *short_esc = special | named;
+    }
+    return ctrl | special;
+}
+
+KILN_TARGET_AVX512 static uint64_t json_clean_prefix_avx512(const char* p, uint64_t len) {
+    for (uint64_t i = 0; i < len; i += 64) {
+        __mmask64 live = kiln_tail_mask64(len - i);
+        // Masked off lanes load as 0, which counts as a control byte, so mask the result too
+        uint64_t needs = json_needs_avx512(_mm512_maskz_loadu_epi8(live, p + i), NULL) & live;
+        if (needs != 0) {
+            return i + (uint64_t)__builtin_ctzll(needs);
+        }
+    }
+    return len;
+}
+
+KILN_TARGET_AVX512 static uint64_t json_escape_extra_avx512(const char* p, uint64_t len) {
+    uint64_t extra = 0;
+    for (uint64_t i = 0; i < len; i += 64) {
+        __mmask64 live = kiln_tail_mask64(len - i);
+        uint64_t short_esc;
+        uint64_t needs = json_needs_avx512(_mm512_maskz_loadu_epi8(live, p + i), &short_esc) & live;
+        short_esc &= live;
+        extra += (uint64_t)__builtin_popcountll(short_esc) + 5 * (uint64_t)__builtin_popcountll(needs & ~short_esc);
+    }
+    return extra;
+}
+
+KILN_TARGET_AVX512 static uint64_t set_prefix_avx512(const char* p, uint64_t len, const __kiln_byte_set_t* set) {
+    const __m512i low_rows = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)set->low_rows));
+    const __m512i high_rows = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)set->high_rows));
+    const __m512i nibble = _mm512_set1_epi8(0x0f);
+    const __m512i bit_of = _mm512_broadcast_i32x4(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+    for (uint64_t i = 0; i < len; i += 64) {
+        __mmask64 live = kiln_tail_mask64(len - i);
+        __m512i v = _mm512_maskz_loadu_epi8(live, p + i);
+        __m512i lo = _mm512_and_si512(v, nibble);
+        __m512i hi = _mm512_and_si512(_mm512_srli_epi16(v, 4), nibble);
+        __m512i rows = _mm512_mask_blend_epi8(_mm512_movepi8_mask(v), _mm512_shuffle_epi8(low_rows, lo), _mm512_shuffle_epi8(high_rows, lo));
+        uint64_t hits = _mm512_test_epi8_mask(rows, _mm512_shuffle_epi8(bit_of, hi)) & live;
+        if (hits != 0) {
+            return i + (uint64_t)__builtin_ctzll(hits);
+        }
+    }
+    return len;
+}
+
+const __kiln_kernels_t __kiln_kernels_avx512 = {
+    .find = find_avx512,
+    .compare = compare_avx512,
+    .to_lower = to_lower_avx512,
+    .to_upper = to_upper_avx512,
+    .space_prefix = space_prefix_avx512,
+    .space_suffix = space_suffix_avx512,
+    .ascii_prefix = ascii_prefix_avx512,
+    .hash = hash_sse42,
+    .csv_masks = csv_masks_avx512,
+    .json_clean_prefix = json_clean_prefix_avx512,
+    .json_escape_extra = json_escape_extra_avx512,
+    .base64_encode = base64_encode_avx2,
+    .hex_encode = hex_encode_avx2,
+    .base64_decode = base64_decode_avx2,
+    .hex_decode = hex_decode_avx2,
+    .set_prefix = set_prefix_avx512,
+};
+
+#endif // KILN_STRING_HAVE_X86_KERNELS
@@ -0,0 +1,48 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+/// @brief Allocates a key holding a copy of `str_ref` and its hash, in one block
+/// @param str_ref The contents
+/// @return The key, NULL if the allocation failed. Release it with `kiln_key_free`
+const kiln_key_t* kiln_key_from_kstring_ref(kstring_ref_t str_ref) {
+    if (str_ref.__length > SIZE_MAX - sizeof(kiln_key_t) - 1) {
+        return NULL;
+    }
+
+    size_t size = sizeof(kiln_key_t) + str_ref.__length + 1;
+    kiln_key_t* key = malloc(size);
+    if (key == NULL) {
+        return NULL;
+    }
+    KILN_STATS_ALLOC(size);
+
+    key->__hash = kstring_ref_hash(str_ref);
+    key->__length = str_ref.__length;
+    if (str_ref.__length > 0) {
+        memcpy(key->__bytes, str_ref.ptr, str_ref.__length);
+        KILN_STATS_COPY(str_ref.__length);
+    }
+    key->__bytes[str_ref.__length] = '\0';
+
+    return key;
+}
+
+/// @brief Allocates a key from a C-style string
+/// @param cstr The contents
+/// @return The key, NULL if the allocation failed. Release it with `kiln_key_free`
+const kiln_key_t* kiln_key_from_cstr(const char* cstr) {
+    kstring_ref_t str_ref = { .ptr = (char*)cstr, .__length = strlen(cstr) };
+    return kiln_key_from_kstring_ref(str_ref);
+}
+
+/// @brief Frees a key (NULL is ignored)
+/// @param key 
+void kiln_key_free(const kiln_key_t* key) {
+    free((void*)key);
+}
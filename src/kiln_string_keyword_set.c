@@ -0,0 +1,249 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// Minimal perfect hash built with hash-and-displace: the 64-bit hash of a key
+// picks a bucket from its high half, and each bucket stores the displacement
+// that sends all of its keys to free slots. Buckets are placed largest first.
+// A lookup is one hash, one displacement load, one length check and one memcmp.
+
+struct __kiln_keyword_slot {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t index;
+};
+
+#define KEYWORD_MAX_ATTEMPTS 32
+
+typedef struct {
+    kstring_ref_t ref;
+    uint32_t idx;
+    uint64_t hash;
+} keyword_entry_t;
+
+static inline uint32_t keyword_bucket(uint64_t hash, uint32_t n_buckets) {
+    return (uint32_t)(((hash >> 32) * n_buckets) >> 32);
+}
+
+static inline uint32_t keyword_slot(uint64_t hash, uint32_t displacement, uint32_t n_slots) {
+    uint64_t x = hash ^ ((uint64_t)displacement * 0x9e3779b97f4a7c15ull);
+    x ^= x >> 31;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 29;
+    return (uint32_t)(((x & 0xffffffffu) * n_slots) >> 32);
+}
+
+static int keyword_entry_cmp(const void* a, const void* b) {
+    const keyword_entry_t* ea = a;
+    const keyword_entry_t* eb = b;
+    int32_t result = kstring_ref_compare(ea->ref, eb->ref);
+    if (result != 0) {
+        return result;
+    }
+    return ea->idx < eb->idx ? -1 : (ea->idx > eb->idx);
+}
+
+/// @brief Tries to place every bucket with hashes from `seed`
+/// @return false if some bucket could not be placed (the caller retries with another seed)
+static bool keyword_place(kstring_keyword_set_t* set, keyword_entry_t* entries, uint32_t n, uint64_t seed,
+                          uint32_t* bucket_start, uint32_t* order, uint32_t* by_bucket, bool* taken, uint32_t* slots) {
+    uint32_t n_buckets = set->__n_buckets;
+    for (uint32_t i = 0; i < n; i++) {
+        entries[i].hash = __kiln_kernels->hash(entries[i].ref.ptr, entries[i].ref.__length, seed);
+    }
+
+    // Group the entries by bucket (counting sort)
+    memset(bucket_start, 0, (n_buckets + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < n; i++) {
+        bucket_start[keyword_bucket(entries[i].hash, n_buckets) + 1]++;
+    }
+    uint32_t max_size = 0;
+    for (uint32_t b = 0; b < n_buckets; b++) {
+        if (bucket_start[b + 1] > max_size) {
+            max_size = bucket_start[b + 1];
+        }
+        bucket_start[b + 1] += bucket_start[b];
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        by_bucket[i] = i;
+    }
+    {
+        uint32_t* fill = slots;
+        memcpy(fill, bucket_start, n_buckets * sizeof(uint32_t));
+        for (uint32_t i = 0; i < n; i++) {
+            by_bucket[fill[keyword_bucket(entries[i].hash, n_buckets)]++] = i;
+        }
+    }
+
+    // Largest buckets first, they are the hardest to place
+    uint32_t n_order = 0;
+    for (uint32_t size = max_size; size > 0; size--) {
+        for (uint32_t b = 0; b < n_buckets; b++) {
+            if (bucket_start[b + 1] - bucket_start[b] == size) {
+                order[n_order++] = b;
+            }
+        }
+    }
+
+    memset(taken, 0, n * sizeof(bool));
+    memset(set->__displacements, 0, n_buckets * sizeof(uint32_t));
+    uint32_t max_displacement = 64 * n + 1024;
+    for (uint32_t k = 0; k < n_order; k++) {
+        uint32_t b = order[k];
+        uint32_t first = bucket_start[b];
+        uint32_t size = bucket_start[b + 1] - first;
+        bool placed = false;
+
+        for (uint32_t d = 0; d < max_displacement && !placed; d++) {
+            placed = true;
+            for (uint32_t j = 0; j < size && placed; j++) {
+                uint32_t slot = keyword_slot(entries[by_bucket[first + j]].hash, d, n);
+                slots[j] = slot;
+                if (taken[slot]) {
+                    placed = false;
+                }
+                for (uint32_t prev = 0; prev < j && placed; prev++) {
+                    placed = slots[prev] != slot;
+                }
+            }
+            if (placed) {
+                set->__displacements[b] = d;
+                for (uint32_t j = 0; j < size; j++) {
+                    taken[slots[j]] = true;
+                }
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Builds a minimal perfect hash over a fixed list of keywords
+/// @param keywords The keywords, they are copied so the array may be freed afterwards
+/// @param n Number of keywords
+/// @return The set, free it with `kstring_keyword_set_free`. If it could not be built (allocation failure, or more
+/// than 2^32 bytes of keywords) it matches nothing and `kstring_keyword_set_ok` returns false
+kstring_keyword_set_t kstring_keyword_set_new(const kstring_ref_t* keywords, size_t n) {
+    kstring_keyword_set_t set = { .__seed = 0, .__displacements = NULL, .__slots = NULL, .__bytes = NULL, .__n_slots = 0, .__n_buckets = 0, .__ok = false };
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += keywords[i].__length;
+    }
+    if (n == 0) {
+        set.__ok = true;
+        return set;
+    }
+    if (n >= UINT32_MAX / 64 || total >= UINT32_MAX) {
+        return set;
+    }
+
+    // Drop duplicates, keeping the lowest index
+    keyword_entry_t* entries = malloc(n * sizeof(keyword_entry_t));
+    if (entries == NULL) {
+        return set;
+    }
+    for (size_t i = 0; i < n; i++) {
+        entries[i] = (keyword_entry_t){ .ref = keywords[i], .idx = (uint32_t)i, .hash = 0 };
+    }
+    qsort(entries, n, sizeof(keyword_entry_t), keyword_entry_cmp);
+    uint32_t n_unique = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (n_unique == 0 || kstring_ref_compare(entries[n_unique - 1].ref, entries[i].ref) != 0) {
+            entries[n_unique++] = entries[i];
+        }
+    }
+
+    uint32_t n_buckets = n_unique / 4 + 1;
+    set.__n_buckets = n_buckets;
+    set.__n_slots = n_unique;
+    set.__displacements = malloc(n_buckets * sizeof(uint32_t));
+    set.__slots = malloc(n_unique * sizeof(struct __kiln_keyword_slot));
+    set.__bytes = malloc(total > 0 ? total : 1);
+    uint32_t* bucket_start = malloc((n_buckets + 1) * sizeof(uint32_t));
+    uint32_t* order = malloc(n_buckets * sizeof(uint32_t));
+    uint32_t* by_bucket = malloc(n_unique * sizeof(uint32_t));
+    uint32_t* scratch = malloc((n_unique > n_buckets ? n_unique : n_buckets) * sizeof(uint32_t));
+    bool* taken = malloc(n_unique * sizeof(bool));
+
+    bool built = false;
+    if (set.__displacements && set.__slots && set.__bytes && bucket_start && order && by_bucket && scratch && taken) {
+        // The seed is mixed into the hash nonlinearly, so keys that can't be placed under
+        // one seed (two on the same full hash, or an unlucky bucket) almost surely can under the next
+        for (uint32_t attempt = 0; attempt < KEYWORD_MAX_ATTEMPTS && !built; attempt++) {
+            set.__seed = (attempt + 1) * 0x9e3779b97f4a7c15ull;
+            built = keyword_place(&set, entries, n_unique, set.__seed, bucket_start, order, by_bucket, taken, scratch);
+        }
+    }
+
+    if (built) {
+        set.__ok = true;
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < n_unique; i++) {
+            uint64_t hash = entries[i].hash;
+            uint32_t slot = keyword_slot(hash, set.__displacements[keyword_bucket(hash, n_buckets)], n_unique);
+            set.__slots[slot] = (struct __kiln_keyword_slot){ .offset = offset, .length = (uint32_t)entries[i].ref.__length, .index = entries[i].idx };
+            if (entries[i].ref.__length > 0) {
+                memcpy(set.__bytes + offset, entries[i].ref.ptr, entries[i].ref.__length);
+            }
+            offset += (uint32_t)entries[i].ref.__length;
+        }
+    } else {
+        kstring_keyword_set_free(&set);
+    }
+
+    free(entries);
+    free(bucket_start);
+    free(order);
+    free(by_bucket);
+    free(scratch);
+    free(taken);
+    return set;
+}
+
+/// @brief Frees the memory of a keyword set
+/// @param set 
+void kstring_keyword_set_free(kstring_keyword_set_t* set) {
+    free(set->__displacements);
+    free(set->__slots);
+    free(set->__bytes);
+    set->__displacements = NULL;
+    set->__slots = NULL;
+    set->__bytes = NULL;
+    set->__n_slots = 0;
+    set->__n_buckets = 0;
+    set->__ok = false;
+}
+
+/// @brief Tells a set that was built apart from one that failed to build
+/// @param set 
+/// @return true if `kstring_keyword_set_new` built the set (also for an empty keyword list), false if it failed
+bool kstring_keyword_set_ok(const kstring_keyword_set_t* set) {
+    return set->__ok;
+}
+
+/// @brief Looks `string` up in the set: one hash, one length check and one memcmp
+/// @param set 
+/// @param string 
+/// @return Index of the keyword in the array passed to `kstring_keyword_set_new` (the lowest one for duplicates), -1 if it is not in the set
+int64_t kstring_keyword_set_lookup(const kstring_keyword_set_t* set, kstring_ref_t string) {
+    if (set->__n_slots == 0) {
+        return -1;
+    }
+
+    uint64_t hash = __kiln_kernels->hash(string.ptr, string.__length, set->__seed);
+    uint32_t displacement = set->__displacements[keyword_bucket(hash, set->__n_buckets)];
+    const struct __kiln_keyword_slot* slot = &set->__slots[keyword_slot(hash, displacement, set->__n_slots)];
+
+    if (slot->length != string.__length || memcmp(set->__bytes + slot->offset, string.ptr, string.__length) != 0) {
+        return -1;
+    }
+    return slot->index;
+}
@@ -0,0 +1,134 @@
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/mman.h>
+#define KILN_STRING_HAVE_MREMAP 1
+#endif
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// Large-string mode: once a string needs more than the threshold its buffer
+// moves to an anonymous mapping (marked with KILN_STRING_MAPPED in __capacity),
+// and from then on it grows with mremap, which moves page table entries
+// instead of copying bytes.
+
+static _Atomic size_t map_threshold = KILN_STRING_DEFAULT_MAP_THRESHOLD;
+
+/// @brief Sets the capacity from which a growing string switches to an mmap'd buffer. 0 turns the mode off.
+/// Mapped buffers get transparent huge page advice and grow with mremap, so growing a huge string
+/// does not copy it. Applies process wide, strings that are already mapped stay mapped.
+/// Has no effect where mremap is unavailable
+/// @param bytes The threshold in bytes
+void kiln_string_set_map_threshold(size_t bytes) {
+    atomic_store_explicit(&map_threshold, bytes, memory_order_relaxed);
+}
+
+/// @brief Returns the threshold set with `kiln_string_set_map_threshold`, 0 if large-string mode is off or unsupported
+size_t kiln_string_get_map_threshold(void) {
+#ifdef KILN_STRING_HAVE_MREMAP
+    return atomic_load_explicit(&map_threshold, memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+#ifdef KILN_STRING_HAVE_MREMAP
+
+static uint64_t round_to_pages(uint64_t bytes) {
+    uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+    return (bytes + page - 1) / page * page;
+}
+
+bool __kiln_string_map_grow(kiln_string_t* string, uint64_t new_capacity) {
+    new_capacity = round_to_pages(new_capacity);
+    void* mapped;
+
+    if (string->__capacity & KILN_STRING_MAPPED) {
+        uint64_t old_capacity = __kiln_string_capacity(string);
+        mapped = mremap(string->ptr, old_capacity, new_capacity, MREMAP_MAYMOVE);
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+        KILN_STATS_REALLOC(new_capacity);
+    } else {
+        mapped = mmap(NULL, new_capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+        KILN_STATS_ALLOC(new_capacity);
+        // The last copy this string's bytes get, later growth only remaps
+        if (string->ptr != NULL) {
+            memcpy(mapped, string->ptr, string->__length);
+            KILN_STATS_COPY(string->__length);
+            free(string->ptr);
+        }
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(mapped, new_capacity, MADV_HUGEPAGE);
+#endif
+
+    string->ptr = mapped;
+    string->__capacity = new_capacity | KILN_STRING_MAPPED;
+    return true;
+}
+
+bool __kiln_string_map_shrink(kiln_string_t* string, uint64_t new_capacity) {
+    uint64_t old_capacity = __kiln_string_capacity(string);
+    uint64_t threshold = kiln_string_get_map_threshold();
+
+    if (threshold == 0 || new_capacity < threshold) {
+        // Back to the heap
+        char* heap = (char*)malloc(new_capacity);
+        if (heap == NULL) {
+            return false;
+        }
+        KILN_STATS_ALLOC(new_capacity);
+        memcpy(heap, string->ptr, new_capacity);
+        KILN_STATS_COPY(new_capacity - 1);
+        munmap(string->ptr, old_capacity);
+        string->ptr = heap;
+        string->__capacity = new_capacity;
+        return true;
+    }
+
+    // Shrinking in place never moves the mapping
+    new_capacity = round_to_pages(new_capacity);
+    if (new_capacity < old_capacity) {
+        if (mremap(string->ptr, old_capacity, new_capacity, 0) == MAP_FAILED) {
+            return false;
+        }
+        string->__capacity = new_capacity | KILN_STRING_MAPPED;
+    }
+    return true;
+}
+
+void __kiln_string_unmap(kiln_string_t* string) {
+    munmap(string->ptr, __kiln_string_capacity(string));
+}
+
+#else
+
+bool __kiln_string_map_grow(kiln_string_t* string, uint64_t new_capacity) {
+    (void)string;
+    (void)new_capacity;
+    return false;
+}
+
+bool __kiln_string_map_shrink(kiln_string_t* string, uint64_t new_capacity) {
+    (void)string;
+    (void)new_capacity;
+    return false;
+}
+
+void __kiln_string_unmap(kiln_string_t* string) {
+    (void)string;
+}
+
+#endif // KILN_STRING_HAVE_MREMAP
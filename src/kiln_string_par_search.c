@@ -0,0 +1,428 @@
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// Parallel search splits the haystack into one chunk per thread. Each chunk
+// finds the leftmost non-overlapping matches that *start* inside it, reading
+// up to `target_len - 1` bytes past its end so that matches straddling the
+// boundary are still seen. Chunks are then stitched together in order: if the
+// previous chunk's last match runs past the start of this chunk, the greedy
+// match sequence is re-scanned from the end of that match until it lines up
+// with the chunk's own sequence again.
+
+#define KSTRING_PAR_DEFAULT_SERIAL_CUTOFF ((size_t)1 << 20)
+#define KSTRING_PAR_MIN_CHUNK ((size_t)1 << 16)
+#define KSTRING_PAR_COUNT_RECORDED 64
+
+#define KSTRING_PAR_NO_MATCH UINT64_MAX
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+
+    uint64_t* positions;
+    size_t recorded;
+    size_t capacity;
+    uint64_t count;
+    uint64_t last_pos;
+    bool oom;
+} kstring_par_chunk_t;
+
+typedef struct {
+    kstring_ref_t string;
+    const char* target;
+    uint64_t target_len;
+    bool record_all;
+    kstring_par_chunk_t* chunks;
+} kstring_par_search_t;
+
+/// @brief Finds the next match at or after `pos` that starts before `start_limit`
+static inline uint64_t kstring_par_next(const kstring_par_search_t* s, uint64_t pos, uint64_t start_limit) {
+    if (pos >= start_limit) {
+        return KSTRING_PAR_NO_MATCH;
+    }
+
+    uint64_t window_end = start_limit + s->target_len - 1;
+    if (window_end > s->string.__length) {
+        window_end = s->string.__length;
+    }
+    if (window_end - pos < s->target_len) {
+        return KSTRING_PAR_NO_MATCH;
+    }
+
+    const char* found = memmem(s->string.ptr + pos, window_end - pos, s->target, s->target_len);
+    if (found == NULL) {
+        return KSTRING_PAR_NO_MATCH;
+    }
+    return (uint64_t)(found - s->string.ptr);
+}
+
+static bool kstring_par_record(kstring_par_chunk_t* chunk, uint64_t pos, bool record_all) {
+    chunk->count++;
+    chunk->last_pos = pos;
+    if (!record_all && chunk->recorded >= KSTRING_PAR_COUNT_RECORDED) {
+        return true;
+    }
+
+    if (chunk->recorded == chunk->capacity) {
+        size_t new_capacity = chunk->capacity ? chunk->capacity * 2 : 16;
+        uint64_t* grown = realloc(chunk->positions, new_capacity * sizeof(uint64_t));
+        if (grown == NULL) {
+            chunk->oom = true;
+            return false;
+        }
+        chunk->positions = grown;
+        chunk->capacity = new_capacity;
+    }
+
+    chunk->positions[chunk->recorded++] = pos;
+    return true;
+}
+
+static void kstring_par_scan_chunk(void* arg, size_t task_idx) {
+    kstring_par_search_t* s = arg;
+    kstring_par_chunk_t* chunk = &s->chunks[task_idx];
+
+    uint64_t pos = chunk->start;
+    for (;;) {
+        uint64_t found = kstring_par_next(s, pos, chunk->end);
+        if (found == KSTRING_PAR_NO_MATCH) {
+            break;
+        }
+        if (!kstring_par_record(chunk, found, s->record_all)) {
+            break;
+        }
+        pos = found + s->target_len;
+    }
+}
+
+/// @brief Re-scans a chunk from `carry` (the end of the previous accepted match) and splices
+/// in the chunk's own matches once both sequences agree
+static bool kstring_par_fixup_chunk(const kstring_par_search_t* s, kstring_par_chunk_t* chunk, uint64_t carry) {
+    kstring_par_chunk_t fixed = { .start = chunk->start, .end = chunk->end };
+
+    uint64_t pos = carry;
+    size_t j = 0;
+    for (;;) {
+        uint64_t found = kstring_par_next(s, pos, chunk->end);
+        if (found == KSTRING_PAR_NO_MATCH) {
+            break;
+        }
+
+        while (j < chunk->recorded && chunk->positions[j] < found) {
+            j++;
+        }
+
+        if (j < chunk->recorded && chunk->positions[j] == found) {
+            // Converged, everything from here on is the chunk's own sequence
+            for (size_t k = j; k < chunk->recorded; k++) {
+                if (!kstring_par_record(&fixed, chunk->positions[k], s->record_all)) {
+                    free(fixed.positions);
+                    return false;
+                }
+            }
+            fixed.count += chunk->count - chunk->recorded;
+            fixed.last_pos = chunk->last_pos;
+            break;
+        }
+
+        if (!kstring_par_record(&fixed, found, s->record_all)) {
+            free(fixed.positions);
+            return false;
+        }
+        pos = found + s->target_len;
+    }
+
+    free(chunk->positions);
+    *chunk = fixed;
+    return true;
+}
+
+static void kstring_par_search_free(kstring_par_search_t* s, size_t n_chunks) {
+    for (size_t i = 0; i < n_chunks; i++) {
+        free(s->chunks[i].positions);
+    }
+    free(s->chunks);
+    s->chunks = NULL;
+}
+
+static size_t kstring_par_chunk_count(uint64_t length, const kstring_par_config_t* config) {
+    size_t n_threads = config && config->n_threads ? config->n_threads : __kiln_parallel_thread_count();
+    size_t cutoff = config && config->serial_cutoff ? config->serial_cutoff : KSTRING_PAR_DEFAULT_SERIAL_CUTOFF;
+
+    if (length < cutoff) {
+        return 1;
+    }
+
+    uint64_t max_chunks = length / KSTRING_PAR_MIN_CHUNK;
+    if (max_chunks < 1) {
+        max_chunks = 1;
+    }
+    return n_threads < max_chunks ? n_threads : (size_t)max_chunks;
+}
+
+/// @brief Finds every leftmost non-overlapping match, split into per-chunk lists that are
+/// already stitched together, i.e. each chunk holds exactly the final matches starting inside it
+/// @return false if out of memory
+static bool kstring_par_search(kstring_par_search_t* s, size_t n_chunks) {
+    s->chunks = calloc(n_chunks, sizeof(kstring_par_chunk_t));
+    if (s->chunks == NULL) {
+        return false;
+    }
+
+    uint64_t chunk_len = s->string.__length / n_chunks;
+    for (size_t i = 0; i < n_chunks; i++) {
+        s->chunks[i].start = i * chunk_len;
+        s->chunks[i].end = i + 1 == n_chunks ? s->string.__length : (i + 1) * chunk_len;
+    }
+
+    __kiln_parallel_run(n_chunks, kstring_par_scan_chunk, s);
+
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n_chunks; i++) {
+        kstring_par_chunk_t* chunk = &s->chunks[i];
+        if (chunk->oom) {
+            kstring_par_search_free(s, n_chunks);
+            return false;
+        }
+
+        if (chunk->count > 0 && chunk->positions[0] < carry) {
+            if (!kstring_par_fixup_chunk(s, chunk, carry)) {
+                kstring_par_search_free(s, n_chunks);
+                return false;
+            }
+        }
+        if (chunk->count > 0) {
+            carry = chunk->last_pos + s->target_len;
+        }
+    }
+
+    return true;
+}
+
+/// @brief Finds every non-overlapping occurrence of `target`, scanning chunks of the string concurrently on the built-in thread pool.
+/// Matches are the same as a serial left-to-right scan would find (the same ones `kiln_string_replace` replaces)
+/// @param string The kstring_ref_t to search in
+/// @param target The substring to find
+/// @param config Thread count and serial cutoff, NULL for the defaults
+/// @param out_count Set to the number of matches found
+/// @return A malloc'd array of match offsets in ascending order that the caller must free, NULL if there are no matches or on allocation failure
+uint64_t* kstring_ref_par_find_all(kstring_ref_t string, const char* target, const kstring_par_config_t* config, size_t* out_count) {
+    *out_count = 0;
+
+    uint64_t target_len = strlen(target);
+    if (target_len == 0 || target_len > string.__length) {
+        return NULL;
+    }
+
+    kstring_par_search_t s = {
+        .string = string,
+        .target = target,
+        .target_len = target_len,
+        .record_all = true,
+    };
+
+    size_t n_chunks = kstring_par_chunk_count(string.__length, config);
+    if (!kstring_par_search(&s, n_chunks)) {
+        return NULL;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < n_chunks; i++) {
+        total += s.chunks[i].count;
+    }
+
+    uint64_t* positions = NULL;
+    if (total > 0) {
+        positions = malloc(total * sizeof(uint64_t));
+        if (positions != NULL) {
+            size_t k = 0;
+            for (size_t i = 0; i < n_chunks; i++) {
+                memcpy(positions + k, s.chunks[i].positions, s.chunks[i].count * sizeof(uint64_t));
+                k += s.chunks[i].count;
+            }
+            *out_count = total;
+        }
+    }
+
+    kstring_par_search_free(&s, n_chunks);
+    return positions;
+}
+
+/// @brief Counts the non-overlapping occurrences of `target`, scanning chunks of the string concurrently on the built-in thread pool
+/// @param string The kstring_ref_t to search in
+/// @param target The substring to count
+/// @param config Thread count and serial cutoff, NULL for the defaults
+/// @return The number of matches, 0 if `target` is empty
+uint64_t kstring_ref_par_count(kstring_ref_t string, const char* target, const kstring_par_config_t* config) {
+    uint64_t target_len = strlen(target);
+    if (target_len == 0 || target_len > string.__length) {
+        return 0;
+    }
+
+    kstring_par_search_t s = {
+        .string = string,
+        .target = target,
+        .target_len = target_len,
+        .record_all = false,
+    };
+
+    size_t n_chunks = kstring_par_chunk_count(string.__length, config);
+    if (!kstring_par_search(&s, n_chunks)) {
+        // Only the first few matches of each chunk are ever stored, so this is
+        // an allocation failure for the chunk table itself. Count serially.
+        uint64_t count = 0;
+        uint64_t pos = 0;
+        while ((pos = kstring_par_next(&s, pos, string.__length)) != KSTRING_PAR_NO_MATCH) {
+            count++;
+            pos += target_len;
+        }
+        return count;
+    }
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < n_chunks; i++) {
+        total += s.chunks[i].count;
+    }
+
+    kstring_par_search_free(&s, n_chunks);
+    return total;
+}
+
+typedef struct {
+    const kstring_par_search_t* search;
+    const char* new_s;
+    uint64_t new_len;
+    char* dst;
+    uint64_t* seg_start;
+    uint64_t* out_start;
+} kstring_par_replace_t;
+
+static void kstring_par_replace_chunk(void* arg, size_t task_idx) {
+    kstring_par_replace_t* r = arg;
+    const kstring_par_search_t* s = r->search;
+    const kstring_par_chunk_t* chunk = &s->chunks[task_idx];
+
+    const char* src = s->string.ptr;
+    char* dst = r->dst + r->out_start[task_idx];
+    uint64_t pos = r->seg_start[task_idx];
+    uint64_t end = r->seg_start[task_idx + 1];
+
+    for (size_t i = 0; i < chunk->count; i++) {
+        uint64_t match = chunk->positions[i];
+        memcpy(dst, src + pos, match - pos);
+        dst += match - pos;
+        memcpy(dst, r->new_s, r->new_len);
+        dst += r->new_len;
+        pos = match + s->target_len;
+    }
+
+    if (end > pos) {
+        memcpy(dst, src + pos, end - pos);
+    }
+}
+
+/// @brief Replaces all instances of old_s with new_s, finding matches and writing the result concurrently on the built-in thread pool.
+/// Matches are found per chunk, output offsets are prefix-summed and every thread writes its part straight into one
+/// pre-sized buffer. The result is the same as `kiln_string_replace`.
+/// @param string 
+/// @param old_s
+/// @param new_s
+/// @param config Thread count and serial cutoff, NULL for the defaults
+void kiln_string_par_replace(kiln_string_t* string, const char* old_s, const char* new_s, const kstring_par_config_t* config) {
+    const uint64_t old_len = strlen(old_s);
+    if (old_len == 0 || old_len > string->__length) {
+        return;
+    }
+
+    size_t n_chunks = kstring_par_chunk_count(string->__length, config);
+    if (n_chunks < 2) {
+        kiln_string_replace(string, old_s, new_s);
+        return;
+    }
+
+    kstring_par_search_t s = {
+        .string = kiln_string_to_kstring_ref(string),
+        .target = old_s,
+        .target_len = old_len,
+        .record_all = true,
+    };
+    if (!kstring_par_search(&s, n_chunks)) {
+        kiln_string_replace(string, old_s, new_s);
+        return;
+    }
+
+    const uint64_t new_len = strlen(new_s);
+    uint64_t* seg_start = malloc((n_chunks + 1) * sizeof(uint64_t));
+    uint64_t* out_start = malloc(n_chunks * sizeof(uint64_t));
+    if (seg_start == NULL || out_start == NULL) {
+        free(seg_start);
+        free(out_start);
+        kstring_par_search_free(&s, n_chunks);
+        kiln_string_replace(string, old_s, new_s);
+        return;
+    }
+
+    // A chunk's segment starts at its own start, or after the previous match if that runs into it
+    uint64_t carry = 0;
+    uint64_t before = 0;
+    for (size_t i = 0; i < n_chunks; i++) {
+        seg_start[i] = s.chunks[i].start > carry ? s.chunks[i].start : carry;
+        out_start[i] = seg_start[i] - before * old_len + before * new_len;
+
+        if (s.chunks[i].count > 0) {
+            carry = s.chunks[i].last_pos + old_len;
+        }
+        before += s.chunks[i].count;
+    }
+    seg_start[n_chunks] = string->__length;
+
+    if (before == 0) {
+        free(seg_start);
+        free(out_start);
+        kstring_par_search_free(&s, n_chunks);
+        return;
+    }
+
+    const uint64_t new_total_len = string->__length - before * old_len + before * new_len;
+
+    size_t new_capacity = new_total_len + 1;
+    if (new_capacity < __kiln_string_capacity(string)) {
+        new_capacity = __kiln_string_capacity(string);
+    }
+
+    char* new_buffer = (char*)malloc(new_capacity);
+    if (new_buffer != NULL) {
+        KILN_STATS_ALLOC(new_capacity);
+        KILN_STATS_SLACK(new_capacity - (new_total_len + 1));
+        KILN_STATS_COPY(new_total_len);
+
+        kstring_par_replace_t r = {
+            .search = &s,
+            .new_s = new_s,
+            .new_len = new_len,
+            .dst = new_buffer,
+            .seg_start = seg_start,
+            .out_start = out_start,
+        };
+        __kiln_parallel_run(n_chunks, kstring_par_replace_chunk, &r);
+
+        new_buffer[new_total_len] = '\0';
+
+        kiln_string_free(string);
+        string->ptr = new_buffer;
+        string->__length = new_total_len;
+        string->__capacity = new_capacity;
+    }
+
+    free(seg_start);
+    free(out_start);
+    kstring_par_search_free(&s, n_chunks);
+}
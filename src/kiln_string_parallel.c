@@ -0,0 +1,339 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// A fork-join pool with range stealing. A job is a range of task indices that
+// starts out split evenly between the threads; each thread takes tasks from the
+// front of its own range and, once it runs dry, steals the back half of another
+// thread's range. A range is a single atomic word (begin in the low 32 bits, end
+// in the high 32 bits), so taking and stealing are one CAS each.
+//
+// Only one job runs on a pool at a time. Calls made from inside a task, or while
+// another job is running, execute serially on the calling thread.
+
+#define POOL_MAX_TASKS UINT32_MAX
+
+typedef struct {
+    _Alignas(64) _Atomic uint64_t range;
+} pool_queue_t;
+
+typedef struct {
+    kiln_pool_t* pool;
+    size_t index;
+} pool_worker_t;
+
+struct kiln_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t work_cv;
+    pthread_cond_t done_cv;
+    pthread_mutex_t submit_lock;
+
+    pthread_t* threads;
+    pool_worker_t* workers;
+    size_t n_workers;
+    uint64_t generation;
+    size_t active_workers;
+    bool shutdown;
+
+    __kiln_task_fn_t fn;
+    void* ctx;
+    // One per worker plus one (index 0) for the thread that submitted the job
+    pool_queue_t* queues;
+};
+
+static _Thread_local bool pool_in_task = false;
+
+static pthread_once_t default_pool_once = PTHREAD_ONCE_INIT;
+static kiln_pool_t* default_pool = NULL;
+
+static inline uint64_t pool_range(uint64_t begin, uint64_t end) {
+    return end << 32 | begin;
+}
+
+/// @brief Takes the first task of queue `self`
+/// @return false if the queue is empty
+static bool pool_pop(pool_queue_t* self, size_t* task) {
+    uint64_t range = atomic_load_explicit(&self->range, memory_order_relaxed);
+    for (;;) {
+        uint64_t begin = range & 0xffffffffu;
+        uint64_t end = range >> 32;
+        if (begin >= end) {
+            return false;
+        }
+        if (atomic_compare_exchange_weak_explicit(&self->range, &range, pool_range(begin + 1, end),
+                                                  memory_order_acq_rel, memory_order_relaxed)) {
+            *task = begin;
+            return true;
+        }
+    }
+}
+
+/// @brief Moves the back half of some other thread's range into queue `index`
+/// @return false if every other range was empty
+static bool pool_steal(kiln_pool_t* pool, size_t index) {
+    size_t n_queues = pool->n_workers + 1;
+    for (size_t k = 1; k < n_queues; k++) {
+        pool_queue_t* victim = &pool->queues[(index + k) % n_queues];
+        uint64_t range = atomic_load_explicit(&victim->range, memory_order_relaxed);
+        for (;;) {
+            uint64_t begin = range & 0xffffffffu;
+            uint64_t end = range >> 32;
+            if (begin >= end) {
+                break;
+            }
+            uint64_t mid = begin + (end - begin) / 2;
+            if (atomic_compare_exchange_weak_explicit(&victim->range, &range, pool_range(begin, mid),
+                                                      memory_order_acq_rel, memory_order_relaxed)) {
+                // Our own range is empty and thieves leave empty ranges alone, so a plain store is enough
+                atomic_store_explicit(&pool->queues[index].range, pool_range(mid, end), memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/// @brief Runs tasks from queue `index`, stealing when it runs dry, until no work is left to steal
+static void pool_drain(kiln_pool_t* pool, size_t index) {
+    pool_queue_t* self = &pool->queues[index];
+    size_t task;
+    for (;;) {
+        while (pool_pop(self, &task)) {
+            pool->fn(pool->ctx, task);
+        }
+        // Work taken by a thief that has not stored it yet is invisible here,
+        // but that thief runs it itself, so nothing is lost by leaving
+        if (!pool_steal(pool, index)) {
+            break;
+        }
+    }
+}
+
+static void* pool_worker(void* arg) {
+    pool_worker_t* worker = arg;
+    kiln_pool_t* pool = worker->pool;
+    pool_in_task = true;
+    uint64_t seen = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->shutdown) {
+            pthread_cond_wait(&pool->work_cv, &pool->lock);
+        }
+        if (pool->shutdown) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        pool_drain(pool, worker->index);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->active_workers--;
+        if (pool->active_workers == 0) {
+            pthread_cond_signal(&pool->done_cv);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    return NULL;
+}
+
+static size_t pool_cpu_count(void) {
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return n_cpus < 1 ? 1 : (size_t)n_cpus;
+}
+
+/// @brief Creates a work-stealing thread pool
+/// @param n_threads Number of threads that run tasks, including the one that submits a job; 0 to use every core
+/// @return The pool, free it with `kiln_pool_free`. NULL on allocation failure (NULL is accepted everywhere as the built-in pool)
+kiln_pool_t* kiln_pool_new(size_t n_threads) {
+    if (n_threads == 0) {
+        n_threads = pool_cpu_count();
+    }
+
+    kiln_pool_t* pool = malloc(sizeof(kiln_pool_t));
+    if (pool == NULL) {
+        return NULL;
+    }
+    size_t n_workers = n_threads - 1;
+    pool->threads = malloc((n_workers > 0 ? n_workers : 1) * sizeof(pthread_t));
+    pool->workers = malloc((n_workers > 0 ? n_workers : 1) * sizeof(pool_worker_t));
+    pool->queues = aligned_alloc(_Alignof(pool_queue_t), n_threads * sizeof(pool_queue_t));
+    if (pool->threads == NULL || pool->workers == NULL || pool->queues == NULL) {
+        free(pool->threads);
+        free(pool->workers);
+        free(pool->queues);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+    pthread_mutex_init(&pool->submit_lock, NULL);
+    pool->n_workers = 0;
+    pool->generation = 0;
+    pool->active_workers = 0;
+    pool->shutdown = false;
+    pool->fn = NULL;
+    pool->ctx = NULL;
+    for (size_t i = 0; i < n_threads; i++) {
+        atomic_init(&pool->queues[i].range, 0);
+    }
+
+    // Workers only look at `n_workers` while running a job, which can't start before this returns
+    for (size_t i = 0; i < n_workers; i++) {
+        pool->workers[i] = (pool_worker_t){ .pool = pool, .index = i + 1 };
+        if (pthread_create(&pool->threads[i], NULL, pool_worker, &pool->workers[i]) != 0) {
+            break;
+        }
+        pool->n_workers++;
+    }
+
+    return pool;
+}
+
+/// @brief Stops the threads of a pool and frees it. Must not be called while a job is running on it
+/// @param pool The pool, NULL does nothing (the built-in pool is never freed)
+void kiln_pool_free(kiln_pool_t* pool) {
+    if (pool == NULL || pool == default_pool) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 0; i < pool->n_workers; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_cv);
+    pthread_cond_destroy(&pool->done_cv);
+    pthread_mutex_destroy(&pool->submit_lock);
+    free(pool->threads);
+    free(pool->workers);
+    free(pool->queues);
+    free(pool);
+}
+
+static void default_pool_init(void) {
+    default_pool = kiln_pool_new(pool_cpu_count());
+}
+
+/// @brief Returns `pool`, or the built-in pool (started on first use) if it is NULL
+static kiln_pool_t* pool_resolve(kiln_pool_t* pool) {
+    if (pool != NULL) {
+        return pool;
+    }
+    pthread_once(&default_pool_once, default_pool_init);
+    return default_pool;
+}
+
+/// @brief Returns the number of threads that run tasks on `pool` (workers + the submitting thread)
+/// @param pool The pool, NULL for the built-in one
+/// @return Always at least 1
+size_t kiln_pool_thread_count(kiln_pool_t* pool) {
+    pool = pool_resolve(pool);
+    return pool != NULL ? pool->n_workers + 1 : 1;
+}
+
+void __kiln_pool_run(kiln_pool_t* pool, size_t n_tasks, __kiln_task_fn_t fn, void* ctx) {
+    if (n_tasks == 0) {
+        return;
+    }
+
+    pool = pool_resolve(pool);
+
+    if (pool == NULL || n_tasks == 1 || n_tasks > POOL_MAX_TASKS || pool->n_workers == 0 || pool_in_task
+        || pthread_mutex_trylock(&pool->submit_lock) != 0) {
+        for (size_t i = 0; i < n_tasks; i++) {
+            fn(ctx, i);
+        }
+        return;
+    }
+
+    size_t n_queues = pool->n_workers + 1;
+    for (size_t i = 0; i < n_queues; i++) {
+        uint64_t begin = (uint64_t)n_tasks * i / n_queues;
+        uint64_t end = (uint64_t)n_tasks * (i + 1) / n_queues;
+        atomic_store_explicit(&pool->queues[i].range, pool_range(begin, end), memory_order_relaxed);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->active_workers = pool->n_workers;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    pool_in_task = true;
+    pool_drain(pool, 0);
+    pool_in_task = false;
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->active_workers != 0) {
+        pthread_cond_wait(&pool->done_cv, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_mutex_unlock(&pool->submit_lock);
+}
+
+size_t __kiln_parallel_thread_count(void) {
+    return kiln_pool_thread_count(NULL);
+}
+
+void __kiln_parallel_run(size_t n_tasks, __kiln_task_fn_t fn, void* ctx) {
+    __kiln_pool_run(NULL, n_tasks, fn, ctx);
+}
+
+typedef struct {
+    size_t n;
+    size_t grain;
+    kiln_range_fn_t fn;
+    void* ctx;
+} parallel_for_ctx_t;
+
+static void parallel_for_task(void* arg, size_t task_idx) {
+    parallel_for_ctx_t* p = arg;
+    size_t begin = task_idx * p->grain;
+    size_t end = p->n - begin > p->grain ? begin + p->grain : p->n;
+    p->fn(p->ctx, begin, end);
+}
+
+/// @brief Calls `fn(ctx, begin, end)` over consecutive ranges covering [0, n), running them concurrently on `pool`,
+/// and waits for all of them. Idle threads steal ranges from busy ones, so uneven ranges balance out.
+/// @param pool The pool, NULL for the built-in one
+/// @param n Number of items
+/// @param grain Items per range, 0 to pick one from `n` and the thread count
+/// @param fn Called once per range; ranges never overlap
+/// @param ctx Passed through to `fn`
+void kiln_string_parallel_for(kiln_pool_t* pool, size_t n, size_t grain, kiln_range_fn_t fn, void* ctx) {
+    if (n == 0) {
+        return;
+    }
+    if (grain == 0) {
+        grain = n / (kiln_pool_thread_count(pool) * 16);
+    }
+    if (grain == 0) {
+        grain = 1;
+    }
+    if ((n - 1) / grain >= POOL_MAX_TASKS) {
+        grain = (n - 1) / (POOL_MAX_TASKS - 1) + 1;
+    }
+
+    parallel_for_ctx_t p = { .n = n, .grain = grain, .fn = fn, .ctx = ctx };
+    __kiln_pool_run(pool, (n - 1) / grain + 1, parallel_for_task, &p);
+}
@@ -0,0 +1,191 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// Bulk transforms over arrays of strings. The array is cut into chunks of about
+// the same number of bytes (plus a fixed cost per string), not the same number
+// of strings, so a few huge strings don't end up in one thread's share. Every
+// result is written at the index of its input, so the output never depends on
+// how the chunks were scheduled.
+
+#define PARALLEL_MAP_MIN_CHUNK_BYTES (16 * 1024)
+#define PARALLEL_MAP_CHUNKS_PER_THREAD 8
+#define PARALLEL_MAP_ITEM_COST 64
+
+typedef struct {
+    size_t* bounds;
+    kiln_string_t* strings;
+    const kstring_ref_t* refs;
+    kiln_string_map_fn_t string_fn;
+    kstring_ref_map_fn_t ref_fn;
+    void* ctx;
+} parallel_map_t;
+
+static void parallel_map_task(void* arg, size_t task_idx) {
+    parallel_map_t* m = arg;
+    size_t end = m->bounds[task_idx + 1];
+    if (m->strings != NULL) {
+        for (size_t i = m->bounds[task_idx]; i < end; i++) {
+            m->string_fn(&m->strings[i], i, m->ctx);
+        }
+    } else {
+        for (size_t i = m->bounds[task_idx]; i < end; i++) {
+            m->ref_fn(m->refs[i], i, m->ctx);
+        }
+    }
+}
+
+static inline uint64_t parallel_map_length(const parallel_map_t* m, size_t i) {
+    return m->strings != NULL ? m->strings[i].__length : m->refs[i].__length;
+}
+
+/// @brief Splits [0, n) into chunks of roughly equal byte weight and runs them on `pool`
+static void parallel_map_run(kiln_pool_t* pool, parallel_map_t* m, size_t n) {
+    if (n == 0) {
+        return;
+    }
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += parallel_map_length(m, i) + PARALLEL_MAP_ITEM_COST;
+    }
+
+    size_t n_threads = kiln_pool_thread_count(pool);
+    uint64_t target = total / (n_threads * PARALLEL_MAP_CHUNKS_PER_THREAD);
+    if (target < PARALLEL_MAP_MIN_CHUNK_BYTES) {
+        target = PARALLEL_MAP_MIN_CHUNK_BYTES;
+    }
+
+    size_t max_chunks = total / target + 1;
+    size_t* bounds = n_threads > 1 && total >= 2 * target ? malloc((max_chunks + 1) * sizeof(size_t)) : NULL;
+    if (bounds == NULL) {
+        size_t serial[2] = { 0, n };
+        m->bounds = serial;
+        parallel_map_task(m, 0);
+        return;
+    }
+
+    // A chunk closes once it reaches `target`, so there are at most total / target + 1 of them
+    size_t n_chunks = 0;
+    uint64_t weight = 0;
+    bounds[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        weight += parallel_map_length(m, i) + PARALLEL_MAP_ITEM_COST;
+        if (weight >= target && i + 1 < n) {
+            bounds[++n_chunks] = i + 1;
+            weight = 0;
+        }
+    }
+    bounds[++n_chunks] = n;
+
+    m->bounds = bounds;
+    __kiln_pool_run(pool, n_chunks, parallel_map_task, m);
+    free(bounds);
+}
+
+/// @brief Calls `fn(&strings[i], i, ctx)` for every string, concurrently on `pool`.
+/// Work is split by byte size, so arrays mixing short and very long strings still balance.
+/// @param pool The pool, NULL for the built-in one
+/// @param strings The strings, each one is only ever touched by the call for its own index
+/// @param n Number of strings
+/// @param fn The transform
+/// @param ctx Passed through to `fn`
+void kiln_string_parallel_map(kiln_pool_t* pool, kiln_string_t* strings, size_t n, kiln_string_map_fn_t fn, void* ctx) {
+    parallel_map_t m = { .bounds = NULL, .strings = strings, .refs = NULL, .string_fn = fn, .ref_fn = NULL, .ctx = ctx };
+    parallel_map_run(pool, &m, n);
+}
+
+/// @brief Calls `fn(refs[i], i, ctx)` for every ref, concurrently on `pool`. Write results to index `i` of an
+/// output array to keep them in input order.
+/// @param pool The pool, NULL for the built-in one
+/// @param refs The strings
+/// @param n Number of strings
+/// @param fn The transform
+/// @param ctx Passed through to `fn`
+void kstring_ref_parallel_map(kiln_pool_t* pool, const kstring_ref_t* refs, size_t n, kstring_ref_map_fn_t fn, void* ctx) {
+    parallel_map_t m = { .bounds = NULL, .strings = NULL, .refs = refs, .string_fn = NULL, .ref_fn = fn, .ctx = ctx };
+    parallel_map_run(pool, &m, n);
+}
+
+static void map_to_ascii_lower(kiln_string_t* string, size_t index, void* ctx) {
+    (void)index;
+    (void)ctx;
+    kiln_string_to_ascii_lower(string);
+}
+
+static void map_to_ascii_upper(kiln_string_t* string, size_t index, void* ctx) {
+    (void)index;
+    (void)ctx;
+    kiln_string_to_ascii_upper(string);
+}
+
+static void map_trim_inplace(kiln_string_t* string, size_t index, void* ctx) {
+    (void)index;
+    (void)ctx;
+    kiln_string_trim_inplace(string);
+}
+
+// The patterns are measured once for the whole array, not once per string
+typedef struct {
+    kstring_ref_t old_s;
+    kstring_ref_t new_s;
+} map_replace_t;
+
+static void map_replace(kiln_string_t* string, size_t index, void* ctx) {
+    (void)index;
+    map_replace_t* r = ctx;
+    kiln_string_replace_ref(string, r->old_s, r->new_s);
+}
+
+static void map_hash(kstring_ref_t ref, size_t index, void* ctx) {
+    uint64_t* out = ctx;
+    out[index] = kstring_ref_hash(ref);
+}
+
+/// @brief `kiln_string_to_ascii_lower` on every string, concurrently on `pool`
+/// @param pool The pool, NULL for the built-in one
+/// @param strings
+/// @param n Number of strings
+void kiln_string_parallel_to_ascii_lower(kiln_pool_t* pool, kiln_string_t* strings, size_t n) {
+    kiln_string_parallel_map(pool, strings, n, map_to_ascii_lower, NULL);
+}
+
+/// @brief `kiln_string_to_ascii_upper` on every string, concurrently on `pool`
+/// @param pool The pool, NULL for the built-in one
+/// @param strings
+/// @param n Number of strings
+void kiln_string_parallel_to_ascii_upper(kiln_pool_t* pool, kiln_string_t* strings, size_t n) {
+    kiln_string_parallel_map(pool, strings, n, map_to_ascii_upper, NULL);
+}
+
+/// @brief `kiln_string_trim_inplace` on every string, concurrently on `pool`
+/// @param pool The pool, NULL for the built-in one
+/// @param strings
+/// @param n Number of strings
+void kiln_string_parallel_trim_inplace(kiln_pool_t* pool, kiln_string_t* strings, size_t n) {
+    kiln_string_parallel_map(pool, strings, n, map_trim_inplace, NULL);
+}
+
+/// @brief `kiln_string_replace` on every string, concurrently on `pool`
+/// @param pool The pool, NULL for the built-in one
+/// @param strings
+/// @param n Number of strings
+/// @param old_s
+/// @param new_s
+void kiln_string_parallel_replace(kiln_pool_t* pool, kiln_string_t* strings, size_t n, const char* old_s, const char* new_s) {
+    map_replace_t r = { .old_s = kstring_ref_from_cstr((char*)old_s), .new_s = kstring_ref_from_cstr((char*)new_s) };
+    kiln_string_parallel_map(pool, strings, n, map_replace, &r);
+}
+
+/// @brief `kstring_ref_hash` of every ref, concurrently on `pool`
+/// @param pool The pool, NULL for the built-in one
+/// @param refs
+/// @param n Number of strings
+/// @param out Receives the n hashes, `out[i]` is the hash of `refs[i]`
+void kstring_ref_parallel_hash(kiln_pool_t* pool, const kstring_ref_t* refs, size_t n, uint64_t* out) {
+    kstring_ref_parallel_map(pool, refs, n, map_hash, out);
+}
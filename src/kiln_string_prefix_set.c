@@ -0,0 +1,229 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// The set is a byte trie flattened into three arrays. The edges of a node are
+// stored next to each other: their labels in `__labels` (searched with memchr)
+// and the matching child node ids in `__children`. A match walks at most one
+// edge per input byte, so it is linear in the input whatever the number of
+// prefixes. Suffix sets are the same trie built over the reversed strings and
+// walked from the end of the input.
+
+struct __kiln_trie_node {
+    uint32_t first_edge;
+    uint32_t n_edges;
+    // Index of the prefix that ends at this node, -1 if none
+    int32_t match;
+};
+
+typedef struct {
+    kstring_ref_t ref;
+    uint32_t idx;
+} prefix_entry_t;
+
+typedef struct {
+    uint32_t node;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t depth;
+} build_item_t;
+
+static int prefix_entry_cmp(const void* a, const void* b) {
+    const prefix_entry_t* pa = a;
+    const prefix_entry_t* pb = b;
+    int32_t result = kstring_ref_compare(pa->ref, pb->ref);
+    if (result != 0) {
+        return result;
+    }
+    return pa->idx < pb->idx ? -1 : (pa->idx > pb->idx);
+}
+
+static kstring_prefix_set_t prefix_set_build(const kstring_ref_t* strings, size_t n, bool suffix) {
+    kstring_prefix_set_t set = { .__nodes = NULL, .__labels = NULL, .__children = NULL, .__n_nodes = 0, .__suffix = suffix };
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += strings[i].__length;
+    }
+    if (n > INT32_MAX || total >= UINT32_MAX) {
+        return set;
+    }
+
+    prefix_entry_t* entries = malloc((n > 0 ? n : 1) * sizeof(prefix_entry_t));
+    char* reversed = suffix ? malloc(total > 0 ? total : 1) : NULL;
+    set.__nodes = malloc((total + 1) * sizeof(struct __kiln_trie_node));
+    set.__labels = malloc(total > 0 ? total : 1);
+    set.__children = malloc((total > 0 ? total : 1) * sizeof(uint32_t));
+    build_item_t* queue = malloc((total + 1) * sizeof(build_item_t));
+    if (entries == NULL || (suffix && reversed == NULL) || set.__nodes == NULL || set.__labels == NULL || set.__children == NULL || queue == NULL) {
+        free(entries);
+        free(reversed);
+        free(queue);
+        kstring_prefix_set_free(&set);
+        return set;
+    }
+
+    uint64_t offset = 0;
+    for (size_t i = 0; i < n; i++) {
+        entries[i].ref = strings[i];
+        entries[i].idx = (uint32_t)i;
+        if (suffix) {
+            for (uint64_t j = 0; j < strings[i].__length; j++) {
+                reversed[offset + j] = strings[i].ptr[strings[i].__length - 1 - j];
+            }
+            entries[i].ref.ptr = reversed + offset;
+            offset += strings[i].__length;
+        }
+    }
+    qsort(entries, n, sizeof(prefix_entry_t), prefix_entry_cmp);
+
+    // Breadth first, so every node's edges are appended in one go and end up contiguous
+    uint32_t n_nodes = 1;
+    uint32_t n_edges = 0;
+    size_t q_head = 0, q_tail = 0;
+    queue[q_tail++] = (build_item_t){ .node = 0, .lo = 0, .hi = (uint32_t)n, .depth = 0 };
+
+    while (q_head < q_tail) {
+        build_item_t item = queue[q_head++];
+        struct __kiln_trie_node* node = &set.__nodes[item.node];
+        node->match = -1;
+        node->first_edge = n_edges;
+        node->n_edges = 0;
+
+        // Strings ending here sort first; duplicates keep the lowest index
+        uint32_t i = item.lo;
+        while (i < item.hi && entries[i].ref.__length == item.depth) {
+            if (node->match < 0 || (int32_t)entries[i].idx < node->match) {
+                node->match = (int32_t)entries[i].idx;
+            }
+            i++;
+        }
+
+        while (i < item.hi) {
+            char label = entries[i].ref.ptr[item.depth];
+            uint32_t group_end = i + 1;
+            while (group_end < item.hi && entries[group_end].ref.ptr[item.depth] == label) {
+                group_end++;
+            }
+
+            uint32_t child = n_nodes++;
+            set.__labels[n_edges] = label;
+            set.__children[n_edges] = child;
+            n_edges++;
+            node->n_edges++;
+            queue[q_tail++] = (build_item_t){ .node = child, .lo = i, .hi = group_end, .depth = item.depth + 1 };
+
+            i = group_end;
+        }
+    }
+
+    set.__n_nodes = n_nodes;
+    free(entries);
+    free(reversed);
+    free(queue);
+    return set;
+}
+
+/// @brief Walks the trie over `string` (from the end for suffix sets) and returns the deepest match, or the first one if `first_only`
+static int64_t prefix_set_walk(const kstring_prefix_set_t* set, kstring_ref_t string, bool first_only) {
+    if (set->__nodes == NULL) {
+        return -1;
+    }
+
+    const struct __kiln_trie_node* nodes = set->__nodes;
+    const struct __kiln_trie_node* node = &nodes[0];
+    int64_t best = node->match;
+    if (best >= 0 && first_only) {
+        return best;
+    }
+
+    for (uint64_t i = 0; i < string.__length; i++) {
+        char c = set->__suffix ? string.ptr[string.__length - 1 - i] : string.ptr[i];
+        const char* labels = set->__labels + node->first_edge;
+        const char* edge = node->n_edges > 0 ? memchr(labels, c, node->n_edges) : NULL;
+        if (edge == NULL) {
+            break;
+        }
+
+        node = &nodes[set->__children[node->first_edge + (uint32_t)(edge - labels)]];
+        if (node->match >= 0) {
+            best = node->match;
+            if (first_only) {
+                break;
+            }
+        }
+    }
+
+    return best;
+}
+
+/// @brief Compiles a list of prefixes into a set that `kstring_prefix_set_match_*` can test in one pass
+/// @param prefixes The prefixes, they are copied so the array may be freed afterwards
+/// @param n Number of prefixes
+/// @return The set, free it with `kstring_prefix_set_free`. An empty set matches nothing (also the result on allocation failure)
+kstring_prefix_set_t kstring_prefix_set_new(const kstring_ref_t* prefixes, size_t n) {
+    return prefix_set_build(prefixes, n, false);
+}
+
+/// @brief Compiles a list of suffixes into a set (a prefix set over the reversed strings)
+/// @param suffixes The suffixes, they are copied so the array may be freed afterwards
+/// @param n Number of suffixes
+/// @return The set, free it with `kstring_suffix_set_free`
+kstring_suffix_set_t kstring_suffix_set_new(const kstring_ref_t* suffixes, size_t n) {
+    return prefix_set_build(suffixes, n, true);
+}
+
+/// @brief Frees the memory of a prefix set
+/// @param set 
+void kstring_prefix_set_free(kstring_prefix_set_t* set) {
+    free(set->__nodes);
+    free(set->__labels);
+    free(set->__children);
+    set->__nodes = NULL;
+    set->__labels = NULL;
+    set->__children = NULL;
+    set->__n_nodes = 0;
+}
+
+/// @brief Frees the memory of a suffix set
+/// @param set 
+void kstring_suffix_set_free(kstring_suffix_set_t* set) {
+    kstring_prefix_set_free(set);
+}
+
+/// @brief Finds the longest prefix in the set that `string` starts with
+/// @param set 
+/// @param string 
+/// @return Index of that prefix in the array passed to `kstring_prefix_set_new` (the lowest one for duplicates), -1 if none matches
+int64_t kstring_prefix_set_match_longest(const kstring_prefix_set_t* set, kstring_ref_t string) {
+    return prefix_set_walk(set, string, false);
+}
+
+/// @brief Checks if `string` starts with any prefix in the set. Stops at the first (shortest) match
+/// @param set 
+/// @param string 
+/// @return true if some prefix matches
+bool kstring_prefix_set_match_any(const kstring_prefix_set_t* set, kstring_ref_t string) {
+    return prefix_set_walk(set, string, true) >= 0;
+}
+
+/// @brief Finds the longest suffix in the set that `string` ends with
+/// @param set 
+/// @param string 
+/// @return Index of that suffix in the array passed to `kstring_suffix_set_new`, -1 if none matches
+int64_t kstring_suffix_set_match_longest(const kstring_suffix_set_t* set, kstring_ref_t string) {
+    return prefix_set_walk(set, string, false);
+}
+
+/// @brief Checks if `string` ends with any suffix in the set
+/// @param set 
+/// @param string 
+/// @return true if some suffix matches
+bool kstring_suffix_set_match_any(const kstring_suffix_set_t* set, kstring_ref_t string) {
+    return prefix_set_walk(set, string, true) >= 0;
+}
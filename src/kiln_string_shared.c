@@ -0,0 +1,215 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// Control block of a kiln_shared_string_t. The string is embedded so that
+// `kiln_shared_string_make_mut` can hand it to the regular kiln_string_* API.
+struct __kiln_shared_block {
+    atomic_size_t refcount;
+    kiln_string_t string;
+};
+
+static kiln_shared_string_t shared_from_owned(kiln_string_t string) {
+    kiln_shared_string_t shared = { .__block = NULL };
+    if (string.ptr == NULL) {
+        return shared;
+    }
+
+    struct __kiln_shared_block* block = malloc(sizeof(*block));
+    if (block == NULL) {
+        kiln_string_free(&string);
+        return shared;
+    }
+
+    atomic_init(&block->refcount, 1);
+    block->string = string;
+    shared.__block = block;
+    return shared;
+}
+
+/// @brief Creates a shared string holding a copy of `str_ref`
+/// @param str_ref The contents
+/// @return A handle with a use count of 1 (its block is NULL if the allocation failed)
+kiln_shared_string_t kiln_shared_string_from_kstring_ref(kstring_ref_t str_ref) {
+    return shared_from_owned(kiln_string_from_kstring_ref(str_ref));
+}
+
+/// @brief Creates a shared string from a C-style string
+/// @param cstr The contents
+/// @return A handle with a use count of 1
+kiln_shared_string_t kiln_shared_string_from_cstr(const char* cstr) {
+    return shared_from_owned(kiln_string_from_cstr(cstr));
+}
+
+/// @brief Moves a kiln_string_t into a new shared string without copying its buffer
+/// @param string The string to take over, its pointer is set to NULL
+/// @return A handle with a use count of 1
+kiln_shared_string_t kiln_shared_string_from_kiln_string(kiln_string_t* string) {
+    kiln_string_t owned = *string;
+    string->ptr = NULL;
+    string->__length = 0;
+    string->__capacity = 0;
+    return shared_from_owned(owned);
+}
+
+/// @brief Returns a new handle to the same buffer (no copy, only the count is incremented)
+/// @param shared The handle to clone
+/// @return The new handle, free it with `kiln_shared_string_free`
+kiln_shared_string_t kiln_shared_string_clone(const kiln_shared_string_t* shared) {
+    if (shared->__block != NULL) {
+        // The caller already holds a reference, so nothing needs to be ordered here
+        atomic_fetch_add_explicit(&shared->__block->refcount, 1, memory_order_relaxed);
+    }
+    return *shared;
+}
+
+/// @brief Releases a handle, the buffer is freed with the last one. Sets the handle to NULL
+/// @param shared 
+void kiln_shared_string_free(kiln_shared_string_t* shared) {
+    struct __kiln_shared_block* block = shared->__block;
+    shared->__block = NULL;
+    if (block == NULL) {
+        return;
+    }
+
+    // Release our writes to the buffer; the thread that drops the last reference
+    // acquires everyone else's before freeing it
+    if (atomic_fetch_sub_explicit(&block->refcount, 1, memory_order_acq_rel) == 1) {
+        kiln_string_free(&block->string);
+        free(block);
+    }
+}
+
+/// @brief Returns a view of the shared buffer. It stays valid until this handle is mutated or freed
+/// @param shared 
+/// @return The contents, NUL terminated
+kstring_ref_t kiln_shared_string_view(const kiln_shared_string_t* shared) {
+    if (shared->__block == NULL) {
+        return (kstring_ref_t){ .ptr = NULL, .__length = 0 };
+    }
+    return kiln_string_to_kstring_ref(&shared->__block->string);
+}
+
+/// @brief Returns the number of handles sharing this buffer
+/// @param shared 
+/// @return 0 for a freed handle
+size_t kiln_shared_string_use_count(const kiln_shared_string_t* shared) {
+    if (shared->__block == NULL) {
+        return 0;
+    }
+    return atomic_load_explicit(&shared->__block->refcount, memory_order_acquire);
+}
+
+/// @brief Gives this handle a buffer nobody else sees (copying it if it is shared) and returns it,
+/// so any kiln_string_* function can be used to modify it. The pointer is valid until the handle is freed.
+/// @param shared 
+/// @return The private kiln_string_t, NULL if the copy could not be allocated
+kiln_string_t* kiln_shared_string_make_mut(kiln_shared_string_t* shared) {
+    struct __kiln_shared_block* block = shared->__block;
+    if (block == NULL) {
+        return NULL;
+    }
+
+    // A count of 1 can't go up behind our back: only holders of a handle can clone it
+    if (atomic_load_explicit(&block->refcount, memory_order_acquire) == 1) {
+        return &block->string;
+    }
+
+    kiln_shared_string_t copy = kiln_shared_string_from_kstring_ref(kiln_string_to_kstring_ref(&block->string));
+    if (copy.__block == NULL) {
+        return NULL;
+    }
+    kiln_shared_string_free(shared);
+    *shared = copy;
+    return &copy.__block->string;
+}
+
+/// @brief Copy-on-write version of `kiln_string_push_kstring_ref`
+/// @param shared 
+/// @param str_ref 
+void kiln_shared_string_push_kstring_ref(kiln_shared_string_t* shared, kstring_ref_t str_ref) {
+    if (str_ref.__length == 0) {
+        return;
+    }
+    kiln_string_t* string = kiln_shared_string_make_mut(shared);
+    if (string != NULL) {
+        kiln_string_push_kstring_ref(string, str_ref);
+    }
+}
+
+/// @brief Copy-on-write version of `kiln_string_push_cstr`
+/// @param shared 
+/// @param cstr 
+void kiln_shared_string_push_cstr(kiln_shared_string_t* shared, const char* cstr) {
+    kstring_ref_t str_ref = { .ptr = (char*)cstr, .__length = strlen(cstr) };
+    kiln_shared_string_push_kstring_ref(shared, str_ref);
+}
+
+/// @brief Copy-on-write version of `kiln_string_replace`. Nothing is copied if `old_s` does not occur
+/// @param shared 
+/// @param old_s
+/// @param new_s
+void kiln_shared_string_replace(kiln_shared_string_t* shared, const char* old_s, const char* new_s) {
+    if (old_s[0] == '\0' || kstring_ref_find(kiln_shared_string_view(shared), old_s) < 0) {
+        return;
+    }
+    kiln_string_t* string = kiln_shared_string_make_mut(shared);
+    if (string != NULL) {
+        kiln_string_replace(string, old_s, new_s);
+    }
+}
+
+/// @brief Copy-on-write version of `kiln_string_trim_inplace`. Nothing is copied if there is no whitespace to remove
+/// @param shared 
+void kiln_shared_string_trim_inplace(kiln_shared_string_t* shared) {
+    kstring_ref_t view = kiln_shared_string_view(shared);
+    if (view.ptr == NULL || kstring_ref_trim(view).__length == view.__length) {
+        return;
+    }
+    kiln_string_t* string = kiln_shared_string_make_mut(shared);
+    if (string != NULL) {
+        kiln_string_trim_inplace(string);
+    }
+}
+
+/// @brief Copy-on-write version of `kiln_string_to_ascii_lower`
+/// @param shared 
+void kiln_shared_string_to_ascii_lower(kiln_shared_string_t* shared) {
+    kiln_string_t* string = kiln_shared_string_make_mut(shared);
+    if (string != NULL) {
+        kiln_string_to_ascii_lower(string);
+    }
+}
+
+/// @brief Copy-on-write version of `kiln_string_to_ascii_upper`
+/// @param shared 
+void kiln_shared_string_to_ascii_upper(kiln_shared_string_t* shared) {
+    kiln_string_t* string = kiln_shared_string_make_mut(shared);
+    if (string != NULL) {
+        kiln_string_to_ascii_upper(string);
+    }
+}
+
+/// @brief Copy-on-write version of `kiln_string_to_unicode_lower`
+/// @param shared 
+void kiln_shared_string_to_unicode_lower(kiln_shared_string_t* shared) {
+    kiln_string_t* string = kiln_shared_string_make_mut(shared);
+    if (string != NULL) {
+        kiln_string_to_unicode_lower(string);
+    }
+}
+
+/// @brief Copy-on-write version of `kiln_string_to_unicode_upper`
+/// @param shared 
+void kiln_shared_string_to_unicode_upper(kiln_shared_string_t* shared) {
+    kiln_string_t* string = kiln_shared_string_make_mut(shared);
+    if (string != NULL) {
+        kiln_string_to_unicode_upper(string);
+    }
+}
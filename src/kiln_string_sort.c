@@ -0,0 +1,413 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// Sorting works on an array of entries that cache the next 8 bytes of each
+// string as a big-endian integer, so that most comparisons are a single
+// integer compare and never touch the string bytes. Equal keys are resolved
+// multikey-quicksort style by moving on to the next 8 bytes.
+
+#define KSTRING_SORT_INSERTION_THRESHOLD 16
+#define KSTRING_SORT_PARALLEL_MIN_PER_THREAD 16384
+
+typedef struct {
+    uint64_t key;
+    kstring_ref_t ref;
+    size_t idx;
+} kstring_sort_entry_t;
+
+typedef struct {
+    size_t start;
+    size_t n;
+    uint64_t depth;
+} kstring_sort_range_t;
+
+/// @brief Loads bytes [depth, depth + 8) of a string as a big-endian integer, zero padded past the end
+static inline uint64_t kstring_sort_key(kstring_ref_t ref, uint64_t depth) {
+    if (depth >= ref.__length) {
+        return 0;
+    }
+
+    const unsigned char* p = (const unsigned char*)ref.ptr + depth;
+    uint64_t remaining = ref.__length - depth;
+    if (remaining > 8) {
+        remaining = 8;
+    }
+
+    uint64_t key = 0;
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (remaining == 8) {
+        memcpy(&key, p, 8);
+        return __builtin_bswap64(key);
+    }
+#endif
+    for (uint64_t i = 0; i < remaining; i++) {
+        key |= (uint64_t)p[i] << (56 - 8 * i);
+    }
+    return key;
+}
+
+/// @brief Full comparison of two entries whose keys were loaded at `depth`
+static inline int kstring_sort_entry_cmp(const kstring_sort_entry_t* a, const kstring_sort_entry_t* b, uint64_t depth, bool stable) {
+    if (a->key != b->key) {
+        return a->key < b->key ? -1 : 1;
+    }
+
+    uint64_t skip = depth + 8;
+    uint64_t a_rem = a->ref.__length > skip ? a->ref.__length - skip : 0;
+    uint64_t b_rem = b->ref.__length > skip ? b->ref.__length - skip : 0;
+    uint64_t min_rem = a_rem < b_rem ? a_rem : b_rem;
+
+    if (min_rem > 0) {
+        int result = memcmp(a->ref.ptr + skip, b->ref.ptr + skip, min_rem);
+        if (result != 0) {
+            return result;
+        }
+    }
+
+    if (a->ref.__length != b->ref.__length) {
+        return a->ref.__length < b->ref.__length ? -1 : 1;
+    }
+
+    if (stable && a->idx != b->idx) {
+        return a->idx < b->idx ? -1 : 1;
+    }
+    return 0;
+}
+
+static void kstring_sort_insertion(kstring_sort_entry_t* e, size_t n, uint64_t depth, bool stable) {
+    for (size_t i = 1; i < n; i++) {
+        kstring_sort_entry_t tmp = e[i];
+        size_t j = i;
+        while (j > 0 && kstring_sort_entry_cmp(&tmp, &e[j - 1], depth, stable) < 0) {
+            e[j] = e[j - 1];
+            j--;
+        }
+        e[j] = tmp;
+    }
+}
+
+static inline void kstring_sort_swap(kstring_sort_entry_t* a, kstring_sort_entry_t* b) {
+    kstring_sort_entry_t tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+static inline uint64_t kstring_sort_median3(uint64_t a, uint64_t b, uint64_t c) {
+    if (a < b) {
+        if (b < c) return b;
+        return a < c ? c : a;
+    }
+    if (a < c) return a;
+    return b < c ? c : b;
+}
+
+static int kstring_sort_length_cmp(const void* a, const void* b) {
+    const kstring_sort_entry_t* ea = a;
+    const kstring_sort_entry_t* eb = b;
+    if (ea->ref.__length != eb->ref.__length) {
+        return ea->ref.__length < eb->ref.__length ? -1 : 1;
+    }
+    return 0;
+}
+
+static int kstring_sort_length_idx_cmp(const void* a, const void* b) {
+    int result = kstring_sort_length_cmp(a, b);
+    if (result != 0) {
+        return result;
+    }
+    const kstring_sort_entry_t* ea = a;
+    const kstring_sort_entry_t* eb = b;
+    return ea->idx < eb->idx ? -1 : (ea->idx > eb->idx);
+}
+
+/// @brief Sorts a group of entries that all share the same key at `depth`.
+/// Strings that end inside this 8 byte window are prefixes of every longer string in the
+/// group, so they go first ordered by length. The rest continue at depth + 8.
+/// @return Number of entries that still need sorting (they are moved to the back)
+static size_t kstring_sort_split_equal(kstring_sort_entry_t* e, size_t n, uint64_t depth, bool stable) {
+    uint64_t limit = depth + 8;
+    size_t ended = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (e[i].ref.__length <= limit) {
+            kstring_sort_swap(&e[ended], &e[i]);
+            ended++;
+        }
+    }
+
+    if (ended > 1) {
+        qsort(e, ended, sizeof(kstring_sort_entry_t), stable ? kstring_sort_length_idx_cmp : kstring_sort_length_cmp);
+    }
+
+    for (size_t i = ended; i < n; i++) {
+        e[i].key = kstring_sort_key(e[i].ref, limit);
+    }
+
+    return n - ended;
+}
+
+/// @brief Multikey quicksort over `e`, keys must already be loaded at depth 0
+/// @return false if the work stack could not be allocated
+static bool kstring_sort_entries(kstring_sort_entry_t* e, size_t n, bool stable) {
+    size_t stack_capacity = 64;
+    size_t stack_len = 0;
+    kstring_sort_range_t* stack = malloc(stack_capacity * sizeof(kstring_sort_range_t));
+    if (stack == NULL) {
+        return false;
+    }
+
+    stack[stack_len++] = (kstring_sort_range_t){ .start = 0, .n = n, .depth = 0 };
+
+    while (stack_len > 0) {
+        kstring_sort_range_t range = stack[--stack_len];
+        kstring_sort_entry_t* base = e + range.start;
+
+        if (range.n <= KSTRING_SORT_INSERTION_THRESHOLD) {
+            kstring_sort_insertion(base, range.n, range.depth, stable);
+            continue;
+        }
+
+        uint64_t pivot = kstring_sort_median3(base[0].key, base[range.n / 2].key, base[range.n - 1].key);
+
+        size_t lt = 0;
+        size_t i = 0;
+        size_t gt = range.n;
+        while (i < gt) {
+            if (base[i].key < pivot) {
+                kstring_sort_swap(&base[lt++], &base[i++]);
+            } else if (base[i].key > pivot) {
+                kstring_sort_swap(&base[i], &base[--gt]);
+            } else {
+                i++;
+            }
+        }
+
+        size_t remaining = kstring_sort_split_equal(base + lt, gt - lt, range.depth, stable);
+
+        if (stack_len + 3 > stack_capacity) {
+            stack_capacity *= 2;
+            kstring_sort_range_t* grown = realloc(stack, stack_capacity * sizeof(kstring_sort_range_t));
+            if (grown == NULL) {
+                free(stack);
+                return false;
+            }
+            stack = grown;
+        }
+
+        if (lt > 1) {
+            stack[stack_len++] = (kstring_sort_range_t){ range.start, lt, range.depth };
+        }
+        if (range.n - gt > 1) {
+            stack[stack_len++] = (kstring_sort_range_t){ range.start + gt, range.n - gt, range.depth };
+        }
+        if (remaining > 1) {
+            stack[stack_len++] = (kstring_sort_range_t){ range.start + gt - remaining, remaining, range.depth + 8 };
+        }
+    }
+
+    free(stack);
+    return true;
+}
+
+static int kstring_sort_qsort_cmp(const void* a, const void* b) {
+    return kstring_ref_compare(*(const kstring_ref_t*)a, *(const kstring_ref_t*)b);
+}
+
+static int kstring_sort_qsort_stable_cmp(const void* a, const void* b) {
+    const kstring_sort_entry_t* ea = a;
+    const kstring_sort_entry_t* eb = b;
+    int result = kstring_ref_compare(ea->ref, eb->ref);
+    if (result != 0) {
+        return result;
+    }
+    return ea->idx < eb->idx ? -1 : (ea->idx > eb->idx);
+}
+
+static kstring_sort_entry_t* kstring_sort_load(const kstring_ref_t* refs, size_t n) {
+    kstring_sort_entry_t* e = malloc(n * sizeof(kstring_sort_entry_t));
+    if (e == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < n; i++) {
+        e[i].ref = refs[i];
+        e[i].idx = i;
+        e[i].key = kstring_sort_key(refs[i], 0);
+    }
+    return e;
+}
+
+static void kstring_sort_impl(kstring_ref_t* refs, size_t n, bool stable) {
+    if (n < 2) {
+        return;
+    }
+
+    kstring_sort_entry_t* e = kstring_sort_load(refs, n);
+    if (e != NULL && kstring_sort_entries(e, n, stable)) {
+        for (size_t i = 0; i < n; i++) {
+            refs[i] = e[i].ref;
+        }
+        free(e);
+        return;
+    }
+
+    // Out of memory for the key cache, fall back to a plain comparison sort
+    if (e != NULL && stable) {
+        for (size_t i = 0; i < n; i++) {
+            e[i].ref = refs[i];
+            e[i].idx = i;
+        }
+        qsort(e, n, sizeof(kstring_sort_entry_t), kstring_sort_qsort_stable_cmp);
+        for (size_t i = 0; i < n; i++) {
+            refs[i] = e[i].ref;
+        }
+    } else {
+        qsort(refs, n, sizeof(kstring_ref_t), kstring_sort_qsort_cmp);
+    }
+    free(e);
+}
+
+/// @brief Sorts an array of kstring_ref_t lexicographically (same order as `kstring_ref_compare`)
+/// @param refs The array to sort in place
+/// @param n Number of elements in `refs`
+void kstring_ref_sort(kstring_ref_t* refs, size_t n) {
+    kstring_sort_impl(refs, n, false);
+}
+
+/// @brief Sorts an array of kstring_ref_t lexicographically, keeping equal strings in their original order
+/// @param refs The array to sort in place
+/// @param n Number of elements in `refs`
+void kstring_ref_sort_stable(kstring_ref_t* refs, size_t n) {
+    kstring_sort_impl(refs, n, true);
+}
+
+/// @brief Sorts an array of kstring_ref_t and removes duplicates, keeping the first occurrence of each string
+/// @param refs The array to sort in place
+/// @param n Number of elements in `refs`
+/// @return The number of unique strings, which are stored in `refs[0..return)`
+size_t kstring_ref_sort_unique(kstring_ref_t* refs, size_t n) {
+    if (n < 2) {
+        return n;
+    }
+
+    kstring_sort_impl(refs, n, true);
+
+    size_t out = 1;
+    for (size_t i = 1; i < n; i++) {
+        if (!kstring_ref_equals(refs[out - 1], refs[i])) {
+            refs[out++] = refs[i];
+        }
+    }
+    return out;
+}
+
+typedef struct {
+    kstring_sort_entry_t* src;
+    kstring_sort_entry_t* dst;
+    size_t n;
+    size_t run;
+} kstring_sort_parallel_ctx_t;
+
+static void kstring_sort_parallel_chunk(void* arg, size_t task_idx) {
+    kstring_sort_parallel_ctx_t* ctx = arg;
+    size_t start = task_idx * ctx->run;
+    if (start >= ctx->n) {
+        return;
+    }
+    size_t n = ctx->n - start < ctx->run ? ctx->n - start : ctx->run;
+    kstring_sort_entry_t* e = ctx->src + start;
+
+    if (!kstring_sort_entries(e, n, false)) {
+        // Cannot report an error from here, so sort the chunk with plain comparisons
+        qsort(e, n, sizeof(kstring_sort_entry_t), kstring_sort_qsort_stable_cmp);
+    }
+
+    // Keys are left at whatever depth each group finished at, the merge needs depth 0
+    for (size_t i = 0; i < n; i++) {
+        e[i].key = kstring_sort_key(e[i].ref, 0);
+    }
+}
+
+static void kstring_sort_parallel_merge(void* arg, size_t task_idx) {
+    kstring_sort_parallel_ctx_t* ctx = arg;
+    size_t start = task_idx * 2 * ctx->run;
+    if (start >= ctx->n) {
+        return;
+    }
+
+    size_t mid = start + ctx->run < ctx->n ? start + ctx->run : ctx->n;
+    size_t end = mid + ctx->run < ctx->n ? mid + ctx->run : ctx->n;
+
+    size_t i = start;
+    size_t j = mid;
+    size_t k = start;
+    while (i < mid && j < end) {
+        if (kstring_sort_entry_cmp(&ctx->src[j], &ctx->src[i], 0, false) < 0) {
+            ctx->dst[k++] = ctx->src[j++];
+        } else {
+            ctx->dst[k++] = ctx->src[i++];
+        }
+    }
+    memcpy(&ctx->dst[k], &ctx->src[i], (mid - i) * sizeof(kstring_sort_entry_t));
+    k += mid - i;
+    memcpy(&ctx->dst[k], &ctx->src[j], (end - j) * sizeof(kstring_sort_entry_t));
+}
+
+/// @brief Sorts an array of kstring_ref_t lexicographically using the built-in thread pool.
+/// The array is split into one run per thread, the runs are sorted concurrently and then merged pairwise.
+/// Small arrays are sorted on the calling thread.
+/// @param refs The array to sort in place
+/// @param n Number of elements in `refs`
+/// @param n_threads Number of runs to sort concurrently, 0 to use every core
+void kstring_ref_sort_parallel(kstring_ref_t* refs, size_t n, size_t n_threads) {
+    if (n_threads == 0) {
+        n_threads = __kiln_parallel_thread_count();
+    }
+    if (n_threads > n / KSTRING_SORT_PARALLEL_MIN_PER_THREAD) {
+        n_threads = n / KSTRING_SORT_PARALLEL_MIN_PER_THREAD;
+    }
+    if (n_threads < 2) {
+        kstring_ref_sort(refs, n);
+        return;
+    }
+
+    kstring_sort_entry_t* e = kstring_sort_load(refs, n);
+    kstring_sort_entry_t* tmp = malloc(n * sizeof(kstring_sort_entry_t));
+    if (e == NULL || tmp == NULL) {
+        free(e);
+        free(tmp);
+        kstring_ref_sort(refs, n);
+        return;
+    }
+
+    kstring_sort_parallel_ctx_t ctx = {
+        .src = e,
+        .dst = tmp,
+        .n = n,
+        .run = (n + n_threads - 1) / n_threads,
+    };
+
+    __kiln_parallel_run(n_threads, kstring_sort_parallel_chunk, &ctx);
+
+    while (ctx.run < n) {
+        size_t n_pairs = (n + 2 * ctx.run - 1) / (2 * ctx.run);
+        __kiln_parallel_run(n_pairs, kstring_sort_parallel_merge, &ctx);
+
+        kstring_sort_entry_t* swap = ctx.src;
+        ctx.src = ctx.dst;
+        ctx.dst = swap;
+        ctx.run *= 2;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        refs[i] = ctx.src[i].ref;
+    }
+
+    free(e);
+    free(tmp);
+}
@@ -0,0 +1,28 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+#ifdef KILN_STRING_STATS
+_Thread_local kiln_string_stats_t __kiln_string_stats;
+#endif
+
+/// @brief Returns the calling thread's allocation and copy counters
+/// @return All zeros unless the library was compiled with -DKILN_STRING_STATS
+kiln_string_stats_t kiln_string_stats_snapshot(void) {
+#ifdef KILN_STRING_STATS
+    return __kiln_string_stats;
+#else
+    kiln_string_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+#endif
+}
+
+/// @brief Resets the calling thread's allocation and copy counters to zero
+void kiln_string_stats_reset(void) {
+#ifdef KILN_STRING_STATS
+    memset(&__kiln_string_stats, 0, sizeof(__kiln_string_stats));
+#endif
+}
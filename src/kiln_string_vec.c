@@ -0,0 +1,168 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// A kiln_string_vec_t keeps every string's bytes back to back in one kiln_string_t
+// (so the blob gets the usual growth policy and the mmap path for huge columns)
+// and a separate array of offsets, with string i at [offsets[i], offsets[i + 1]).
+// This is the Arrow variable-size binary layout: two allocations in total instead
+// of one per string, and scans walk both arrays front to back.
+
+/// @brief Creates an empty string vector with room for `n_strings` strings totalling `n_bytes` bytes
+/// @param n_strings Number of strings to reserve room for
+/// @param n_bytes Total bytes to reserve room for
+/// @return The vector, free it with `kiln_string_vec_free`
+kiln_string_vec_t kiln_string_vec_with_capacity(size_t n_strings, size_t n_bytes) {
+    kiln_string_vec_t vec = {
+        .__data = kiln_string_with_capacity(n_bytes + 1),
+        .__offsets = malloc((n_strings + 1) * sizeof(uint64_t)),
+        .__count = 0,
+        .__offsets_capacity = n_strings + 1,
+    };
+
+    if (vec.__data.ptr != NULL) {
+        vec.__data.ptr[0] = '\0';
+    }
+    if (vec.__offsets == NULL) {
+        vec.__offsets_capacity = 0;
+    } else {
+        KILN_STATS_ALLOC((n_strings + 1) * sizeof(uint64_t));
+        vec.__offsets[0] = 0;
+    }
+    return vec;
+}
+
+/// @brief Creates an empty string vector
+/// @return The vector, free it with `kiln_string_vec_free`
+kiln_string_vec_t kiln_string_vec_new(void) {
+    return kiln_string_vec_with_capacity(0, 0);
+}
+
+/// @brief Frees the memory of a string vector
+/// @param vec
+void kiln_string_vec_free(kiln_string_vec_t* vec) {
+    kiln_string_free(&vec->__data);
+    free(vec->__offsets);
+    vec->__data.ptr = NULL;
+    vec->__data.__length = 0;
+    vec->__data.__capacity = 0;
+    vec->__offsets = NULL;
+    vec->__count = 0;
+    vec->__offsets_capacity = 0;
+}
+
+/// @brief Removes every string but keeps the allocated memory
+/// @param vec
+void kiln_string_vec_clear(kiln_string_vec_t* vec) {
+    vec->__count = 0;
+    vec->__data.__length = 0;
+}
+
+/// @brief Grows the offsets array so that it has room for `min_strings` strings
+static bool vec_grow_offsets(kiln_string_vec_t* vec, uint64_t min_strings) {
+    uint64_t min_capacity = min_strings + 1;
+    if (min_capacity <= vec->__offsets_capacity) {
+        return true;
+    }
+
+    uint64_t new_capacity = vec->__offsets_capacity * 2;
+    if (new_capacity < min_capacity) {
+        new_capacity = min_capacity;
+    }
+    uint64_t* grown = realloc(vec->__offsets, new_capacity * sizeof(uint64_t));
+    if (grown == NULL) {
+        return false;
+    }
+    KILN_STATS_REALLOC(new_capacity * sizeof(uint64_t));
+    KILN_STATS_GROWTH();
+
+    if (vec->__offsets_capacity == 0) {
+        grown[0] = 0;
+    }
+    vec->__offsets = grown;
+    vec->__offsets_capacity = new_capacity;
+    return true;
+}
+
+/// @brief Makes room for `n_strings` more strings totalling `n_bytes` more bytes, so that many pushes don't reallocate
+/// @param vec
+/// @param n_strings Number of strings that will be pushed
+/// @param n_bytes Total bytes that will be pushed
+/// @return false if an allocation failed
+bool kiln_string_vec_reserve(kiln_string_vec_t* vec, uint64_t n_strings, uint64_t n_bytes) {
+    return vec_grow_offsets(vec, vec->__count + n_strings)
+        && kiln_string_reserve(&vec->__data, n_bytes);
+}
+
+/// @brief Appends a copy of `string` to the end of the vector
+/// @param vec
+/// @param string The bytes to append
+void kiln_string_vec_push(kiln_string_vec_t* vec, kstring_ref_t string) {
+    if (!vec_grow_offsets(vec, vec->__count + 1)
+        || !__kiln_string_grow(&vec->__data, vec->__data.__length + string.__length + 1)) {
+        return;
+    }
+
+    if (string.__length > 0) {
+        memcpy(vec->__data.ptr + vec->__data.__length, string.ptr, string.__length);
+        KILN_STATS_COPY(string.__length);
+    }
+    vec->__data.__length += string.__length;
+    vec->__data.ptr[vec->__data.__length] = '\0';
+    vec->__offsets[++vec->__count] = vec->__data.__length;
+}
+
+/// @brief Appends every remaining piece of a split to the vector. The blob is grown once up front,
+/// since the pieces are never longer than the string being split
+/// @param vec
+/// @param iter The split, it is exhausted afterwards
+/// @return The number of strings appended
+uint64_t kiln_string_vec_push_split(kiln_string_vec_t* vec, kstring_split_iter_t* iter) {
+    if (!iter->__done) {
+        kiln_string_reserve(&vec->__data, iter->__rest.__length);
+    }
+
+    uint64_t count = 0;
+    kstring_ref_t piece;
+    while (kstring_split_iter_next(iter, &piece)) {
+        kiln_string_vec_push(vec, piece);
+        count++;
+    }
+    return count;
+}
+
+/// @brief Finds the first string equal to `string`, scanning the vector front to back.
+/// Lengths come from the offsets array, so only strings of the right length are compared
+/// @param vec
+/// @param string The string to look for
+/// @return Its index, -1 if it is not in the vector
+int64_t kiln_string_vec_index_of(const kiln_string_vec_t* vec, kstring_ref_t string) {
+    const uint64_t* offsets = vec->__offsets;
+    for (uint64_t i = 0; i < vec->__count; i++) {
+        if (offsets[i + 1] - offsets[i] == string.__length
+            && memcmp(vec->__data.ptr + offsets[i], string.ptr, string.__length) == 0) {
+            return (int64_t)i;
+        }
+    }
+    return -1;
+}
+
+/// @brief Writes the offsets as 32-bit values, for the Arrow utf8/binary layout (the native one is large_utf8)
+/// @param vec
+/// @param out Receives `kiln_string_vec_len(vec) + 1` offsets
+/// @return false (and nothing is written) if the blob is larger than INT32_MAX bytes
+bool kiln_string_vec_export_offsets32(const kiln_string_vec_t* vec, uint32_t* out) {
+    if (vec->__data.__length > INT32_MAX) {
+        return false;
+    }
+    out[0] = 0;
+    for (uint64_t i = 1; i <= vec->__count; i++) {
+        out[i] = (uint32_t)vec->__offsets[i];
+    }
+    return true;
+}
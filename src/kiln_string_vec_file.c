@@ -0,0 +1,247 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../include/kiln_string.h"
+#include "kiln_string_internal.h"
+
+// On-disk string vectors. The file is the in-memory layout of a kiln_string_vec_t
+// behind a fixed header, so a reader maps it and uses the offsets and the blob
+// where they are:
+//
+//   [0, 64)                 header (native byte order, checked via byte_order)
+//   [64, 64 + 8 * (n + 1))  uint64_t offsets, the first one is 0
+//   [data_pos, + data_len)  the blob, data_pos is the next multiple of 64
+//
+// The checksum is kstring_ref_hash_seeded over the offsets, chained into the
+// same hash over the blob.
+
+#define VEC_FILE_MAGIC "KILNSVEC"
+#define VEC_FILE_VERSION 1
+#define VEC_FILE_BYTE_ORDER 0x01020304u
+#define VEC_FILE_ALIGN 64
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    // VEC_FILE_BYTE_ORDER in the producer's byte order, so files from a host of the other endianness are rejected
+    uint32_t byte_order;
+    uint64_t count;
+    uint64_t offsets_pos;
+    uint64_t data_pos;
+    uint64_t data_len;
+    uint64_t checksum;
+    uint64_t reserved;
+} vec_file_header_t;
+
+_Static_assert(sizeof(vec_file_header_t) == VEC_FILE_ALIGN, "the offsets start right after the header");
+
+static inline uint64_t vec_file_align(uint64_t pos) {
+    return (pos + VEC_FILE_ALIGN - 1) & ~(uint64_t)(VEC_FILE_ALIGN - 1);
+}
+
+static uint64_t vec_file_checksum(const uint64_t* offsets, uint64_t count, const char* data, uint64_t data_len) {
+    kstring_ref_t offsets_ref = { .ptr = (char*)offsets, .__length = (count + 1) * sizeof(uint64_t) };
+    kstring_ref_t data_ref = { .ptr = (char*)data, .__length = data_len };
+    return kstring_ref_hash_seeded(data_ref, kstring_ref_hash_seeded(offsets_ref, VEC_FILE_VERSION));
+}
+
+/// @brief Writes a string vector to `path` in a format `kiln_string_vec_view_open` maps without parsing:
+/// a 64 byte header (magic, version, counts, checksum), the offsets array and the blob, each 64 byte aligned.
+/// An existing file is replaced atomically: the bytes go to a temporary file next to it that is renamed
+/// over `path` once complete, so views of the old file stay valid and readers never see a partial file
+/// @param vec The vector to save
+/// @param path Where to write it
+/// @return false on I/O error, errno tells why
+bool kiln_string_vec_save(const kiln_string_vec_t* vec, const char* path) {
+    static const uint64_t empty_offsets[1] = { 0 };
+    static const char padding[VEC_FILE_ALIGN] = { 0 };
+
+    // A vector whose first allocation failed has no offsets array
+    const uint64_t* offsets = vec->__offsets != NULL ? vec->__offsets : empty_offsets;
+    uint64_t count = vec->__offsets != NULL ? vec->__count : 0;
+    uint64_t data_len = vec->__data.__length;
+    uint64_t offsets_len = (count + 1) * sizeof(uint64_t);
+
+    vec_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, VEC_FILE_MAGIC, sizeof(header.magic));
+    header.version = VEC_FILE_VERSION;
+    header.byte_order = VEC_FILE_BYTE_ORDER;
+    header.count = count;
+    header.offsets_pos = sizeof(vec_file_header_t);
+    header.data_pos = vec_file_align(header.offsets_pos + offsets_len);
+    header.data_len = data_len;
+    header.checksum = vec_file_checksum(offsets, count, vec->__data.ptr, data_len);
+
+    // Rewriting the file in place would pull the pages out from under anyone who has it mapped (SIGBUS),
+    // so the new file is written beside it and swapped in with rename
+    size_t path_len = strlen(path);
+    char* tmp_path = malloc(path_len + sizeof(".XXXXXX"));
+    if (tmp_path == NULL) {
+        return false;
+    }
+    memcpy(tmp_path, path, path_len);
+    memcpy(tmp_path + path_len, ".XXXXXX", sizeof(".XXXXXX"));
+    int fd = mkostemp(tmp_path, O_CLOEXEC);
+    if (fd < 0) {
+        free(tmp_path);
+        return false;
+    }
+
+    // One writev for the whole file
+    kstring_ref_t parts[4] = {
+        { .ptr = (char*)&header, .__length = sizeof(header) },
+        { .ptr = (char*)offsets, .__length = offsets_len },
+        { .ptr = (char*)padding, .__length = header.data_pos - header.offsets_pos - offsets_len },
+        { .ptr = vec->__data.ptr, .__length = data_len },
+    };
+    bool ok = fchmod(fd, 0644) == 0 && kiln_write_refs(fd, parts, 4) && fsync(fd) == 0;
+
+    if (close(fd) != 0) {
+        ok = false;
+    }
+    if (ok && rename(tmp_path, path) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        int saved_errno = errno;
+        unlink(tmp_path);
+        errno = saved_errno;
+    }
+    free(tmp_path);
+    return ok;
+}
+
+/// @brief Checks the header and points `view` at the offsets and the blob inside `bytes`
+static bool vec_file_view_bytes(kiln_string_vec_view_t* view, const char* bytes, uint64_t size, bool verify) {
+    if (size < sizeof(vec_file_header_t) || ((uintptr_t)bytes & (_Alignof(uint64_t) - 1)) != 0) {
+        return false;
+    }
+
+    vec_file_header_t header;
+    memcpy(&header, bytes, sizeof(header));
+    if (memcmp(header.magic, VEC_FILE_MAGIC, sizeof(header.magic)) != 0
+        || header.version != VEC_FILE_VERSION
+        || header.byte_order != VEC_FILE_BYTE_ORDER
+        || header.offsets_pos != sizeof(vec_file_header_t)) {
+        return false;
+    }
+
+    // Every size is checked against the file before anything is multiplied or added to it
+    uint64_t max_count = (size - header.offsets_pos) / sizeof(uint64_t);
+    if (header.count >= max_count) {
+        return false;
+    }
+    uint64_t offsets_end = header.offsets_pos + (header.count + 1) * sizeof(uint64_t);
+    if (header.data_pos != vec_file_align(offsets_end) || header.data_pos > size
+        || header.data_len > size - header.data_pos) {
+        return false;
+    }
+
+    const uint64_t* offsets = (const uint64_t*)(bytes + header.offsets_pos);
+    const char* data = bytes + header.data_pos;
+    if (offsets[0] != 0 || offsets[header.count] != header.data_len) {
+        return false;
+    }
+
+    if (verify) {
+        for (uint64_t i = 0; i < header.count; i++) {
+            if (offsets[i] > offsets[i + 1]) {
+                return false;
+            }
+        }
+        if (vec_file_checksum(offsets, header.count, data, header.data_len) != header.checksum) {
+            return false;
+        }
+    }
+
+    view->__data = data;
+    view->__offsets = offsets;
+    view->__count = header.count;
+    return true;
+}
+
+/// @brief Maps a file written by `kiln_string_vec_save` and gives access to its strings in place.
+/// Nothing is parsed or copied; the pages are read in on first access
+/// @param view Set to the view, close it with `kiln_string_vec_view_close`
+/// @param path The file to map
+/// @param verify Also check that the offsets are in order and that the checksum matches, which reads the
+/// whole file. Without it only the header is checked, so the file must come from a trusted writer
+/// @return false if the file could not be mapped or is not a valid string vector file
+bool kiln_string_vec_view_open(kiln_string_vec_view_t* view, const char* path, bool verify) {
+    *view = (kiln_string_vec_view_t){ .__data = NULL, .__offsets = NULL, .__count = 0, .__map = NULL, .__map_len = 0 };
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(vec_file_header_t)) {
+        close(fd);
+        return false;
+    }
+
+    uint64_t size = (uint64_t)st.st_size;
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    if (!vec_file_view_bytes(view, map, size, verify)) {
+        munmap(map, size);
+        return false;
+    }
+    view->__map = map;
+    view->__map_len = size;
+    return true;
+}
+
+/// @brief Gives access to the strings of a `kiln_string_vec_save` file that is already in memory
+/// (read into a buffer, or mapped by the caller). The view borrows `bytes`, which must outlive it
+/// @param view Set to the view
+/// @param bytes The whole file, 8 byte aligned
+/// @param verify See `kiln_string_vec_view_open`
+/// @return false if `bytes` is not a valid string vector file
+bool kiln_string_vec_view_from_buffer(kiln_string_vec_view_t* view, kstring_ref_t bytes, bool verify) {
+    *view = (kiln_string_vec_view_t){ .__data = NULL, .__offsets = NULL, .__count = 0, .__map = NULL, .__map_len = 0 };
+    return vec_file_view_bytes(view, bytes.ptr, bytes.__length, verify);
+}
+
+/// @brief Unmaps a view opened with `kiln_string_vec_view_open`. Refs taken from it become invalid
+/// @param view
+void kiln_string_vec_view_close(kiln_string_vec_view_t* view) {
+    if (view->__map != NULL) {
+        munmap(view->__map, view->__map_len);
+    }
+    *view = (kiln_string_vec_view_t){ .__data = NULL, .__offsets = NULL, .__count = 0, .__map = NULL, .__map_len = 0 };
+}
+
+/// @brief Copies a view into a new, growable string vector (two memcpys, no per-string work)
+/// @param view
+/// @return The vector, free it with `kiln_string_vec_free`
+kiln_string_vec_t kiln_string_vec_from_view(const kiln_string_vec_view_t* view) {
+    uint64_t data_len = view->__count > 0 ? view->__offsets[view->__count] : 0;
+    kiln_string_vec_t vec = kiln_string_vec_with_capacity(view->__count, data_len);
+    if (vec.__offsets == NULL || vec.__data.ptr == NULL || view->__count == 0) {
+        return vec;
+    }
+
+    memcpy(vec.__offsets, view->__offsets, (view->__count + 1) * sizeof(uint64_t));
+    memcpy(vec.__data.ptr, view->__data, data_len);
+    KILN_STATS_COPY(data_len);
+    vec.__data.__length = data_len;
+    vec.__data.ptr[data_len] = '\0';
+    vec.__count = view->__count;
+    return vec;
+}
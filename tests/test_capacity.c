@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Test kiln_string_reserve
+void test_kiln_string_reserve() {
+    kiln_string_t s = kiln_string_from_cstr("abc");
+    assert(kiln_string_reserve(&s, 0));
+    assert(s.__capacity == 4);
+
+    assert(kiln_string_reserve(&s, 100));
+    assert(s.__capacity >= 3 + 100 + 1);
+    uint64_t capacity = s.__capacity;
+    char* ptr = s.ptr;
+
+    // Appends within the reservation never reallocate
+    for (int i = 0; i < 25; i++) {
+        kiln_string_push_cstr(&s, "defg");
+    }
+    assert(s.ptr == ptr);
+    assert(s.__capacity == capacity);
+    assert(s.__length == 103);
+    assert(kiln_string_starts_with(&s, "abcdefgdefg"));
+
+    // Already large enough
+    assert(kiln_string_reserve(&s, 0));
+    assert(s.__capacity == capacity);
+    kiln_string_free(&s);
+}
+
+// Test kiln_string_shrink_to_fit after in place edits
+void test_kiln_string_shrink_to_fit() {
+    kiln_string_t s = kiln_string_from_cstr("    a long line with padding    ");
+    assert(kiln_string_reserve(&s, 1000));
+    kiln_string_trim_inplace(&s);
+    kiln_string_remove_suffix(&s, kstring_ref_from_cstr(" padding"));
+    assert(s.__capacity > 1000);
+
+    kiln_string_shrink_to_fit(&s);
+    assert(kiln_string_equals_cstr(&s, "a long line with"));
+    assert(s.__capacity == s.__length + 1);
+
+    // No-op when already exact
+    char* ptr = s.ptr;
+    kiln_string_shrink_to_fit(&s);
+    assert(s.ptr == ptr);
+
+    kiln_string_push_cstr(&s, "!");
+    assert(kiln_string_equals_cstr(&s, "a long line with!"));
+    kiln_string_free(&s);
+}
+
+// Test the capacities each growth policy picks
+void test_growth_policies() {
+    assert(kiln_string_get_growth_policy() == KILN_GROWTH_DOUBLE);
+
+    kiln_string_t s = kiln_string_with_capacity(8);
+    s.ptr[0] = '\0';
+    kiln_string_push_cstr(&s, "12345678");
+    assert(s.__capacity == 16);
+    kiln_string_free(&s);
+
+    kiln_string_set_growth_policy(KILN_GROWTH_ONE_HALF);
+    assert(kiln_string_get_growth_policy() == KILN_GROWTH_ONE_HALF);
+    s = kiln_string_with_capacity(8);
+    s.ptr[0] = '\0';
+    kiln_string_push_cstr(&s, "12345678");
+    assert(s.__capacity == 12);
+    kiln_string_push_cstr(&s, "9");
+    assert(s.__capacity == 12);
+    // The request wins when it is larger than 1.5x
+    kiln_string_push_cstr(&s, "abcdefghijklmnopqrstuvwxyz");
+    assert(s.__capacity == 9 + 26 + 1);
+    kiln_string_free(&s);
+
+    kiln_string_set_growth_policy(KILN_GROWTH_SIZE_CLASS);
+    s = kiln_string_with_capacity(8);
+    s.ptr[0] = '\0';
+    for (int i = 0; i < 100; i++) {
+        kiln_string_push_cstr(&s, "0123456789");
+        assert(s.__capacity >= s.__length + 1);
+    }
+    // All of the capacity is writable
+    memset(s.ptr + s.__length, 'x', s.__capacity - s.__length);
+    s.ptr[s.__length] = '\0';
+    assert(s.__length == 1000);
+    kiln_string_free(&s);
+
+    kiln_string_set_growth_policy(KILN_GROWTH_DOUBLE);
+}
+
+int main() {
+    printf("=== Capacity Management Tests ===\n");
+
+    // Run all tests
+    run_test("kiln_string_reserve", test_kiln_string_reserve);
+    run_test("kiln_string_shrink_to_fit", test_kiln_string_shrink_to_fit);
+    run_test("Growth policies", test_growth_policies);
+
+    return 0;
+}
@@ -209,6 +209,11 @@ void test_mixed_comparisons() {
     kiln_string_t sr_as_kstr = kstring_ref_to_kiln_string(sr);
     assert(kiln_string_equals(&kstr, &sr_as_kstr) == true);
 
+    // Mixed equality in both directions
+    assert(kstring_ref_equals_kiln_string(sr, &kstr) == true);
+    assert(kiln_string_equals_kstring_ref(&kstr, sr) == true);
+    assert(kstring_ref_equals_kiln_string(kstring_ref_from_cstr("Test strinG"), &kstr) == false);
+
     kiln_string_free(&kstr);
     kiln_string_free(&sr_as_kstr);
 }
@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Byte at a time base64 encoder, the expected output
+static size_t reference_base64(const unsigned char* s, size_t len, char* out) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t n = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        unsigned int v = s[i] << 16;
+        if (i + 1 < len) v |= s[i + 1] << 8;
+        if (i + 2 < len) v |= s[i + 2];
+        out[n++] = alphabet[v >> 18];
+        out[n++] = alphabet[(v >> 12) & 63];
+        out[n++] = i + 1 < len ? alphabet[(v >> 6) & 63] : '=';
+        out[n++] = i + 2 < len ? alphabet[v & 63] : '=';
+    }
+    return n;
+}
+
+// Test base64 encoding and decoding on fixed inputs (RFC 4648 test vectors)
+void test_base64() {
+    const char* vectors[][2] = {
+        { "", "" }, { "f", "Zg==" }, { "fo", "Zm8=" }, { "foo", "Zm9v" },
+        { "foob", "Zm9vYg==" }, { "fooba", "Zm9vYmE=" }, { "foobar", "Zm9vYmFy" },
+    };
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        kiln_string_t s = kiln_string_from_cstr(">");
+        kiln_string_push_base64(&s, kstring_ref_from_cstr((char*)vectors[i][0]));
+        assert(strcmp(s.ptr + 1, vectors[i][1]) == 0);
+
+        kiln_string_t decoded = kiln_string_from_cstr(">");
+        assert(kstring_ref_base64_decode_into(&decoded, kstring_ref_from_cstr((char*)vectors[i][1])));
+        assert(strcmp(decoded.ptr + 1, vectors[i][0]) == 0);
+
+        kiln_string_free(&s);
+        kiln_string_free(&decoded);
+    }
+
+    // Padding is optional
+    kiln_string_t s = kiln_string_from_cstr("");
+    assert(kstring_ref_base64_decode_into(&s, kstring_ref_from_cstr("Zm9vYg")));
+    assert(kstring_ref_base64_decode_into(&s, kstring_ref_from_cstr("YmE")));
+    assert(kiln_string_equals_cstr(&s, "foobba"));
+
+    const char* invalid[] = { "Z", "Zm9vY", "Zm9v Yg==", "Zg=", "Z===", "Zm=v", "Zh==", "Zm9=", "Zm9v\n" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        assert(!kstring_ref_base64_decode_into(&s, kstring_ref_from_cstr((char*)invalid[i])));
+        assert(kiln_string_equals_cstr(&s, "foobba"));
+    }
+    kiln_string_free(&s);
+}
+
+// Test hex encoding and decoding on fixed inputs
+void test_hex() {
+    kiln_string_t s = kiln_string_from_cstr("0x");
+    kstring_ref_t raw = { .ptr = "\x00\x01\x7f\x80\xab\xff", .__length = 6 };
+    kiln_string_push_hex(&s, raw);
+    assert(kiln_string_equals_cstr(&s, "0x00017f80abff"));
+    kiln_string_free(&s);
+
+    s = kiln_string_from_cstr("");
+    assert(kstring_ref_hex_decode_into(&s, kstring_ref_from_cstr("48656C6c6f")));
+    assert(kiln_string_equals_cstr(&s, "Hello"));
+
+    const char* invalid[] = { "4", "486", "4g", " 48", "0x48" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        assert(!kstring_ref_hex_decode_into(&s, kstring_ref_from_cstr((char*)invalid[i])));
+        assert(kiln_string_equals_cstr(&s, "Hello"));
+    }
+    kiln_string_free(&s);
+}
+
+// Test encoding and decoding random data on every tier
+void test_codec_random() {
+    kiln_string_isa_t original = kiln_string_get_isa();
+    for (int isa = KILN_STRING_ISA_SCALAR; isa <= (int)kiln_string_best_isa(); isa++) {
+        assert(kiln_string_set_isa((kiln_string_isa_t)isa));
+        srand(39);
+        unsigned char raw[300];
+        char expected[400];
+        char expected_hex[600];
+        for (int iter = 0; iter < 2000; iter++) {
+            size_t len = (size_t)(rand() % 300);
+            for (size_t i = 0; i < len; i++) {
+                raw[i] = (unsigned char)(rand() % 256);
+                sprintf(expected_hex + 2 * i, "%02x", raw[i]);
+            }
+            size_t expected_len = reference_base64(raw, len, expected);
+            kstring_ref_t ref = { .ptr = (char*)raw, .__length = len };
+
+            kiln_string_t s = kiln_string_from_cstr("");
+            kiln_string_push_base64(&s, ref);
+            assert(s.__length == expected_len);
+            assert(memcmp(s.ptr, expected, expected_len) == 0);
+
+            kiln_string_t hex = kiln_string_from_cstr("");
+            kiln_string_push_hex(&hex, ref);
+            assert(hex.__length == 2 * len);
+            assert(memcmp(hex.ptr, expected_hex, 2 * len) == 0);
+
+            kiln_string_t round_trip = kiln_string_from_cstr("");
+            assert(kstring_ref_base64_decode_into(&round_trip, kiln_string_to_kstring_ref(&s)));
+            assert(kstring_ref_hex_decode_into(&round_trip, kiln_string_to_kstring_ref(&hex)));
+            kiln_string_to_ascii_upper(&hex);
+            assert(kstring_ref_hex_decode_into(&round_trip, kiln_string_to_kstring_ref(&hex)));
+            assert(round_trip.__length == 3 * len);
+            assert(memcmp(round_trip.ptr, raw, len) == 0);
+            assert(memcmp(round_trip.ptr + len, raw, len) == 0);
+            assert(memcmp(round_trip.ptr + 2 * len, raw, len) == 0);
+
+            kiln_string_free(&s);
+            kiln_string_free(&hex);
+            kiln_string_free(&round_trip);
+        }
+    }
+    assert(kiln_string_set_isa(original));
+}
+
+// Test that every tier rejects exactly the bytes outside the alphabet
+void test_codec_every_byte() {
+    kiln_string_isa_t original = kiln_string_get_isa();
+    for (int isa = KILN_STRING_ISA_SCALAR; isa <= (int)kiln_string_best_isa(); isa++) {
+        assert(kiln_string_set_isa((kiln_string_isa_t)isa));
+        static const char base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        static const char hex_alphabet[] = "0123456789abcdefABCDEF";
+        char base64[200];
+        char hex[200];
+        for (size_t i = 0; i < sizeof(base64); i++) {
+            base64[i] = base64_alphabet[(i * 7) % 64];
+            hex[i] = hex_alphabet[(i * 5) % 22];
+        }
+
+        // Every byte value at positions inside and past the vector blocks, in both cases of a letter
+        static const size_t positions[] = { 0, 5, 31, 33, 100, 150, 199 };
+        for (size_t k = 0; k < sizeof(positions) / sizeof(positions[0]); k++) {
+            size_t pos = positions[k];
+            for (int c = 0; c < 256; c++) {
+                char saved_base64 = base64[pos];
+                char saved_hex = hex[pos];
+                base64[pos] = (char)c;
+                hex[pos] = (char)c;
+
+                kiln_string_t s = kiln_string_from_cstr("");
+                bool base64_ok = c != 0 && strchr(base64_alphabet, c) != NULL;
+                assert(kstring_ref_base64_decode_into(&s, (kstring_ref_t){ .ptr = base64, .__length = sizeof(base64) }) == base64_ok);
+                assert(s.__length == (base64_ok ? sizeof(base64) / 4 * 3 : 0));
+                bool hex_ok = c != 0 && strchr(hex_alphabet, c) != NULL;
+                assert(kstring_ref_hex_decode_into(&s, (kstring_ref_t){ .ptr = hex, .__length = sizeof(hex) }) == hex_ok);
+                kiln_string_free(&s);
+
+                base64[pos] = saved_base64;
+                hex[pos] = saved_hex;
+            }
+        }
+    }
+    assert(kiln_string_set_isa(original));
+}
+
+int main() {
+    printf("=== Base64 and Hex Tests ===\n");
+
+    // Run all tests
+    run_test("Base64 encode and decode", test_base64);
+    run_test("Hex encode and decode", test_hex);
+    run_test("Round trip on every tier", test_codec_random);
+    run_test("Invalid bytes on every tier", test_codec_every_byte);
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+static kiln_csv_field_t next_field(kiln_csv_reader_t* reader) {
+    kiln_csv_field_t field;
+    assert(kiln_csv_reader_next(reader, &field));
+    return field;
+}
+
+// Test a small document with quoting, CRLF and an empty field
+void test_csv_basic() {
+    kiln_csv_reader_t reader = kiln_csv_reader_new(kstring_ref_from_cstr("name,note\r\n\"Smith, J\",\"said \"\"hi\"\"\"\r\nx,\n"), ',');
+
+    kiln_csv_field_t f = next_field(&reader);
+    assert(kstring_ref_equals_cstr(f.value, "name") && !f.quoted && !f.end_of_record);
+    f = next_field(&reader);
+    assert(kstring_ref_equals_cstr(f.value, "note") && f.end_of_record);
+
+    f = next_field(&reader);
+    assert(kstring_ref_equals_cstr(f.value, "Smith, J") && f.quoted && !f.needs_unescape);
+    f = next_field(&reader);
+    assert(f.quoted && f.needs_unescape && f.end_of_record);
+    assert(kstring_ref_equals_cstr(f.value, "said \"\"hi\"\""));
+
+    kiln_string_t unescaped = kiln_string_from_cstr("> ");
+    kiln_csv_field_unescape_into(&unescaped, f);
+    assert(kiln_string_equals_cstr(&unescaped, "> said \"hi\""));
+    kiln_string_free(&unescaped);
+
+    f = next_field(&reader);
+    assert(kstring_ref_equals_cstr(f.value, "x"));
+    f = next_field(&reader);
+    assert(f.value.__length == 0 && f.end_of_record);
+
+    assert(!kiln_csv_reader_next(&reader, &f));
+    assert(!kiln_csv_reader_next(&reader, &f));
+}
+
+// Test TSV, a missing final newline and a trailing delimiter
+void test_csv_edges() {
+    kiln_csv_reader_t reader = kiln_csv_reader_new(kstring_ref_from_cstr("a\tb,c\td"), '\t');
+    assert(kstring_ref_equals_cstr(next_field(&reader).value, "a"));
+    assert(kstring_ref_equals_cstr(next_field(&reader).value, "b,c"));
+    kiln_csv_field_t f = next_field(&reader);
+    assert(kstring_ref_equals_cstr(f.value, "d") && f.end_of_record);
+    assert(!kiln_csv_reader_next(&reader, &f));
+
+    reader = kiln_csv_reader_new(kstring_ref_from_cstr("a,"), ',');
+    assert(kstring_ref_equals_cstr(next_field(&reader).value, "a"));
+    f = next_field(&reader);
+    assert(f.value.__length == 0 && f.end_of_record);
+    assert(!kiln_csv_reader_next(&reader, &f));
+
+    reader = kiln_csv_reader_new(kstring_ref_from_cstr(""), ',');
+    assert(!kiln_csv_reader_next(&reader, &f));
+
+    // Quoted newlines and delimiters don't split
+    reader = kiln_csv_reader_new(kstring_ref_from_cstr("\"line1\nline2,still\",next"), ',');
+    assert(kstring_ref_equals_cstr(next_field(&reader).value, "line1\nline2,still"));
+    assert(kstring_ref_equals_cstr(next_field(&reader).value, "next"));
+
+    // NUL separated records (find -print0), in an exact size buffer so reads past the end are caught
+    char* nul_separated = malloc(5);
+    memcpy(nul_separated, "a\0b\nc", 5);
+    reader = kiln_csv_reader_new((kstring_ref_t){ .ptr = nul_separated, .__length = 5 }, '\0');
+    f = next_field(&reader);
+    assert(kstring_ref_equals_cstr(f.value, "a") && !f.end_of_record);
+    f = next_field(&reader);
+    assert(kstring_ref_equals_cstr(f.value, "b") && f.end_of_record);
+    f = next_field(&reader);
+    assert(kstring_ref_equals_cstr(f.value, "c") && f.end_of_record);
+    assert(!kiln_csv_reader_next(&reader, &f));
+    free(nul_separated);
+
+    // The same across a full block and a partial one
+    char* paths = malloc(100);
+    for (size_t i = 0; i < 100; i++) {
+        paths[i] = i % 10 == 9 ? '\0' : 'p';
+    }
+    reader = kiln_csv_reader_new((kstring_ref_t){ .ptr = paths, .__length = 100 }, '\0');
+    for (size_t i = 0; i < 10; i++) {
+        f = next_field(&reader);
+        assert(f.value.ptr == paths + 10 * i && f.value.__length == 9);
+    }
+    f = next_field(&reader);
+    assert(f.value.__length == 0 && f.end_of_record);
+    assert(!kiln_csv_reader_next(&reader, &f));
+    free(paths);
+}
+
+// Reference splitter: toggles on every quote, splits on unquoted delimiters and newlines
+static size_t reference_split(const char* s, size_t len, char delim, size_t* starts, size_t* ends, bool* eor) {
+    size_t n = 0, start = 0;
+    bool in_quotes = false, last_newline = true;
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] == '"') {
+            in_quotes = !in_quotes;
+        } else if (!in_quotes && (s[i] == delim || s[i] == '\n')) {
+            starts[n] = start;
+            ends[n] = i;
+            eor[n++] = s[i] == '\n';
+            start = i + 1;
+            last_newline = s[i] == '\n';
+        }
+    }
+    if (len > 0 && !(start == len && last_newline)) {
+        starts[n] = start;
+        ends[n] = len;
+        eor[n++] = true;
+    }
+    return n;
+}
+
+// Test the reader against a byte at a time splitter on every tier
+void test_csv_random() {
+    kiln_string_isa_t original = kiln_string_get_isa();
+    for (int isa = KILN_STRING_ISA_SCALAR; isa <= (int)kiln_string_best_isa(); isa++) {
+        assert(kiln_string_set_isa((kiln_string_isa_t)isa));
+        srand(37);
+        enum { MAX_LEN = 300 };
+        char buf[MAX_LEN];
+        size_t starts[MAX_LEN + 1], ends[MAX_LEN + 1];
+        bool eor[MAX_LEN + 1];
+
+        for (int iter = 0; iter < 3000; iter++) {
+            size_t len = (size_t)(rand() % MAX_LEN);
+            for (size_t i = 0; i < len; i++) {
+                buf[i] = "abc,,\"\n\r"[rand() % 8];
+            }
+            size_t n = reference_split(buf, len, ',', starts, ends, eor);
+
+            kstring_ref_t input = { .ptr = buf, .__length = len };
+            kiln_csv_reader_t reader = kiln_csv_reader_new(input, ',');
+            kiln_csv_field_t f;
+            for (size_t k = 0; k < n; k++) {
+                assert(kiln_csv_reader_next(&reader, &f));
+                assert(f.end_of_record == eor[k]);
+
+                size_t s = starts[k], e = ends[k];
+                if (eor[k] && e > s && buf[e - 1] == '\r') e--;
+                bool quoted = e > s && buf[s] == '"';
+                assert(f.quoted == quoted);
+                if (quoted) {
+                    s++;
+                    if (e > s && buf[e - 1] == '"') e--;
+                }
+                assert(f.value.ptr == buf + s && f.value.__length == e - s);
+                assert(f.needs_unescape == (quoted && memchr(buf + s, '"', e - s) != NULL));
+            }
+            assert(!kiln_csv_reader_next(&reader, &f));
+        }
+    }
+    assert(kiln_string_set_isa(original));
+}
+
+int main() {
+    printf("=== CSV Reader Tests ===\n");
+
+    // Run all tests
+    run_test("kiln_csv_reader_next", test_csv_basic);
+    run_test("CSV edge cases", test_csv_edges);
+    run_test("CSV reader against a reference splitter", test_csv_random);
+
+    return 0;
+}
@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Every tier the CPU supports must give exactly the scalar results.
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Random bytes biased towards the interesting ones (whitespace, case, high bit)
+static void fill_random(char* buf, size_t len) {
+    static const char alphabet[] = " \t\n\r\vabcAZaz09\x80\xc3\xff-";
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+    }
+}
+
+static int sign(int64_t x) {
+    return (x > 0) - (x < 0);
+}
+
+// Runs `check` once per supported tier
+static void for_each_isa(void (*check)(kiln_string_isa_t isa)) {
+    kiln_string_isa_t original = kiln_string_get_isa();
+    for (int isa = KILN_STRING_ISA_SCALAR; isa <= (int)kiln_string_best_isa(); isa++) {
+        assert(kiln_string_set_isa((kiln_string_isa_t)isa));
+        assert(kiln_string_get_isa() == (kiln_string_isa_t)isa);
+        check((kiln_string_isa_t)isa);
+    }
+    assert(kiln_string_set_isa(original));
+}
+
+static void check_find(kiln_string_isa_t isa) {
+    (void)isa;
+    srand(31);
+    char hay[300];
+    char needle[8];
+    for (int iter = 0; iter < 3000; iter++) {
+        size_t hay_len = (size_t)(rand() % 299);
+        fill_random(hay, hay_len);
+        hay[hay_len] = '\0';
+
+        // Half the time search for something that is really there
+        size_t needle_len = (size_t)(rand() % 7) + 1;
+        if (hay_len >= needle_len && rand() % 2) {
+            memcpy(needle, hay + rand() % (hay_len - needle_len + 1), needle_len);
+        } else {
+            fill_random(needle, needle_len);
+        }
+        needle[needle_len] = '\0';
+        if (strlen(needle) != needle_len) {
+            continue;
+        }
+
+        int64_t expected = -1;
+        for (size_t i = 0; i + needle_len <= hay_len; i++) {
+            if (memcmp(hay + i, needle, needle_len) == 0) {
+                expected = (int64_t)i;
+                break;
+            }
+        }
+
+        kstring_ref_t ref = { .ptr = hay, .__length = hay_len };
+        assert(kstring_ref_find(ref, needle) == expected);
+    }
+}
+
+// Test kstring_ref_find on every tier
+void test_dispatch_find() {
+    for_each_isa(check_find);
+
+    // The search is bounded by the length, not by a NUL terminator
+    char buf[] = "abcdef";
+    kstring_ref_t ref = { .ptr = buf, .__length = 3 };
+    assert(kstring_ref_find(ref, "de") == -1);
+    assert(kstring_ref_find(ref, "bc") == 1);
+}
+
+static void check_compare(kiln_string_isa_t isa) {
+    (void)isa;
+    srand(7);
+    char a[200], b[200];
+    for (int iter = 0; iter < 3000; iter++) {
+        size_t len = (size_t)(rand() % 200);
+        fill_random(a, len);
+        memcpy(b, a, len);
+        if (len > 0 && rand() % 4) {
+            b[rand() % len] = (char)(rand() % 256);
+        }
+        size_t b_len = rand() % 8 ? len : (size_t)(rand() % (len + 1));
+
+        kstring_ref_t r1 = { .ptr = a, .__length = len };
+        kstring_ref_t r2 = { .ptr = b, .__length = b_len };
+        size_t min_len = len < b_len ? len : b_len;
+        int expected = memcmp(a, b, min_len);
+        if (expected == 0) {
+            expected = (len > b_len) - (len < b_len);
+        }
+        assert(sign(kstring_ref_compare(r1, r2)) == sign(expected));
+    }
+}
+
+// Test kstring_ref_compare on every tier
+void test_dispatch_compare() {
+    for_each_isa(check_compare);
+}
+
+static void check_case_trim(kiln_string_isa_t isa) {
+    (void)isa;
+    srand(99);
+    char buf[260];
+    for (int iter = 0; iter < 2000; iter++) {
+        size_t len = (size_t)(rand() % 259) + 1;
+        fill_random(buf, len);
+        buf[len] = '\0';
+        if (strlen(buf) != len) {
+            continue;
+        }
+
+        kiln_string_t lower = kiln_string_from_cstr(buf);
+        kiln_string_t upper = kiln_string_from_cstr(buf);
+        kiln_string_to_ascii_lower(&lower);
+        kiln_string_to_ascii_upper(&upper);
+        for (size_t i = 0; i < len; i++) {
+            unsigned char c = (unsigned char)buf[i];
+            assert((unsigned char)lower.ptr[i] == (c >= 'A' && c <= 'Z' ? c + 32 : c));
+            assert((unsigned char)upper.ptr[i] == (c >= 'a' && c <= 'z' ? c - 32 : c));
+        }
+        kiln_string_free(&lower);
+        kiln_string_free(&upper);
+
+        size_t start = 0, end = len;
+        while (start < len && strchr(" \t\n\v\f\r", buf[start])) start++;
+        while (end > start && strchr(" \t\n\v\f\r", buf[end - 1])) end--;
+
+        kstring_ref_t trimmed = kstring_ref_trim(kstring_ref_from_cstr(buf));
+        assert(trimmed.ptr == buf + start);
+        assert(trimmed.__length == end - start);
+
+        kiln_string_t s = kiln_string_from_cstr(buf);
+        kiln_string_trim_inplace(&s);
+        assert(s.__length == end - start);
+        assert(memcmp(s.ptr, buf + start, end - start) == 0);
+        assert(s.ptr[s.__length] == '\0');
+        kiln_string_free(&s);
+
+        size_t ascii = 0;
+        while (ascii < len && (unsigned char)buf[ascii] < 0x80) ascii++;
+        assert(kstring_ref_is_ascii(kstring_ref_from_cstr(buf)) == (ascii == len));
+    }
+}
+
+// Test case conversion, trimming and the ASCII check on every tier
+void test_dispatch_case_trim() {
+    for_each_isa(check_case_trim);
+
+    // Long whitespace runs cross several vector blocks
+    char buf[400];
+    memset(buf, ' ', sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+    buf[150] = 'x';
+    kstring_ref_t trimmed = kstring_ref_trim(kstring_ref_from_cstr(buf));
+    assert(trimmed.ptr == buf + 150 && trimmed.__length == 1);
+}
+
+static uint64_t scalar_hashes[64];
+
+static void check_hash(kiln_string_isa_t isa) {
+    char buf[64];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (char)(i * 37 + 11);
+    }
+    for (size_t len = 0; len < 64; len++) {
+        kstring_ref_t ref = { .ptr = buf, .__length = len };
+        uint64_t h = kstring_ref_hash(ref);
+        if (isa == KILN_STRING_ISA_SCALAR) {
+            scalar_hashes[len] = h;
+        } else {
+            assert(h == scalar_hashes[len]);
+        }
+        assert(kstring_ref_hash_seeded(ref, 0) == h);
+    }
+}
+
+// Test that hashes are identical on every tier and sensitive to content, length and seed
+void test_dispatch_hash() {
+    for_each_isa(check_hash);
+
+    kiln_string_t s = kiln_string_from_cstr("hello world");
+    assert(kiln_string_hash(&s) == kstring_ref_hash(kstring_ref_from_cstr("hello world")));
+    assert(kiln_string_hash(&s) != kstring_ref_hash(kstring_ref_from_cstr("hello worle")));
+    assert(kstring_ref_hash_seeded(kstring_ref_from_cstr("abc"), 1) != kstring_ref_hash_seeded(kstring_ref_from_cstr("abc"), 2));
+
+    char zeros[16] = {0};
+    kstring_ref_t z7 = { .ptr = zeros, .__length = 7 };
+    kstring_ref_t z8 = { .ptr = zeros, .__length = 8 };
+    assert(kstring_ref_hash(z7) != kstring_ref_hash(z8));
+    kiln_string_free(&s);
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Counts equal values among n hashes (sorts them)
+static size_t count_collisions(uint64_t* hashes, size_t n) {
+    qsort(hashes, n, sizeof(uint64_t), compare_u64);
+    size_t collisions = 0;
+    for (size_t i = 1; i < n; i++) {
+        collisions += hashes[i] == hashes[i - 1];
+    }
+    return collisions;
+}
+
+// Test that short keys use all 64 bits and that seeds give different collisions
+void test_dispatch_hash_collisions() {
+    size_t n = 200000;
+    uint64_t* hashes = malloc(n * sizeof(uint64_t));
+    char key[16];
+    uint64_t space = 8031810176ull; // 26^7
+
+    // Distinct 7 letter keys (the multiplier is coprime with 26^7), 7 and 8 byte
+    // keys differing only in their one word, and 16 byte keys differing in one word
+    for (uint64_t seed = 0; seed < 3; seed++) {
+        for (size_t len = 7; len <= 16; len += len == 7 ? 1 : 8) {
+            memset(key, 'x', sizeof(key));
+            for (size_t i = 0; i < n; i++) {
+                uint64_t v = (uint64_t)i * 1103515245ull % space;
+                for (size_t j = 0; j < 7; j++) {
+                    key[j] = (char)('a' + v % 26);
+                    v /= 26;
+                }
+                hashes[i] = kstring_ref_hash_seeded((kstring_ref_t){ .ptr = key, .__length = len }, seed);
+            }
+            assert(count_collisions(hashes, n) == 0);
+        }
+    }
+
+    free(hashes);
+}
+
+// Test kstring_ref_is_valid_utf8
+void test_dispatch_utf8() {
+    assert(kstring_ref_is_valid_utf8(kstring_ref_from_cstr("")));
+    assert(kstring_ref_is_valid_utf8(kstring_ref_from_cstr("plain ascii")));
+    assert(kstring_ref_is_valid_utf8(kstring_ref_from_cstr("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80")));
+    assert(!kstring_ref_is_valid_utf8(kstring_ref_from_cstr("\xc3")));           // truncated
+    assert(!kstring_ref_is_valid_utf8(kstring_ref_from_cstr("\xc0\xaf")));       // overlong
+    assert(!kstring_ref_is_valid_utf8(kstring_ref_from_cstr("\xed\xa0\x80")));   // surrogate
+    assert(!kstring_ref_is_valid_utf8(kstring_ref_from_cstr("\xf4\x90\x80\x80"))); // > U+10FFFF
+    assert(!kstring_ref_is_valid_utf8(kstring_ref_from_cstr("ab\x80")));         // stray continuation
+}
+
+// Test the tier selection API
+void test_dispatch_isa() {
+    assert(kiln_string_get_isa() <= kiln_string_best_isa());
+    assert(strcmp(kiln_string_isa_name(KILN_STRING_ISA_SCALAR), "scalar") == 0);
+    assert(strcmp(kiln_string_isa_name(KILN_STRING_ISA_AVX512), "avx512") == 0);
+    assert(!kiln_string_set_isa((kiln_string_isa_t)(KILN_STRING_ISA_AVX512 + 1)));
+
+    if (kiln_string_best_isa() >= KILN_STRING_ISA_AVX2) {
+        assert(kiln_string_cpu_features() & KILN_CPU_AVX2);
+    }
+    printf("  best tier: %s, active: %s\n", kiln_string_isa_name(kiln_string_best_isa()), kiln_string_isa_name(kiln_string_get_isa()));
+}
+
+int main() {
+    printf("=== CPU Dispatch Tests ===\n");
+
+    // Run all tests
+    run_test("Tier selection", test_dispatch_isa);
+    run_test("kstring_ref_find on every tier", test_dispatch_find);
+    run_test("kstring_ref_compare on every tier", test_dispatch_compare);
+    run_test("Case conversion and trim on every tier", test_dispatch_case_trim);
+    run_test("kstring_ref_hash on every tier", test_dispatch_hash);
+    run_test("kstring_ref_hash short key collisions", test_dispatch_hash_collisions);
+    run_test("kstring_ref_is_valid_utf8", test_dispatch_utf8);
+
+    return 0;
+}
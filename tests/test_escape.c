@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Byte at a time percent-encoder, the expected output
+static size_t reference_url_encode(const unsigned char* s, size_t len, char* out) {
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = s[i];
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || (c && strchr("-._~", c))) {
+            out[n++] = (char)c;
+        } else {
+            n += (size_t)sprintf(out + n, "%%%02X", c);
+        }
+    }
+    return n;
+}
+
+// Byte at a time HTML escaper, the expected output
+static size_t reference_html_escape(const unsigned char* s, size_t len, char* out) {
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        switch (s[i]) {
+            case '&': n += (size_t)sprintf(out + n, "&amp;"); break;
+            case '<': n += (size_t)sprintf(out + n, "&lt;"); break;
+            case '>': n += (size_t)sprintf(out + n, "&gt;"); break;
+            case '"': n += (size_t)sprintf(out + n, "&quot;"); break;
+            case '\'': n += (size_t)sprintf(out + n, "&#39;"); break;
+            default: out[n++] = (char)s[i];
+        }
+    }
+    return n;
+}
+
+// Test kiln_string_push_url_encoded and kstring_ref_url_decode_into on fixed inputs
+void test_url() {
+    kiln_string_t s = kiln_string_from_cstr("/search?q=");
+    kiln_string_push_url_encoded(&s, kstring_ref_from_cstr("50% off & free/shipping~ caf\xc3\xa9"));
+    assert(kiln_string_equals_cstr(&s, "/search?q=50%25%20off%20%26%20free%2Fshipping~%20caf%C3%A9"));
+    kiln_string_free(&s);
+
+    s = kiln_string_from_cstr("");
+    assert(kstring_ref_url_decode_into(&s, kstring_ref_from_cstr("a%20b+c%2fd%C3%A9")));
+    assert(kiln_string_equals_cstr(&s, "a b+c/d\xc3\xa9"));
+
+    const char* invalid[] = { "%", "%2", "abc%", "%g0", "%0g", "x%%20" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        assert(!kstring_ref_url_decode_into(&s, kstring_ref_from_cstr((char*)invalid[i])));
+        assert(kiln_string_equals_cstr(&s, "a b+c/d\xc3\xa9"));
+    }
+    kiln_string_free(&s);
+}
+
+// Test kiln_string_push_html_escaped on fixed inputs
+void test_html() {
+    kiln_string_t s = kiln_string_from_cstr("<p title=\"");
+    kiln_string_push_html_escaped(&s, kstring_ref_from_cstr("Tom & Jerry's \"<show>\""));
+    assert(kiln_string_equals_cstr(&s, "<p title=\"Tom &amp; Jerry&#39;s &quot;&lt;show&gt;&quot;"));
+    kiln_string_free(&s);
+
+    s = kiln_string_from_cstr("");
+    kiln_string_push_html_escaped(&s, kstring_ref_from_cstr("nothing to escape here"));
+    assert(kiln_string_equals_cstr(&s, "nothing to escape here"));
+    kiln_string_free(&s);
+}
+
+// Test encoding random data on every tier
+void test_escape_random() {
+    kiln_string_isa_t original = kiln_string_get_isa();
+    for (int isa = KILN_STRING_ISA_SCALAR; isa <= (int)kiln_string_best_isa(); isa++) {
+        assert(kiln_string_set_isa((kiln_string_isa_t)isa));
+        srand(40);
+        unsigned char raw[300];
+        char expected[300 * 6];
+        for (int iter = 0; iter < 2000; iter++) {
+            size_t len = (size_t)(rand() % 300);
+            for (size_t i = 0; i < len; i++) {
+                int r = rand() % 10;
+                raw[i] = r < 6 ? (unsigned char)('a' + rand() % 26) : r < 8 ? (unsigned char)"&<>\"' %-~"[rand() % 9] : (unsigned char)(rand() % 256);
+            }
+            kstring_ref_t ref = { .ptr = (char*)raw, .__length = len };
+
+            size_t expected_len = reference_url_encode(raw, len, expected);
+            kiln_string_t url = kiln_string_from_cstr("");
+            kiln_string_push_url_encoded(&url, ref);
+            assert(url.__length == expected_len);
+            assert(memcmp(url.ptr, expected, expected_len) == 0);
+
+            kiln_string_t round_trip = kiln_string_from_cstr("");
+            assert(kstring_ref_url_decode_into(&round_trip, kiln_string_to_kstring_ref(&url)));
+            assert(round_trip.__length == len);
+            assert(memcmp(round_trip.ptr, raw, len) == 0);
+
+            expected_len = reference_html_escape(raw, len, expected);
+            kiln_string_t html = kiln_string_from_cstr("");
+            kiln_string_push_html_escaped(&html, ref);
+            assert(html.__length == expected_len);
+            assert(memcmp(html.ptr, expected, expected_len) == 0);
+
+            kiln_string_free(&url);
+            kiln_string_free(&round_trip);
+            kiln_string_free(&html);
+        }
+    }
+    assert(kiln_string_set_isa(original));
+}
+
+int main() {
+    printf("=== URL and HTML Escape Tests ===\n");
+
+    // Run all tests
+    run_test("URL encode and decode", test_url);
+    run_test("kiln_string_push_html_escaped", test_html);
+    run_test("Escaping on every tier", test_escape_random);
+
+    return 0;
+}
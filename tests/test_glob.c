@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fnmatch.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+static bool glob_matches(const char* pattern, const char* string) {
+    kstring_glob_t glob = kstring_glob_compile(pattern);
+    bool result = kstring_glob_match(&glob, kstring_ref_from_cstr((char*)string));
+    kstring_glob_free(&glob);
+    return result;
+}
+
+// Test the wildcard forms on typical paths
+void test_glob_basic() {
+    assert(glob_matches("*.log", "app.log"));
+    assert(glob_matches("*.log", ".log"));
+    assert(!glob_matches("*.log", "app.log.gz"));
+    assert(glob_matches("access-*-2026??.gz", "access-web01-202601.gz"));
+    assert(!glob_matches("access-*-2026??.gz", "access-web01-20261.gz"));
+    assert(glob_matches("*", ""));
+    assert(glob_matches("**", "anything/at/all"));
+    assert(glob_matches("", ""));
+    assert(!glob_matches("", "x"));
+    assert(glob_matches("exact", "exact"));
+    assert(!glob_matches("exact", "exact!"));
+    assert(glob_matches("a*b*c", "aXbYbZc"));
+    assert(!glob_matches("a*b*c", "aXcYb"));
+    assert(glob_matches("*aab", "aaab"));
+}
+
+// Test classes, negation and escapes
+void test_glob_classes() {
+    assert(glob_matches("file[0-9].txt", "file7.txt"));
+    assert(!glob_matches("file[0-9].txt", "fileA.txt"));
+    assert(glob_matches("file[!0-9].txt", "fileA.txt"));
+    assert(glob_matches("file[^0-9].txt", "fileA.txt"));
+    assert(glob_matches("[]]", "]"));
+    assert(glob_matches("[a-]", "-"));
+    assert(glob_matches("\\*literal", "*literal"));
+    assert(!glob_matches("\\*literal", "xliteral"));
+    assert(glob_matches("[*?]", "?"));
+    // Unterminated class is a literal '['
+    assert(glob_matches("[abc", "[abc"));
+}
+
+// Test matching refs that are not NUL terminated
+void test_glob_refs() {
+    kstring_glob_t glob = kstring_glob_compile("*.gz");
+    char buf[] = "archive.gz.tmp";
+    kstring_ref_t ref = { .ptr = buf, .__length = 10 };
+    assert(kstring_glob_match(&glob, ref));
+    ref.__length = 14;
+    assert(!kstring_glob_match(&glob, ref));
+    kstring_glob_free(&glob);
+    assert(!kstring_glob_match(&glob, ref));
+}
+
+// Test against fnmatch on random patterns and strings
+void test_glob_random() {
+    static const char* tokens[] = { "a", "b", "?", "*", "[ab]", "[!a]", "\\*", "ab" };
+    srand(36);
+    char pattern[64];
+    char string[32];
+    for (int iter = 0; iter < 20000; iter++) {
+        pattern[0] = '\0';
+        int n_tokens = rand() % 7;
+        for (int t = 0; t < n_tokens; t++) {
+            strcat(pattern, tokens[rand() % 8]);
+        }
+        int len = rand() % 12;
+        for (int j = 0; j < len; j++) {
+            string[j] = "ab*"[rand() % 3];
+        }
+        string[len] = '\0';
+
+        bool expected = fnmatch(pattern, string, 0) == 0;
+        assert(glob_matches(pattern, string) == expected);
+    }
+}
+
+// Test middle segments with `?` and classes, shorter and longer than one Shift-And word, against fnmatch
+void test_glob_long_segments() {
+    srand(37);
+    char string[401];
+    char pattern[1200];
+    for (int iter = 0; iter < 3000; iter++) {
+        size_t len = (size_t)(rand() % 400) + 1;
+        for (size_t j = 0; j < len; j++) {
+            string[j] = "aab"[rand() % 3];
+        }
+        string[len] = '\0';
+
+        // A segment copied from the string with some bytes turned into wildcards, sometimes with one changed byte
+        size_t seg_len = (size_t)(rand() % 150) + 1;
+        size_t start = (size_t)rand() % len;
+        if (start + seg_len > len) {
+            seg_len = len - start;
+        }
+        size_t p = 0;
+        pattern[p++] = '*';
+        for (size_t j = 0; j < seg_len; j++) {
+            char c = string[start + j];
+            if (rand() % 20 == 0) {
+                c = c == 'a' ? 'b' : 'a';
+            }
+            switch (rand() % 6) {
+                case 0: pattern[p++] = '?'; break;
+                case 1: memcpy(pattern + p, c == 'a' ? "[!b]" : "[b-c]", c == 'a' ? 4 : 5); p += c == 'a' ? 4 : 5; break;
+                default: pattern[p++] = c; break;
+            }
+        }
+        pattern[p++] = '*';
+        pattern[p] = '\0';
+
+        bool expected = fnmatch(pattern, string, 0) == 0;
+        assert(glob_matches(pattern, string) == expected);
+    }
+
+    // Many overlapping partial matches: a periodic input against a segment that only matches at the end
+    size_t n = 1 << 16;
+    char* text = malloc(n + 1);
+    memset(text, 'a', n);
+    memcpy(text + n - 3, "bab", 3);
+    text[n] = '\0';
+    assert(glob_matches("*aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa?a[ab]b*", text));
+    assert(!glob_matches("*aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa?a[ab]c*", text));
+    free(text);
+}
+
+// Test kstring_glob_match_many, including a batch large enough for the thread pool
+void test_glob_match_many() {
+    size_t n = 20000;
+    char (*storage)[24] = malloc(n * sizeof(*storage));
+    kstring_ref_t* refs = malloc(n * sizeof(kstring_ref_t));
+    bool* out = malloc(n * sizeof(bool));
+    for (size_t i = 0; i < n; i++) {
+        snprintf(storage[i], sizeof(storage[i]), "host%zu.%s", i, i % 3 == 0 ? "log" : "txt");
+        refs[i] = kstring_ref_from_cstr(storage[i]);
+    }
+
+    kstring_glob_t glob = kstring_glob_compile("host*.log");
+    size_t count = kstring_glob_match_many(&glob, refs, n, out);
+    assert(count == (n + 2) / 3);
+    for (size_t i = 0; i < n; i++) {
+        assert(out[i] == (i % 3 == 0));
+    }
+    assert(kstring_glob_match_many(&glob, refs, 5, NULL) == 2);
+    kstring_glob_free(&glob);
+
+    free(storage);
+    free(refs);
+    free(out);
+}
+
+int main() {
+    printf("=== Glob Tests ===\n");
+
+    // Run all tests
+    run_test("kstring_glob_match wildcards", test_glob_basic);
+    run_test("kstring_glob_match classes and escapes", test_glob_classes);
+    run_test("kstring_glob_match on refs", test_glob_refs);
+    run_test("kstring_glob_match against fnmatch", test_glob_random);
+    run_test("kstring_glob_match long segments", test_glob_long_segments);
+    run_test("kstring_glob_match_many", test_glob_match_many);
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#define KILN_STRING_HEADER_ONLY
+#include "../include/kiln_string.h"
+
+// Compiled with KILN_STRING_HEADER_ONLY, so the accessors and wrappers used here
+// are the static inline copies from the header, not the library's.
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Test ref conversions and equality with the inline accessors
+void test_header_only_refs() {
+    kiln_string_t s = kiln_string_from_cstr("hello world");
+    kstring_ref_t ref = kiln_string_to_kstring_ref(&s);
+    assert(ref.ptr == s.ptr && ref.__length == 11);
+    assert(kstring_ref_from_kiln_string(&s).ptr == s.ptr);
+
+    kstring_ref_t cref = kstring_ref_from_cstr("hello world");
+    assert(kstring_ref_equals(ref, cref));
+    assert(kstring_ref_equals_cstr(ref, "hello world"));
+    assert(!kstring_ref_equals_cstr(ref, "hello"));
+    assert(kstring_ref_equals_kiln_string(cref, &s));
+    assert(kiln_string_equals_kstring_ref(&s, cref));
+    assert(kiln_string_equals_cstr(&s, "hello world"));
+
+    kiln_string_t copy = kstring_ref_to_kiln_string(cref);
+    assert(kiln_string_equals(&s, &copy));
+    assert(kiln_string_compare(&s, &copy) == 0);
+
+    kiln_string_free(&copy);
+    assert(copy.ptr == NULL);
+    kiln_string_free(&s);
+}
+
+// Test the inline wrappers that forward to out of line kernels
+void test_header_only_wrappers() {
+    kiln_string_t s = kiln_string_from_cstr("key=value=more");
+    kiln_string_push_cstr(&s, "!");
+    assert(kiln_string_equals_cstr(&s, "key=value=more!"));
+
+    assert(kiln_string_find(&s, "=") == 3);
+    assert(kiln_string_rfind(&s, "=") == 9);
+    assert(kstring_ref_equals_cstr(kiln_string_substring(&s, 4, 9), "value"));
+
+    kstring_ref_t parts[2];
+    kiln_string_partition(&s, "=", parts);
+    assert(kstring_ref_equals_cstr(parts[0], "key"));
+    assert(kstring_ref_equals_cstr(parts[1], "value=more!"));
+    kiln_string_rpartition(&s, "=", parts);
+    assert(kstring_ref_equals_cstr(parts[0], "key=value"));
+    assert(kstring_ref_equals_cstr(parts[1], "more!"));
+
+    kiln_string_free(&s);
+}
+
+int main() {
+    printf("=== Header Only Mode Tests ===\n");
+
+    // Run all tests
+    run_test("Inline ref conversions and equality", test_header_only_refs);
+    run_test("Inline wrappers", test_header_only_wrappers);
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Test the case conversion _into and _buf functions against the in place ones
+void test_case_into() {
+    const char* inputs[] = { "", "Hello, World!", "MiXeD 123 caf\xc3\xa9 \xc3\x89T\xc3\x89", "\xc3\xa0 la carte ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz 0123456789" };
+    void (*in_place[])(kiln_string_t*) = { kiln_string_to_ascii_lower, kiln_string_to_ascii_upper, kiln_string_to_unicode_lower, kiln_string_to_unicode_upper };
+    void (*into[])(kiln_string_t*, kstring_ref_t) = { kstring_ref_to_ascii_lower_into, kstring_ref_to_ascii_upper_into, kstring_ref_to_unicode_lower_into, kstring_ref_to_unicode_upper_into };
+    uint64_t (*buf[])(kstring_ref_t, char*, uint64_t) = { kstring_ref_to_ascii_lower_buf, kstring_ref_to_ascii_upper_buf, kstring_ref_to_unicode_lower_buf, kstring_ref_to_unicode_upper_buf };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        kstring_ref_t ref = kstring_ref_from_cstr((char*)inputs[i]);
+        for (size_t op = 0; op < 4; op++) {
+            kiln_string_t expected = kiln_string_from_cstr(inputs[i]);
+            in_place[op](&expected);
+
+            kiln_string_t s = kiln_string_from_cstr(">");
+            into[op](&s, ref);
+            assert(s.__length == expected.__length + 1);
+            assert(strcmp(s.ptr + 1, expected.ptr) == 0);
+
+            char out[128];
+            memset(out, '#', sizeof(out));
+            assert(buf[op](ref, out, sizeof(out)) == expected.__length);
+            assert(strcmp(out, expected.ptr) == 0);
+
+            // Too small: the required length is reported and nothing is written
+            memset(out, '#', sizeof(out));
+            assert(buf[op](ref, out, expected.__length) == expected.__length);
+            assert(out[0] == '#');
+
+            // The source is not modified
+            assert(strcmp(ref.ptr, inputs[i]) == 0);
+
+            kiln_string_free(&expected);
+            kiln_string_free(&s);
+        }
+    }
+}
+
+// Test kstring_ref_trim_into and kstring_ref_trim_buf
+void test_trim_into() {
+    kiln_string_t s = kiln_string_from_cstr("[");
+    kstring_ref_trim_into(&s, kstring_ref_from_cstr("  \t padded \n"));
+    kstring_ref_trim_into(&s, kstring_ref_from_cstr("   "));
+    kstring_ref_trim_into(&s, kstring_ref_from_cstr(""));
+    kstring_ref_trim_into(&s, kstring_ref_from_cstr("]"));
+    assert(kiln_string_equals_cstr(&s, "[padded]"));
+    kiln_string_free(&s);
+
+    char out[8];
+    assert(kstring_ref_trim_buf(kstring_ref_from_cstr("  abc  "), out, sizeof(out)) == 3);
+    assert(strcmp(out, "abc") == 0);
+    assert(kstring_ref_trim_buf(kstring_ref_from_cstr(" \n "), out, sizeof(out)) == 0);
+    assert(strcmp(out, "") == 0);
+    assert(kstring_ref_trim_buf(kstring_ref_from_cstr("  too long for it  "), out, sizeof(out)) == 15);
+    assert(kstring_ref_trim_buf(kstring_ref_from_cstr("x"), NULL, 0) == 1);
+}
+
+// Test kstring_ref_replace_into and kstring_ref_replace_buf against kiln_string_replace
+void test_replace_into() {
+    const char* cases[][3] = {
+        { "one two one two one", "one", "1" },
+        { "one two one two one", "two", "three" },
+        { "aaaaa", "aa", "b" },
+        { "no match here", "xyz", "abc" },
+        { "abcabc", "abc", "" },
+        { "", "a", "b" },
+        { "short", "much longer than the text", "x" },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        kiln_string_t expected = kiln_string_from_cstr(cases[i][0]);
+        kiln_string_replace(&expected, cases[i][1], cases[i][2]);
+
+        kstring_ref_t ref = kstring_ref_from_cstr((char*)cases[i][0]);
+        kstring_ref_t old_s = kstring_ref_from_cstr((char*)cases[i][1]);
+        kstring_ref_t new_s = kstring_ref_from_cstr((char*)cases[i][2]);
+
+        kiln_string_t s = kiln_string_from_cstr("");
+        kstring_ref_replace_into(&s, ref, old_s, new_s);
+        assert(kiln_string_equals(&s, &expected));
+
+        char out[64];
+        assert(kstring_ref_replace_buf(ref, old_s, new_s, out, sizeof(out)) == expected.__length);
+        assert(strcmp(out, expected.ptr) == 0);
+        assert(kstring_ref_replace_buf(ref, old_s, new_s, NULL, 0) == expected.__length);
+
+        kiln_string_free(&expected);
+        kiln_string_free(&s);
+    }
+
+    // An empty pattern copies the source unchanged
+    kiln_string_t s = kiln_string_from_cstr("");
+    kstring_ref_replace_into(&s, kstring_ref_from_cstr("abc"), kstring_ref_from_cstr(""), kstring_ref_from_cstr("x"));
+    assert(kiln_string_equals_cstr(&s, "abc"));
+    kiln_string_free(&s);
+}
+
+int main() {
+    printf("=== Copying Transform Tests ===\n");
+
+    // Run all tests
+    run_test("Case conversion _into and _buf", test_case_into);
+    run_test("kstring_ref_trim_into and _buf", test_trim_into);
+    run_test("kstring_ref_replace_into and _buf", test_replace_into);
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+typedef struct {
+    int fd;
+    kiln_string_t received;
+} pipe_reader_t;
+
+// Drains the read end of a pipe in small reads, so the writer sees a full pipe
+static void* pipe_reader(void* arg) {
+    pipe_reader_t* reader = arg;
+    char buf[777];
+    ssize_t got;
+    while ((got = read(reader->fd, buf, sizeof(buf))) > 0) {
+        kiln_string_push_kstring_ref(&reader->received, (kstring_ref_t){ .ptr = buf, .__length = (uint64_t)got });
+    }
+    return NULL;
+}
+
+// Writes `refs` through a pipe and checks that the reader got exactly their concatenation
+static void check_write_refs(const kstring_ref_t* refs, size_t n) {
+    int fds[2];
+    assert(pipe(fds) == 0);
+    pipe_reader_t reader = { .fd = fds[0], .received = kiln_string_from_cstr("") };
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, pipe_reader, &reader) == 0);
+
+    assert(kiln_write_refs(fds[1], refs, n));
+    close(fds[1]);
+    pthread_join(thread, NULL);
+    close(fds[0]);
+
+    kiln_string_t expected = kiln_string_concat(refs, n);
+    assert(kiln_string_equals(&reader.received, &expected));
+    kiln_string_free(&expected);
+    kiln_string_free(&reader.received);
+}
+
+// Test kiln_write_refs with more refs than IOV_MAX and more bytes than a pipe holds
+void test_write_refs() {
+    kstring_ref_t few[] = { KSTR("HTTP/1.1 200 OK\r\n"), KSTR(""), KSTR("Content-Length: 5\r\n\r\n"), KSTR("hello") };
+    check_write_refs(few, 4);
+    check_write_refs(NULL, 0);
+
+    size_t n = 5000;
+    char* big = malloc(300000);
+    for (size_t i = 0; i < 300000; i++) {
+        big[i] = (char)('a' + i % 26);
+    }
+    kstring_ref_t* refs = malloc(n * sizeof(kstring_ref_t));
+    for (size_t i = 0; i < n; i++) {
+        // Mostly small pieces, some empty, a few larger than the pipe buffer
+        size_t len = i % 1000 == 0 ? 100000 + i : i % 7 == 0 ? 0 : i % 50;
+        refs[i] = (kstring_ref_t){ .ptr = big + i % 97, .__length = len };
+    }
+    check_write_refs(refs, n);
+
+    free(refs);
+    free(big);
+}
+
+// Test that errors are reported
+void test_write_refs_error() {
+    kstring_ref_t refs[] = { KSTR("data") };
+    int fds[2];
+    assert(pipe(fds) == 0);
+    close(fds[1]);
+    close(fds[0]);
+    errno = 0;
+    assert(!kiln_write_refs(fds[1], refs, 1));
+    assert(errno == EBADF);
+
+    // Nothing to write succeeds without touching the fd
+    kstring_ref_t empty[] = { KSTR(""), KSTR("") };
+    assert(kiln_write_refs(fds[1], empty, 2));
+}
+
+// Test kiln_iov_builder_t
+void test_iov_builder() {
+    kiln_iov_builder_t builder = kiln_iov_builder_new();
+    assert(kiln_iov_builder_len(&builder) == 0);
+
+    char body[] = "0123456789";
+    kiln_string_t header = kiln_string_from_cstr("Header: value\r\n");
+    kiln_iov_builder_push(&builder, KSTR_REF(&header));
+    kiln_iov_builder_push(&builder, KSTR(""));
+    // Adjacent pieces of the same buffer are merged into one ref
+    kiln_iov_builder_push(&builder, (kstring_ref_t){ .ptr = body, .__length = 4 });
+    kiln_iov_builder_push(&builder, (kstring_ref_t){ .ptr = body + 4, .__length = 6 });
+    assert(builder.__count == 2);
+    assert(kiln_iov_builder_len(&builder) == header.__length + 10);
+
+    for (int i = 0; i < 100; i++) {
+        kiln_iov_builder_push(&builder, KSTR("|"));
+    }
+
+    kiln_string_t collected = kiln_string_from_cstr(">");
+    assert(kiln_iov_builder_collect_into(&collected, &builder));
+    assert(collected.__length == 1 + kiln_iov_builder_len(&builder));
+    assert(strncmp(collected.ptr, ">Header: value\r\n0123456789||", 28) == 0);
+
+    int fds[2];
+    assert(pipe(fds) == 0);
+    assert(kiln_iov_builder_write(&builder, fds[1]));
+    close(fds[1]);
+    char buf[256];
+    ssize_t got = read(fds[0], buf, sizeof(buf));
+    close(fds[0]);
+    assert(got == (ssize_t)kiln_iov_builder_len(&builder));
+    assert(memcmp(buf, collected.ptr + 1, (size_t)got) == 0);
+
+    kiln_iov_builder_clear(&builder);
+    assert(kiln_iov_builder_len(&builder) == 0);
+    kiln_iov_builder_push(&builder, KSTR("again"));
+    assert(kiln_iov_builder_len(&builder) == 5);
+
+    kiln_iov_builder_free(&builder);
+    kiln_iov_builder_free(&builder);
+    kiln_string_free(&collected);
+    kiln_string_free(&header);
+}
+
+// Test that a push that could not be stored fails the write and the collect
+void test_iov_builder_failed_push() {
+    kiln_iov_builder_t builder = kiln_iov_builder_new();
+    kiln_iov_builder_push(&builder, KSTR("kept"));
+    // What push does when the ref array can't grow
+    builder.__failed = true;
+    kiln_iov_builder_push(&builder, KSTR(" more"));
+
+    int fds[2];
+    assert(pipe(fds) == 0);
+    errno = 0;
+    assert(!kiln_iov_builder_write(&builder, fds[1]));
+    assert(errno == ENOMEM);
+
+    kiln_string_t collected = kiln_string_from_cstr(">");
+    assert(!kiln_iov_builder_collect_into(&collected, &builder));
+    assert(collected.__length == 1);
+
+    // Clearing starts a fresh output
+    kiln_iov_builder_clear(&builder);
+    kiln_iov_builder_push(&builder, KSTR("ok"));
+    assert(kiln_iov_builder_write(&builder, fds[1]));
+    close(fds[1]);
+    char buf[16];
+    assert(read(fds[0], buf, sizeof(buf)) == 2 && memcmp(buf, "ok", 2) == 0);
+    close(fds[0]);
+
+    kiln_iov_builder_free(&builder);
+    kiln_string_free(&collected);
+}
+
+int main() {
+    printf("=== Scatter-Gather Output Tests ===\n");
+
+    // Run all tests
+    run_test("kiln_write_refs", test_write_refs);
+    run_test("kiln_write_refs errors", test_write_refs_error);
+    run_test("kiln_iov_builder_t", test_iov_builder);
+    run_test("kiln_iov_builder_t failed push", test_iov_builder_failed_push);
+
+    return 0;
+}
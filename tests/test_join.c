@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Test kiln_string_join
+void test_kiln_string_join() {
+    kstring_ref_t parts[] = {
+        kstring_ref_from_cstr("usr"),
+        kstring_ref_from_cstr("local"),
+        kstring_ref_from_cstr(""),
+        kstring_ref_from_cstr("bin"),
+    };
+
+    kiln_string_t s = kiln_string_join(parts, 4, kstring_ref_from_cstr("/"));
+    assert(kiln_string_equals_cstr(&s, "usr/local//bin"));
+    assert(s.__capacity == s.__length + 1);
+    kiln_string_free(&s);
+
+    s = kiln_string_join(parts, 2, kstring_ref_from_cstr(", "));
+    assert(kiln_string_equals_cstr(&s, "usr, local"));
+    kiln_string_free(&s);
+
+    s = kiln_string_join(parts, 1, kstring_ref_from_cstr(", "));
+    assert(kiln_string_equals_cstr(&s, "usr"));
+    kiln_string_free(&s);
+
+    s = kiln_string_join(parts, 0, kstring_ref_from_cstr(", "));
+    assert(s.__length == 0);
+    assert(strcmp(s.ptr, "") == 0);
+    kiln_string_free(&s);
+}
+
+// Test kiln_string_concat
+void test_kiln_string_concat() {
+    kstring_ref_t parts[] = {
+        kstring_ref_from_cstr("con"),
+        kstring_ref_from_cstr("cat"),
+        kstring_ref_from_cstr("enate"),
+    };
+
+    kiln_string_t s = kiln_string_concat(parts, 3);
+    assert(kiln_string_equals_cstr(&s, "concatenate"));
+    assert(s.__capacity == s.__length + 1);
+    kiln_string_free(&s);
+
+    s = kiln_string_concat(parts, 0);
+    assert(s.__length == 0);
+    kiln_string_free(&s);
+}
+
+// Test that the push variants append to an existing string and grow it at most once
+void test_kiln_string_push_join() {
+    kstring_ref_t parts[64];
+    for (int i = 0; i < 64; i++) {
+        parts[i] = kstring_ref_from_cstr("piece");
+    }
+
+    kiln_string_t s = kiln_string_from_cstr("[");
+    kiln_string_stats_reset();
+    kiln_string_push_join(&s, parts, 64, kstring_ref_from_cstr(","));
+    kiln_string_stats_t stats = kiln_string_stats_snapshot();
+#ifdef KILN_STRING_STATS
+    assert(stats.reallocations == 1);
+#else
+    assert(stats.reallocations == 0);
+#endif
+    kiln_string_push_cstr(&s, "]");
+    assert(s.__length == 1 + 64 * 5 + 63 + 1);
+    assert(kiln_string_starts_with(&s, "[piece,piece,"));
+    assert(kiln_string_ends_with(&s, ",piece]"));
+    kiln_string_free(&s);
+
+    s = kiln_string_from_cstr("a");
+    kiln_string_push_concat(&s, parts, 2);
+    kiln_string_push_concat(&s, parts, 0);
+    kiln_string_push_join(&s, parts, 0, kstring_ref_from_cstr(","));
+    assert(kiln_string_equals_cstr(&s, "apiecepiece"));
+    kiln_string_free(&s);
+}
+
+int main() {
+    printf("=== Join and Concat Tests ===\n");
+
+    // Run all tests
+    run_test("kiln_string_join", test_kiln_string_join);
+    run_test("kiln_string_concat", test_kiln_string_concat);
+    run_test("kiln_string_push_join and push_concat", test_kiln_string_push_join);
+
+    return 0;
+}
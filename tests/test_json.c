@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Byte at a time escaper, the expected output
+static size_t reference_escape(const char* s, size_t len, char* out) {
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)s[i];
+        switch (c) {
+            case '"': n += (size_t)sprintf(out + n, "\\\""); break;
+            case '\\': n += (size_t)sprintf(out + n, "\\\\"); break;
+            case '\b': n += (size_t)sprintf(out + n, "\\b"); break;
+            case '\f': n += (size_t)sprintf(out + n, "\\f"); break;
+            case '\n': n += (size_t)sprintf(out + n, "\\n"); break;
+            case '\r': n += (size_t)sprintf(out + n, "\\r"); break;
+            case '\t': n += (size_t)sprintf(out + n, "\\t"); break;
+            default:
+                if (c < 0x20) {
+                    n += (size_t)sprintf(out + n, "\\u%04x", c);
+                } else {
+                    out[n++] = (char)c;
+                }
+        }
+    }
+    return n;
+}
+
+// Test kiln_string_push_json_escaped on fixed inputs
+void test_json_escape() {
+    kiln_string_t s = kiln_string_from_cstr("{\"msg\":\"");
+    kiln_string_push_json_escaped(&s, kstring_ref_from_cstr("say \"hi\"\n\tpath C:\\tmp \x01 caf\xc3\xa9"));
+    kiln_string_push_cstr(&s, "\"}");
+    assert(kiln_string_equals_cstr(&s, "{\"msg\":\"say \\\"hi\\\"\\n\\tpath C:\\\\tmp \\u0001 caf\xc3\xa9\"}"));
+    kiln_string_free(&s);
+
+    s = kiln_string_with_capacity(1);
+    s.ptr[0] = '\0';
+    kiln_string_push_json_escaped(&s, kstring_ref_from_cstr(""));
+    assert(s.__length == 0);
+    kiln_string_free(&s);
+}
+
+// Test kstring_ref_json_unescape_into, including surrogate pairs and errors
+void test_json_unescape() {
+    kiln_string_t s = kiln_string_from_cstr(">");
+    assert(kstring_ref_json_unescape_into(&s, kstring_ref_from_cstr("a\\\"b\\\\c\\/d\\n\\u00e9\\u20AC\\ud83d\\ude00")));
+    assert(kiln_string_equals_cstr(&s, ">a\"b\\c/d\n\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80"));
+
+    const char* invalid[] = { "\\", "\\x", "\\u12", "\\u12G4", "\\ud83d", "\\ud83dx\\ude00", "\\ude00", "\\ud83d\\u0041" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        assert(!kstring_ref_json_unescape_into(&s, kstring_ref_from_cstr((char*)invalid[i])));
+        assert(kiln_string_equals_cstr(&s, ">a\"b\\c/d\n\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80"));
+    }
+    kiln_string_free(&s);
+}
+
+// Test escaping and unescaping random data on every tier
+void test_json_random() {
+    kiln_string_isa_t original = kiln_string_get_isa();
+    for (int isa = KILN_STRING_ISA_SCALAR; isa <= (int)kiln_string_best_isa(); isa++) {
+        assert(kiln_string_set_isa((kiln_string_isa_t)isa));
+        srand(38);
+        char raw[400];
+        char expected[400 * 6];
+        for (int iter = 0; iter < 2000; iter++) {
+            size_t len = (size_t)(rand() % 400);
+            for (size_t i = 0; i < len; i++) {
+                int r = rand() % 10;
+                raw[i] = r < 6 ? (char)('a' + rand() % 26) : r < 8 ? "\"\\\n\t\b\f\r"[rand() % 7] : (char)(rand() % 256);
+            }
+            size_t expected_len = reference_escape(raw, len, expected);
+
+            kiln_string_t s = kiln_string_from_cstr("");
+            kstring_ref_t ref = { .ptr = raw, .__length = len };
+            kiln_string_push_json_escaped(&s, ref);
+            assert(s.__length == expected_len);
+            assert(memcmp(s.ptr, expected, expected_len) == 0);
+            // Pre-sized exactly, no slack from doubling
+            assert(s.__capacity == expected_len + 1 || expected_len == 0);
+
+            kiln_string_t round_trip = kiln_string_from_cstr("");
+            assert(kstring_ref_json_unescape_into(&round_trip, kiln_string_to_kstring_ref(&s)));
+            assert(round_trip.__length == len);
+            assert(memcmp(round_trip.ptr, raw, len) == 0);
+
+            kiln_string_free(&s);
+            kiln_string_free(&round_trip);
+        }
+    }
+    assert(kiln_string_set_isa(original));
+}
+
+int main() {
+    printf("=== JSON Escape Tests ===\n");
+
+    // Run all tests
+    run_test("kiln_string_push_json_escaped", test_json_escape);
+    run_test("kstring_ref_json_unescape_into", test_json_unescape);
+    run_test("JSON escape round trip on every tier", test_json_random);
+
+    return 0;
+}
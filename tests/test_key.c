@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Test that a key caches its length and hash and converts to a ref
+void test_key_create() {
+    const kiln_key_t* key = kiln_key_from_cstr("user:1234");
+    assert(key != NULL);
+    assert(kiln_key_length(key) == 9);
+    assert(kiln_key_hash(key) == kstring_ref_hash(kstring_ref_from_cstr("user:1234")));
+
+    kstring_ref_t ref = kiln_key_to_kstring_ref(key);
+    assert(kstring_ref_equals_cstr(ref, "user:1234"));
+    assert(ref.ptr[ref.__length] == '\0');
+    assert(kstring_ref_starts_with(ref, "user:"));
+    assert(kstring_ref_find(ref, "12") == 5);
+
+    // Embedded NULs are kept
+    char raw[] = { 'a', '\0', 'b' };
+    kstring_ref_t raw_ref = { .ptr = raw, .__length = 3 };
+    const kiln_key_t* binary = kiln_key_from_kstring_ref(raw_ref);
+    assert(kiln_key_length(binary) == 3);
+    assert(kstring_ref_equals(kiln_key_to_kstring_ref(binary), raw_ref));
+
+    const kiln_key_t* empty = kiln_key_from_cstr("");
+    assert(kiln_key_length(empty) == 0);
+
+    kiln_key_free(key);
+    kiln_key_free(binary);
+    kiln_key_free(empty);
+    kiln_key_free(NULL);
+}
+
+// Test key equality against keys and refs
+void test_key_equals() {
+    const kiln_key_t* a = kiln_key_from_cstr("alpha");
+    const kiln_key_t* a2 = kiln_key_from_cstr("alpha");
+    const kiln_key_t* b = kiln_key_from_cstr("alphb");
+    const kiln_key_t* c = kiln_key_from_cstr("alph");
+
+    assert(kiln_key_equals(a, a));
+    assert(kiln_key_equals(a, a2));
+    assert(!kiln_key_equals(a, b));
+    assert(!kiln_key_equals(a, c));
+
+    kstring_ref_t probe = kstring_ref_from_cstr("alpha");
+    uint64_t probe_hash = kstring_ref_hash(probe);
+    assert(kiln_key_equals_hashed_ref(a, probe, probe_hash));
+    assert(!kiln_key_equals_hashed_ref(b, probe, probe_hash));
+    assert(!kiln_key_equals_hashed_ref(a, probe, probe_hash ^ 1));
+    assert(kiln_key_equals_kstring_ref(a2, probe));
+    assert(!kiln_key_equals_kstring_ref(c, probe));
+
+    kiln_key_free(a);
+    kiln_key_free(a2);
+    kiln_key_free(b);
+    kiln_key_free(c);
+}
+
+int main() {
+    printf("=== String Key Tests ===\n");
+
+    // Run all tests
+    run_test("kiln_key_from_cstr", test_key_create);
+    run_test("kiln_key_equals", test_key_equals);
+
+    return 0;
+}
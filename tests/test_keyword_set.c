@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+static int64_t lookup(const kstring_keyword_set_t* set, char* s) {
+    return kstring_keyword_set_lookup(set, kstring_ref_from_cstr(s));
+}
+
+// Test a small set of HTTP methods
+void test_keyword_set_http_methods() {
+    char* methods[] = { "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH" };
+    size_t n = sizeof(methods) / sizeof(methods[0]);
+    kstring_ref_t refs[9];
+    for (size_t i = 0; i < n; i++) {
+        refs[i] = kstring_ref_from_cstr(methods[i]);
+    }
+
+    kstring_keyword_set_t set = kstring_keyword_set_new(refs, n);
+    assert(kstring_keyword_set_ok(&set));
+    for (size_t i = 0; i < n; i++) {
+        assert(lookup(&set, methods[i]) == (int64_t)i);
+    }
+
+    assert(lookup(&set, "get") == -1);
+    assert(lookup(&set, "GE") == -1);
+    assert(lookup(&set, "GETS") == -1);
+    assert(lookup(&set, "") == -1);
+    assert(lookup(&set, "PROPFIND") == -1);
+
+    kstring_keyword_set_free(&set);
+    assert(lookup(&set, "GET") == -1);
+    assert(!kstring_keyword_set_ok(&set));
+}
+
+// Test SQL keywords, duplicates and the empty keyword
+void test_keyword_set_duplicates() {
+    kstring_ref_t refs[] = {
+        kstring_ref_from_cstr("SELECT"), kstring_ref_from_cstr("FROM"), kstring_ref_from_cstr("WHERE"),
+        kstring_ref_from_cstr("FROM"), kstring_ref_from_cstr(""), kstring_ref_from_cstr("SELECT"),
+        kstring_ref_from_cstr("ORDER"), kstring_ref_from_cstr("BY"),
+    };
+    kstring_keyword_set_t set = kstring_keyword_set_new(refs, sizeof(refs) / sizeof(refs[0]));
+
+    assert(lookup(&set, "SELECT") == 0);
+    assert(lookup(&set, "FROM") == 1);
+    assert(lookup(&set, "WHERE") == 2);
+    assert(lookup(&set, "") == 4);
+    assert(lookup(&set, "ORDER") == 6);
+    assert(lookup(&set, "BY") == 7);
+    assert(lookup(&set, "GROUP") == -1);
+
+    // Keywords are copied, not borrowed
+    char buf[] = "JOIN";
+    kstring_ref_t join = kstring_ref_from_cstr(buf);
+    kstring_keyword_set_t single = kstring_keyword_set_new(&join, 1);
+    buf[0] = 'X';
+    assert(lookup(&single, "JOIN") == 0);
+    assert(lookup(&single, "XOIN") == -1);
+
+    kstring_keyword_set_free(&set);
+    kstring_keyword_set_free(&single);
+}
+
+// Test that an empty set matches nothing
+void test_keyword_set_empty() {
+    kstring_keyword_set_t set = kstring_keyword_set_new(NULL, 0);
+    // An empty vocabulary is a successful build
+    assert(kstring_keyword_set_ok(&set));
+    assert(lookup(&set, "") == -1);
+    assert(lookup(&set, "anything") == -1);
+    kstring_keyword_set_free(&set);
+}
+
+// Test a few thousand generated keywords on every kernel tier
+void test_keyword_set_large() {
+    size_t n = 5000;
+    char (*words)[16] = malloc(n * sizeof(*words));
+    kstring_ref_t* refs = malloc(n * sizeof(kstring_ref_t));
+    for (size_t i = 0; i < n; i++) {
+        snprintf(words[i], sizeof(words[i]), "kw_%zx_%zu", i * 2654435761u % 100003, i);
+        refs[i] = kstring_ref_from_cstr(words[i]);
+    }
+
+    kiln_string_isa_t original = kiln_string_get_isa();
+    for (int isa = KILN_STRING_ISA_SCALAR; isa <= (int)kiln_string_best_isa(); isa++) {
+        assert(kiln_string_set_isa((kiln_string_isa_t)isa));
+
+        kstring_keyword_set_t set = kstring_keyword_set_new(refs, n);
+        for (size_t i = 0; i < n; i++) {
+            assert(kstring_keyword_set_lookup(&set, refs[i]) == (int64_t)i);
+        }
+        char miss[24];
+        for (size_t i = 0; i < n; i++) {
+            snprintf(miss, sizeof(miss), "kw_%zx_%zu!", i * 2654435761u % 100003, i);
+            assert(lookup(&set, miss) == -1);
+            assert(kstring_keyword_set_lookup(&set, (kstring_ref_t){ .ptr = refs[i].ptr, .__length = refs[i].__length - 1 }) == -1);
+        }
+        kstring_keyword_set_free(&set);
+    }
+    assert(kiln_string_set_isa(original));
+
+    free(refs);
+    free(words);
+}
+
+// Test a large set of short keys, where a weak hash runs out of distinct values
+void test_keyword_set_short_keys() {
+    size_t n = 200000;
+    uint64_t space = 8031810176ull; // 26^7, the multiplier below is coprime with it
+    char (*words)[8] = malloc(n * sizeof(*words));
+    kstring_ref_t* refs = malloc(n * sizeof(kstring_ref_t));
+    for (size_t i = 0; i < n; i++) {
+        uint64_t v = (uint64_t)i * 1103515245ull % space;
+        for (size_t j = 0; j < 7; j++) {
+            words[i][j] = (char)('a' + v % 26);
+            v /= 26;
+        }
+        refs[i] = (kstring_ref_t){ .ptr = words[i], .__length = 7 };
+    }
+
+    kstring_keyword_set_t set = kstring_keyword_set_new(refs, n);
+    assert(kstring_keyword_set_ok(&set));
+    for (size_t i = 0; i < n; i++) {
+        assert(kstring_keyword_set_lookup(&set, refs[i]) == (int64_t)i);
+    }
+    assert(lookup(&set, "aaaaaaaa") == -1);
+
+    kstring_keyword_set_free(&set);
+    free(refs);
+    free(words);
+}
+
+int main() {
+    printf("=== Keyword Set Tests ===\n");
+
+    // Run all tests
+    run_test("kstring_keyword_set_lookup HTTP methods", test_keyword_set_http_methods);
+    run_test("kstring_keyword_set_new duplicates", test_keyword_set_duplicates);
+    run_test("kstring_keyword_set_new empty set", test_keyword_set_empty);
+    run_test("kstring_keyword_set_lookup large set", test_keyword_set_large);
+    run_test("kstring_keyword_set_lookup 200,000 short keys", test_keyword_set_short_keys);
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Test KSTR
+void test_kstr() {
+    kstring_ref_t ref = KSTR("hello");
+    assert(ref.__length == 5);
+    assert(memcmp(ref.ptr, "hello", 5) == 0);
+    assert(KSTR("").__length == 0);
+    // The length comes from sizeof, so embedded NULs are kept
+    assert(KSTR("a\0b").__length == 3);
+}
+
+// Test KSTR_REF on each supported argument type
+void test_kstr_ref() {
+    kiln_string_t s = kiln_string_from_cstr("abc");
+    const kiln_string_t* cs = &s;
+    char buf[] = "abc";
+    const char* cstr = "abc";
+
+    assert(KSTR_REF(&s).ptr == s.ptr && KSTR_REF(&s).__length == 3);
+    assert(KSTR_REF(cs).__length == 3);
+    assert(KSTR_REF(buf).ptr == buf && KSTR_REF(buf).__length == 3);
+    assert(KSTR_REF(cstr).__length == 3);
+    assert(KSTR_REF("abc").__length == 3);
+    assert(KSTR_REF(KSTR("abcd")).__length == 4);
+    kiln_string_free(&s);
+}
+
+// Test the _ref overloads against the C string versions
+void test_ref_overloads() {
+    kstring_ref_t ref = KSTR("key=value=more");
+    assert(kstring_ref_find_ref(ref, KSTR("=")) == kstring_ref_find(ref, "="));
+    assert(kstring_ref_find_ref(ref, KSTR("")) == 0);
+    assert(kstring_ref_find_ref(ref, KSTR("missing")) == -1);
+    assert(kstring_ref_rfind_ref(ref, KSTR("=")) == 9);
+    assert(kstring_ref_rfind_ref(ref, KSTR("")) == -1);
+    assert(kstring_ref_rfind_ref(ref, KSTR("key=value=more!")) == -1);
+    assert(kstring_ref_starts_with_ref(ref, KSTR("key")));
+    assert(kstring_ref_starts_with_ref(ref, KSTR("")));
+    assert(!kstring_ref_starts_with_ref(ref, KSTR("value")));
+    assert(kstring_ref_ends_with_ref(ref, KSTR("more")));
+    assert(!kstring_ref_ends_with_ref(ref, KSTR("key=value=more+")));
+
+    kstring_ref_t parts[2];
+    kstring_ref_partition_ref(ref, KSTR("="), parts);
+    assert(kstring_ref_equals_cstr(parts[0], "key"));
+    assert(kstring_ref_equals_cstr(parts[1], "value=more"));
+    kstring_ref_rpartition_ref(ref, KSTR("="), parts);
+    assert(kstring_ref_equals_cstr(parts[0], "key=value"));
+    assert(kstring_ref_equals_cstr(parts[1], "more"));
+
+    // Needles with embedded NULs work with the _ref versions
+    kstring_ref_t binary = KSTR("ab\0cd\0ef");
+    assert(kstring_ref_find_ref(binary, KSTR("\0e")) == 5);
+    assert(kstring_ref_rfind_ref(binary, KSTR("\0")) == 5);
+
+    kiln_string_t s = kiln_string_from_cstr("one two one two one");
+    kiln_string_replace_ref(&s, KSTR("one"), KSTR("1"));
+    assert(kiln_string_equals_cstr(&s, "1 two 1 two 1"));
+    kiln_string_replace_ref(&s, KSTR(""), KSTR("x"));
+    kiln_string_replace_ref(&s, KSTR("1 two 1 two 1 and more"), KSTR("x"));
+    assert(kiln_string_equals_cstr(&s, "1 two 1 two 1"));
+    kiln_string_free(&s);
+}
+
+// Test the _Generic front ends with mixed argument types
+void test_generic_front_ends() {
+    kiln_string_t s = kiln_string_from_cstr("path/to/file.txt");
+    kiln_string_t ext = kiln_string_from_cstr(".txt");
+    kstring_ref_t ref = kiln_string_to_kstring_ref(&s);
+
+    assert(kstr_find(&s, "/") == 4);
+    assert(kstr_find(ref, KSTR("to")) == 5);
+    assert(kstr_rfind("a/b/c", &s) == -1);
+    assert(kstr_rfind(&s, KSTR("/")) == 7);
+    assert(kstr_starts_with(&s, "path/"));
+    assert(kstr_ends_with(ref, &ext));
+    assert(kstr_equals(KSTR(".txt"), &ext));
+    assert(!kstr_equals("path", ref));
+
+    kstring_ref_t parts[2];
+    kstr_rpartition(&s, "/", parts);
+    assert(kstr_equals(parts[1], "file.txt"));
+    kstr_partition(ref, KSTR("/"), parts);
+    assert(kstr_equals(parts[0], "path"));
+
+    kstr_replace(&s, KSTR("/"), "::");
+    assert(kstr_equals(&s, "path::to::file.txt"));
+
+    kiln_string_free(&s);
+    kiln_string_free(&ext);
+}
+
+int main() {
+    printf("=== Literal and Generic Helper Tests ===\n");
+
+    // Run all tests
+    run_test("KSTR", test_kstr);
+    run_test("KSTR_REF", test_kstr_ref);
+    run_test("_ref overloads", test_ref_overloads);
+    run_test("_Generic front ends", test_generic_front_ends);
+
+    return 0;
+}
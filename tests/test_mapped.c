@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// The threshold is lowered so the large-string paths run on small inputs.
+#define TEST_THRESHOLD (64 * 1024)
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+static bool is_mapped(const kiln_string_t* s) {
+    return (s->__capacity & KILN_STRING_MAPPED) != 0;
+}
+
+static void check_pattern(const kiln_string_t* s) {
+    for (uint64_t i = 0; i < s->__length; i++) {
+        assert(s->ptr[i] == (char)('a' + i % 26));
+    }
+    assert(s->ptr[s->__length] == '\0');
+}
+
+static kiln_string_t grow_to(uint64_t length) {
+    char chunk[27] = "abcdefghijklmnopqrstuvwxyz";
+    kiln_string_t s = kiln_string_from_cstr("");
+    while (s.__length + 26 <= length) {
+        kiln_string_push_cstr(&s, chunk);
+    }
+    return s;
+}
+
+// Test that strings move to a mapping above the threshold and keep their contents as they grow
+void test_mapped_growth() {
+    if (kiln_string_get_map_threshold() == 0) {
+        return;
+    }
+    kiln_string_set_map_threshold(TEST_THRESHOLD);
+
+    kiln_string_t small = grow_to(1000);
+    assert(!is_mapped(&small));
+    kiln_string_free(&small);
+
+    kiln_string_t s = grow_to(TEST_THRESHOLD * 8);
+    assert(is_mapped(&s));
+    assert((s.__capacity & ~KILN_STRING_MAPPED) >= s.__length + 1);
+    check_pattern(&s);
+
+    // Reserve goes through the same path
+    assert(kiln_string_reserve(&s, TEST_THRESHOLD * 16));
+    assert((s.__capacity & ~KILN_STRING_MAPPED) >= s.__length + TEST_THRESHOLD * 16 + 1);
+    check_pattern(&s);
+
+    kiln_string_free(&s);
+    assert(s.ptr == NULL);
+
+    kiln_string_set_map_threshold(KILN_STRING_DEFAULT_MAP_THRESHOLD);
+}
+
+// Test shrink_to_fit, replace and trim on mapped strings
+void test_mapped_edits() {
+    if (kiln_string_get_map_threshold() == 0) {
+        return;
+    }
+    kiln_string_set_map_threshold(TEST_THRESHOLD);
+
+    // Shrinks in place while still above the threshold
+    kiln_string_t s = grow_to(TEST_THRESHOLD * 4);
+    assert(kiln_string_reserve(&s, TEST_THRESHOLD * 4));
+    kiln_string_shrink_to_fit(&s);
+    assert(is_mapped(&s));
+    assert((s.__capacity & ~KILN_STRING_MAPPED) < s.__length + 1 + 64 * 1024);
+    check_pattern(&s);
+
+    // ...and moves back to the heap below it
+    while (s.__length > 1000) {
+        assert(kiln_string_remove_suffix(&s, kstring_ref_from_cstr("abcdefghijklmnopqrstuvwxyz")));
+    }
+    kiln_string_shrink_to_fit(&s);
+    assert(!is_mapped(&s));
+    assert(s.__capacity == s.__length + 1);
+    check_pattern(&s);
+    kiln_string_free(&s);
+
+    // Replace builds a new heap buffer and releases the mapping
+    s = grow_to(TEST_THRESHOLD * 2);
+    assert(is_mapped(&s));
+    uint64_t length = s.__length;
+    kiln_string_replace(&s, "xyz", "XYZ!");
+    assert(s.__length == length + length / 26);
+    assert(kiln_string_starts_with(&s, "abcdefghijklmnopqrstuvwXYZ!abc"));
+    kiln_string_replace(&s, "XYZ!", "xyz");
+    check_pattern(&s);
+    kiln_string_free(&s);
+
+    // A shared string frees a mapped buffer it took over
+    s = grow_to(TEST_THRESHOLD * 2);
+    kiln_shared_string_t shared = kiln_shared_string_from_kiln_string(&s);
+    kiln_shared_string_t other = kiln_shared_string_clone(&shared);
+    kiln_shared_string_free(&shared);
+    assert(kstring_ref_starts_with(kiln_shared_string_view(&other), "abc"));
+    kiln_shared_string_free(&other);
+
+    kiln_string_set_map_threshold(KILN_STRING_DEFAULT_MAP_THRESHOLD);
+}
+
+// Test that a threshold of 0 keeps every string on the heap
+void test_mapped_disabled() {
+    kiln_string_set_map_threshold(0);
+    assert(kiln_string_get_map_threshold() == 0);
+    kiln_string_t s = grow_to(TEST_THRESHOLD * 4);
+    assert(!is_mapped(&s));
+    check_pattern(&s);
+    kiln_string_free(&s);
+    kiln_string_set_map_threshold(KILN_STRING_DEFAULT_MAP_THRESHOLD);
+}
+
+int main() {
+    printf("=== Large String Mapping Tests ===\n");
+
+    // Run all tests
+    run_test("Growth past the map threshold", test_mapped_growth);
+    run_test("Edits on mapped strings", test_mapped_edits);
+    run_test("Map threshold of 0", test_mapped_disabled);
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Serial leftmost non-overlapping matches, the behaviour the parallel versions must reproduce
+static size_t reference_find_all(const char* hay, size_t hay_len, const char* target, uint64_t* out) {
+    size_t target_len = strlen(target);
+    size_t count = 0;
+    size_t i = 0;
+    while (i + target_len <= hay_len) {
+        if (memcmp(hay + i, target, target_len) == 0) {
+            if (out) out[count] = i;
+            count++;
+            i += target_len;
+        } else {
+            i++;
+        }
+    }
+    return count;
+}
+
+static void check_matches(kstring_ref_t ref, const char* target, const kstring_par_config_t* config) {
+    uint64_t* expected = malloc((ref.__length + 1) * sizeof(uint64_t));
+    size_t expected_count = reference_find_all(ref.ptr, ref.__length, target, expected);
+
+    size_t count = 0;
+    uint64_t* positions = kstring_ref_par_find_all(ref, target, config, &count);
+    assert(count == expected_count);
+    for (size_t i = 0; i < count; i++) {
+        assert(positions[i] == expected[i]);
+    }
+    assert(kstring_ref_par_count(ref, target, config) == expected_count);
+
+    free(positions);
+    free(expected);
+}
+
+// Builds a large string with long runs of 'a' so self-overlapping needles straddle chunk boundaries
+static char* make_haystack(size_t length, unsigned int seed) {
+    char* buf = malloc(length + 1);
+    srand(seed);
+    size_t i = 0;
+    while (i < length) {
+        size_t run = (size_t)(rand() % 5000) + 1;
+        char c = "abc-"[rand() % 4];
+        for (size_t j = 0; j < run && i < length; j++, i++) {
+            buf[i] = (c == 'b' && j % 2) ? 'a' : c;
+        }
+    }
+    buf[length] = '\0';
+    return buf;
+}
+
+// Test kstring_ref_par_find_all and kstring_ref_par_count on small inputs
+void test_stringref_par_find_small() {
+    kstring_ref_t ref = kstring_ref_from_cstr("one two one two one");
+    size_t count = 0;
+    uint64_t* positions = kstring_ref_par_find_all(ref, "one", NULL, &count);
+    assert(count == 3);
+    assert(positions[0] == 0);
+    assert(positions[1] == 8);
+    assert(positions[2] == 16);
+    free(positions);
+
+    assert(kstring_ref_par_count(ref, "two", NULL) == 2);
+    assert(kstring_ref_par_count(ref, "three", NULL) == 0);
+    assert(kstring_ref_par_count(ref, "", NULL) == 0);
+
+    // Non-overlapping, like kiln_string_replace
+    assert(kstring_ref_par_count(kstring_ref_from_cstr("aaaaa"), "aa", NULL) == 2);
+
+    positions = kstring_ref_par_find_all(ref, "missing", NULL, &count);
+    assert(positions == NULL);
+    assert(count == 0);
+
+    // Needle longer than the haystack
+    assert(kstring_ref_par_count(kstring_ref_from_cstr("ab"), "abc", NULL) == 0);
+}
+
+// Test that matches crossing chunk boundaries are stitched exactly like a serial scan
+void test_stringref_par_find_chunked() {
+    size_t length = 640 * 1024 + 17;
+    char* hay = make_haystack(length, 5);
+    kstring_ref_t ref = { .ptr = hay, .__length = length };
+
+    kstring_par_config_t config = { .n_threads = 7, .serial_cutoff = 1024 };
+    const char* targets[] = { "a", "aa", "aaa", "abab", "c-", "ba", "-a-", "zzz", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" };
+    for (size_t i = 0; i < sizeof(targets) / sizeof(targets[0]); i++) {
+        check_matches(ref, targets[i], &config);
+    }
+
+    // Default configuration, and a cutoff above the input size (serial path)
+    check_matches(ref, "aa", NULL);
+    kstring_par_config_t serial = { .n_threads = 4, .serial_cutoff = length + 1 };
+    check_matches(ref, "aa", &serial);
+
+    free(hay);
+}
+
+// Test a haystack that is one long run, where chunk sequences never converge
+void test_stringref_par_find_uniform() {
+    size_t length = 256 * 1024 + 3;
+    char* hay = malloc(length);
+    memset(hay, 'a', length);
+    kstring_ref_t ref = { .ptr = hay, .__length = length };
+
+    kstring_par_config_t config = { .n_threads = 4, .serial_cutoff = 1 };
+    assert(kstring_ref_par_count(ref, "aa", &config) == length / 2);
+    assert(kstring_ref_par_count(ref, "aaa", &config) == length / 3);
+    check_matches(ref, "aaaa", &config);
+
+    free(hay);
+}
+
+// Test kiln_string_par_replace against kiln_string_replace
+void test_kilnstring_par_replace() {
+    size_t length = 640 * 1024 + 17;
+    char* hay = make_haystack(length, 11);
+    kstring_par_config_t config = { .n_threads = 6, .serial_cutoff = 1024 };
+
+    const char* cases[][2] = {
+        { "aa", "X" },
+        { "a", "" },
+        { "aaa", "longer replacement" },
+        { "c-", "-c" },
+        { "abab", "ba" },
+        { "zzz", "never" },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        kiln_string_t expected = kiln_string_from_cstr(hay);
+        kiln_string_replace(&expected, cases[i][0], cases[i][1]);
+
+        kiln_string_t actual = kiln_string_from_cstr(hay);
+        kiln_string_par_replace(&actual, cases[i][0], cases[i][1], &config);
+
+        assert(actual.__length == expected.__length);
+        assert(memcmp(actual.ptr, expected.ptr, actual.__length + 1) == 0);
+
+        kiln_string_free(&expected);
+        kiln_string_free(&actual);
+    }
+
+    // Small strings take the serial path
+    kiln_string_t small = kiln_string_from_cstr("one two one two one");
+    kiln_string_par_replace(&small, "one", "1", NULL);
+    assert(strcmp(small.ptr, "1 two 1 two 1") == 0);
+    kiln_string_par_replace(&small, "", "x", NULL);
+    assert(strcmp(small.ptr, "1 two 1 two 1") == 0);
+    kiln_string_free(&small);
+
+    free(hay);
+}
+
+int main() {
+    printf("=== Parallel Find Tests ===\n");
+
+    // Run all tests
+    run_test("kstring_ref_par_find_all small inputs", test_stringref_par_find_small);
+    run_test("kstring_ref_par_find_all chunk boundaries", test_stringref_par_find_chunked);
+    run_test("kstring_ref_par_count uniform input", test_stringref_par_find_uniform);
+    run_test("kiln_string_par_replace", test_kilnstring_par_replace);
+
+    return 0;
+}
@@ -229,6 +229,44 @@ void test_partition_edge_cases() {
     assert(result[1].__length == 0);
 }
 
+// Test kstring_ref_split and kstring_split_iter_next
+void test_stringref_split() {
+    const char* expected[] = { "a", "", "b", "cd", "" };
+    kstring_split_iter_t iter = kstring_ref_split(kstring_ref_from_cstr("a,,b,cd,"), KSTR(","));
+    kstring_ref_t piece;
+    size_t count = 0;
+    while (kstring_split_iter_next(&iter, &piece)) {
+        assert(count < 5);
+        assert(stringref_equals_cstr(piece, expected[count]));
+        count++;
+    }
+    assert(count == 5);
+    assert(!kstring_split_iter_next(&iter, &piece));
+
+    // Multi byte separator
+    iter = kstr_split("one::two::three", "::");
+    assert(kstring_split_iter_next(&iter, &piece) && stringref_equals_cstr(piece, "one"));
+    assert(kstring_split_iter_next(&iter, &piece) && stringref_equals_cstr(piece, "two"));
+    assert(kstring_split_iter_next(&iter, &piece) && stringref_equals_cstr(piece, "three"));
+    assert(!kstring_split_iter_next(&iter, &piece));
+
+    // No separator, empty separator and empty input all give one piece
+    iter = kstr_split("abc", "-");
+    assert(kstring_split_iter_next(&iter, &piece) && stringref_equals_cstr(piece, "abc"));
+    assert(!kstring_split_iter_next(&iter, &piece));
+    iter = kstr_split("abc", "");
+    assert(kstring_split_iter_next(&iter, &piece) && stringref_equals_cstr(piece, "abc"));
+    assert(!kstring_split_iter_next(&iter, &piece));
+    iter = kstr_split("", ",");
+    assert(kstring_split_iter_next(&iter, &piece) && piece.__length == 0);
+    assert(!kstring_split_iter_next(&iter, &piece));
+
+    // Separator longer than the input
+    iter = kstr_split("ab", "abc");
+    assert(kstring_split_iter_next(&iter, &piece) && stringref_equals_cstr(piece, "ab"));
+    assert(!kstring_split_iter_next(&iter, &piece));
+}
+
 int main() {
     printf("=== kiln_string_t Partition Tests ===\n");
     
@@ -237,6 +275,7 @@ int main() {
     run_test("kstring_ref_rpartition", test_stringref_rpartition);
     run_test("Compare partition methods", test_compare_partition_methods);
     run_test("Partition edge cases", test_partition_edge_cases);
+    run_test("kstring_ref_split", test_stringref_split);
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+typedef struct {
+    _Atomic uint32_t* hits;
+    atomic_size_t calls;
+} visit_ctx_t;
+
+static void visit_range(void* arg, size_t begin, size_t end) {
+    visit_ctx_t* ctx = arg;
+    assert(begin < end);
+    for (size_t i = begin; i < end; i++) {
+        atomic_fetch_add(&ctx->hits[i], 1);
+    }
+    atomic_fetch_add(&ctx->calls, 1);
+}
+
+static void check_parallel_for(kiln_pool_t* pool, size_t n, size_t grain) {
+    visit_ctx_t ctx = { .hits = calloc(n + 1, sizeof(uint32_t)) };
+    atomic_init(&ctx.calls, 0);
+    kiln_string_parallel_for(pool, n, grain, visit_range, &ctx);
+    for (size_t i = 0; i < n; i++) {
+        assert(atomic_load(&ctx.hits[i]) == 1);
+    }
+    if (grain != 0 && n != 0) {
+        assert(atomic_load(&ctx.calls) == (n + grain - 1) / grain);
+    }
+    free(ctx.hits);
+}
+
+// Test that kiln_string_parallel_for visits every item exactly once
+void test_pool_parallel_for() {
+    kiln_pool_t* pool = kiln_pool_new(4);
+    assert(pool != NULL);
+    assert(kiln_pool_thread_count(pool) == 4);
+    assert(kiln_pool_thread_count(NULL) >= 1);
+
+    size_t sizes[] = { 0, 1, 2, 3, 7, 100, 1000, 100003 };
+    size_t grains[] = { 0, 1, 3, 64, 1000000 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (size_t j = 0; j < sizeof(grains) / sizeof(grains[0]); j++) {
+            check_parallel_for(pool, sizes[i], grains[j]);
+            check_parallel_for(NULL, sizes[i], grains[j]);
+        }
+    }
+
+    // The pool is reusable for many small jobs
+    for (int round = 0; round < 200; round++) {
+        check_parallel_for(pool, 37, 1);
+    }
+
+    kiln_pool_free(pool);
+    kiln_pool_free(NULL);
+
+    kiln_pool_t* single = kiln_pool_new(1);
+    assert(kiln_pool_thread_count(single) == 1);
+    check_parallel_for(single, 1000, 7);
+    kiln_pool_free(single);
+}
+
+typedef struct {
+    kiln_pool_t* pool;
+    _Atomic uint32_t* hits;
+} nested_ctx_t;
+
+static void nested_inner(void* arg, size_t begin, size_t end) {
+    nested_ctx_t* ctx = arg;
+    for (size_t i = begin; i < end; i++) {
+        atomic_fetch_add(&ctx->hits[i], 1);
+    }
+}
+
+static void nested_outer(void* arg, size_t begin, size_t end) {
+    nested_ctx_t* ctx = arg;
+    for (size_t i = begin; i < end; i++) {
+        nested_ctx_t inner = { .pool = ctx->pool, .hits = ctx->hits + i * 10 };
+        kiln_string_parallel_for(ctx->pool, 10, 1, nested_inner, &inner);
+    }
+}
+
+// Test that a parallel_for started from inside a task runs serially instead of deadlocking
+void test_pool_nested() {
+    kiln_pool_t* pool = kiln_pool_new(3);
+    _Atomic uint32_t hits[500] = { 0 };
+    nested_ctx_t ctx = { .pool = pool, .hits = hits };
+    kiln_string_parallel_for(pool, 50, 1, nested_outer, &ctx);
+    for (size_t i = 0; i < 500; i++) {
+        assert(atomic_load(&hits[i]) == 1);
+    }
+    kiln_pool_free(pool);
+}
+
+// Builds strings of very different sizes so byte-based chunking matters
+static kiln_string_t* make_strings(size_t n) {
+    kiln_string_t* strings = malloc(n * sizeof(kiln_string_t));
+    char buf[64];
+    for (size_t i = 0; i < n; i++) {
+        size_t repeat = i % 97 == 0 ? 2000 : 1;
+        strings[i] = kiln_string_from_cstr("");
+        snprintf(buf, sizeof(buf), "  Item %zu: Hello World  ", i);
+        for (size_t r = 0; r < repeat; r++) {
+            kiln_string_push_cstr(&strings[i], buf);
+        }
+    }
+    return strings;
+}
+
+static void free_strings(kiln_string_t* strings, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        kiln_string_free(&strings[i]);
+    }
+    free(strings);
+}
+
+typedef struct {
+    size_t* lengths;
+} length_ctx_t;
+
+static void record_length(kiln_string_t* string, size_t index, void* arg) {
+    length_ctx_t* ctx = arg;
+    ctx->lengths[index] = string->__length;
+}
+
+// Test that the map operations give the same results as a serial loop, in input order
+void test_pool_string_maps() {
+    kiln_pool_t* pool = kiln_pool_new(4);
+    size_t n = 3000;
+    kiln_string_t* expected = make_strings(n);
+    kiln_string_t* actual = make_strings(n);
+
+    for (size_t i = 0; i < n; i++) {
+        kiln_string_trim_inplace(&expected[i]);
+        kiln_string_to_ascii_lower(&expected[i]);
+        kiln_string_replace(&expected[i], "world", "kiln");
+    }
+    kiln_string_parallel_trim_inplace(pool, actual, n);
+    kiln_string_parallel_to_ascii_lower(pool, actual, n);
+    kiln_string_parallel_replace(pool, actual, n, "world", "kiln");
+    for (size_t i = 0; i < n; i++) {
+        assert(kiln_string_equals(&actual[i], &expected[i]));
+    }
+
+    kiln_string_parallel_to_ascii_upper(NULL, actual, n);
+    assert(strncmp(actual[1].ptr, "ITEM 1: HELLO KILN", 18) == 0);
+
+    length_ctx_t ctx = { .lengths = malloc(n * sizeof(size_t)) };
+    kiln_string_parallel_map(pool, actual, n, record_length, &ctx);
+    for (size_t i = 0; i < n; i++) {
+        assert(ctx.lengths[i] == actual[i].__length);
+    }
+    free(ctx.lengths);
+
+    kiln_string_parallel_map(pool, actual, 0, record_length, NULL);
+
+    free_strings(expected, n);
+    free_strings(actual, n);
+    kiln_pool_free(pool);
+}
+
+// Test kstring_ref_parallel_hash against kstring_ref_hash
+void test_pool_ref_hash() {
+    kiln_pool_t* pool = kiln_pool_new(4);
+    size_t n = 5000;
+    kiln_string_t* strings = make_strings(n);
+    kstring_ref_t* refs = malloc(n * sizeof(kstring_ref_t));
+    for (size_t i = 0; i < n; i++) {
+        refs[i] = kstring_ref_from_kiln_string(&strings[i]);
+    }
+
+    uint64_t* hashes = malloc(n * sizeof(uint64_t));
+    kstring_ref_parallel_hash(pool, refs, n, hashes);
+    for (size_t i = 0; i < n; i++) {
+        assert(hashes[i] == kstring_ref_hash(refs[i]));
+    }
+
+    memset(hashes, 0, n * sizeof(uint64_t));
+    kstring_ref_parallel_hash(NULL, refs, n, hashes);
+    for (size_t i = 0; i < n; i++) {
+        assert(hashes[i] == kstring_ref_hash(refs[i]));
+    }
+
+    free(hashes);
+    free(refs);
+    free_strings(strings, n);
+    kiln_pool_free(pool);
+}
+
+int main() {
+    printf("=== Thread Pool Tests ===\n");
+
+    // Run all tests
+    run_test("kiln_string_parallel_for", test_pool_parallel_for);
+    run_test("kiln_string_parallel_for nested", test_pool_nested);
+    run_test("kiln_string_parallel_map", test_pool_string_maps);
+    run_test("kstring_ref_parallel_hash", test_pool_ref_hash);
+
+    return 0;
+}
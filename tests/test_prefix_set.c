@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+static kstring_ref_t R(const char* s) {
+    return kstring_ref_from_cstr((char*)s);
+}
+
+// Test kstring_prefix_set_match_longest and match_any
+void test_prefix_set_match() {
+    kstring_ref_t prefixes[] = { R("/api/"), R("/api/v2/"), R("/static/"), R("/api/v2/users"), R("/a") };
+    kstring_prefix_set_t set = kstring_prefix_set_new(prefixes, 5);
+
+    assert(kstring_prefix_set_match_longest(&set, R("/api/v2/users/17")) == 3);
+    assert(kstring_prefix_set_match_longest(&set, R("/api/v2/orders")) == 1);
+    assert(kstring_prefix_set_match_longest(&set, R("/api/v1")) == 0);
+    assert(kstring_prefix_set_match_longest(&set, R("/static/app.js")) == 2);
+    assert(kstring_prefix_set_match_longest(&set, R("/ap")) == 4);
+    assert(kstring_prefix_set_match_longest(&set, R("/b")) == -1);
+    assert(kstring_prefix_set_match_longest(&set, R("")) == -1);
+
+    assert(kstring_prefix_set_match_any(&set, R("/api")));
+    assert(!kstring_prefix_set_match_any(&set, R("/")));
+    assert(!kstring_prefix_set_match_any(&set, R("static/")));
+
+    kstring_prefix_set_free(&set);
+    assert(kstring_prefix_set_match_longest(&set, R("/api/")) == -1);
+}
+
+// Test duplicates, the empty prefix and the empty set
+void test_prefix_set_edge_cases() {
+    kstring_ref_t prefixes[] = { R("ab"), R(""), R("ab") };
+    kstring_prefix_set_t set = kstring_prefix_set_new(prefixes, 3);
+    assert(kstring_prefix_set_match_longest(&set, R("abc")) == 0);
+    assert(kstring_prefix_set_match_longest(&set, R("xyz")) == 1);
+    assert(kstring_prefix_set_match_any(&set, R("")));
+    kstring_prefix_set_free(&set);
+
+    kstring_prefix_set_t empty = kstring_prefix_set_new(NULL, 0);
+    assert(kstring_prefix_set_match_longest(&empty, R("anything")) == -1);
+    assert(!kstring_prefix_set_match_any(&empty, R("")));
+    kstring_prefix_set_free(&empty);
+
+    // Bytes with the high bit set and embedded NULs are ordinary labels
+    char raw[] = { 'x', '\0', (char)0xff };
+    kstring_ref_t binary[] = { { .ptr = raw, .__length = 3 }, R("x") };
+    set = kstring_prefix_set_new(binary, 2);
+    kstring_ref_t probe = { .ptr = raw, .__length = 3 };
+    assert(kstring_prefix_set_match_longest(&set, probe) == 0);
+    probe.__length = 2;
+    assert(kstring_prefix_set_match_longest(&set, probe) == 1);
+    kstring_prefix_set_free(&set);
+}
+
+// Test kstring_suffix_set_t for extension routing
+void test_suffix_set_match() {
+    kstring_ref_t suffixes[] = { R(".gz"), R(".tar.gz"), R(".log"), R(".js") };
+    kstring_suffix_set_t set = kstring_suffix_set_new(suffixes, 4);
+
+    assert(kstring_suffix_set_match_longest(&set, R("backup.tar.gz")) == 1);
+    assert(kstring_suffix_set_match_longest(&set, R("access.log.gz")) == 0);
+    assert(kstring_suffix_set_match_longest(&set, R("app.log")) == 2);
+    assert(kstring_suffix_set_match_longest(&set, R("app.json")) == -1);
+    assert(kstring_suffix_set_match_any(&set, R("bundle.min.js")));
+    assert(!kstring_suffix_set_match_any(&set, R("gz")));
+
+    kstring_suffix_set_free(&set);
+}
+
+// Test against repeated starts_with / ends_with calls on random data
+void test_prefix_set_random() {
+    srand(35);
+    enum { N_PREFIXES = 300, N_PROBES = 3000 };
+    char storage[N_PREFIXES][8];
+    kstring_ref_t prefixes[N_PREFIXES];
+    for (int i = 0; i < N_PREFIXES; i++) {
+        int len = rand() % 7;
+        for (int j = 0; j < len; j++) {
+            storage[i][j] = "abc"[rand() % 3];
+        }
+        storage[i][len] = '\0';
+        prefixes[i] = R(storage[i]);
+    }
+
+    kstring_prefix_set_t pset = kstring_prefix_set_new(prefixes, N_PREFIXES);
+    kstring_suffix_set_t sset = kstring_suffix_set_new(prefixes, N_PREFIXES);
+
+    char probe[16];
+    for (int iter = 0; iter < N_PROBES; iter++) {
+        int len = rand() % 12;
+        for (int j = 0; j < len; j++) {
+            probe[j] = "abcd"[rand() % 4];
+        }
+        probe[len] = '\0';
+        kstring_ref_t ref = R(probe);
+
+        int64_t best_prefix = -1, best_suffix = -1;
+        for (int i = 0; i < N_PREFIXES; i++) {
+            if (kstring_ref_starts_with(ref, storage[i]) && (best_prefix < 0 || prefixes[i].__length > prefixes[best_prefix].__length)) {
+                best_prefix = i;
+            }
+            if (kstring_ref_ends_with(ref, storage[i]) && (best_suffix < 0 || prefixes[i].__length > prefixes[best_suffix].__length)) {
+                best_suffix = i;
+            }
+        }
+
+        assert(kstring_prefix_set_match_longest(&pset, ref) == best_prefix);
+        assert(kstring_suffix_set_match_longest(&sset, ref) == best_suffix);
+        assert(kstring_prefix_set_match_any(&pset, ref) == (best_prefix >= 0));
+        assert(kstring_suffix_set_match_any(&sset, ref) == (best_suffix >= 0));
+    }
+
+    kstring_prefix_set_free(&pset);
+    kstring_suffix_set_free(&sset);
+}
+
+int main() {
+    printf("=== Prefix Set Tests ===\n");
+
+    // Run all tests
+    run_test("kstring_prefix_set_match_longest", test_prefix_set_match);
+    run_test("Prefix set edge cases", test_prefix_set_edge_cases);
+    run_test("kstring_suffix_set_match_longest", test_suffix_set_match);
+    run_test("Prefix and suffix sets on random data", test_prefix_set_random);
+
+    return 0;
+}
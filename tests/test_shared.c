@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Test that clones share one buffer and the last free releases it
+void test_shared_clone_free() {
+    kiln_shared_string_t a = kiln_shared_string_from_cstr("payload");
+    assert(kiln_shared_string_use_count(&a) == 1);
+
+    kiln_shared_string_t b = kiln_shared_string_clone(&a);
+    kiln_shared_string_t c = kiln_shared_string_clone(&b);
+    assert(kiln_shared_string_use_count(&a) == 3);
+    assert(kiln_shared_string_view(&a).ptr == kiln_shared_string_view(&c).ptr);
+    assert(kstring_ref_equals_cstr(kiln_shared_string_view(&c), "payload"));
+
+    kiln_shared_string_free(&a);
+    assert(a.__block == NULL);
+    assert(kiln_shared_string_use_count(&a) == 0);
+    assert(kiln_shared_string_view(&a).__length == 0);
+    assert(kiln_shared_string_use_count(&b) == 2);
+
+    kiln_shared_string_free(&b);
+    kiln_shared_string_free(&c);
+    kiln_shared_string_free(&c);
+}
+
+// Test that mutating one handle copies the buffer and leaves the others untouched
+void test_shared_copy_on_write() {
+    kiln_shared_string_t a = kiln_shared_string_from_kstring_ref(kstring_ref_from_cstr("  Hello World  "));
+    kiln_shared_string_t b = kiln_shared_string_clone(&a);
+    const char* original = kiln_shared_string_view(&a).ptr;
+
+    kiln_shared_string_trim_inplace(&b);
+    kiln_shared_string_to_ascii_upper(&b);
+    kiln_shared_string_push_cstr(&b, "!");
+    kiln_shared_string_replace(&b, "WORLD", "There");
+
+    assert(kstring_ref_equals_cstr(kiln_shared_string_view(&b), "HELLO There!"));
+    assert(kstring_ref_equals_cstr(kiln_shared_string_view(&a), "  Hello World  "));
+    assert(kiln_shared_string_view(&a).ptr == original);
+    assert(kiln_shared_string_use_count(&a) == 1);
+    assert(kiln_shared_string_use_count(&b) == 1);
+
+    // A unique handle is modified in place
+    const char* before = kiln_shared_string_view(&a).ptr;
+    kiln_shared_string_to_ascii_lower(&a);
+    assert(kiln_shared_string_view(&a).ptr == before);
+    assert(kstring_ref_equals_cstr(kiln_shared_string_view(&a), "  hello world  "));
+
+    kiln_shared_string_free(&a);
+    kiln_shared_string_free(&b);
+}
+
+// Test that no-op edits on a shared handle don't copy
+void test_shared_noop_edits() {
+    kiln_shared_string_t a = kiln_shared_string_from_cstr("no spaces");
+    kiln_shared_string_t b = kiln_shared_string_clone(&a);
+
+    kiln_shared_string_trim_inplace(&b);
+    kiln_shared_string_replace(&b, "missing", "x");
+    kiln_shared_string_replace(&b, "", "x");
+    kiln_shared_string_push_cstr(&b, "");
+    assert(kiln_shared_string_use_count(&a) == 2);
+    assert(kiln_shared_string_view(&a).ptr == kiln_shared_string_view(&b).ptr);
+
+    kiln_string_t* mut = kiln_shared_string_make_mut(&b);
+    assert(mut != NULL);
+    kiln_string_to_unicode_upper(mut);
+    assert(kiln_string_equals_cstr(mut, "NO SPACES"));
+    assert(kstring_ref_equals_cstr(kiln_shared_string_view(&a), "no spaces"));
+
+    kiln_shared_string_free(&a);
+    kiln_shared_string_free(&b);
+}
+
+// Test taking over an existing kiln_string_t
+void test_shared_from_kiln_string() {
+    kiln_string_t s = kiln_string_from_cstr("moved");
+    char* buffer = s.ptr;
+    kiln_shared_string_t shared = kiln_shared_string_from_kiln_string(&s);
+    assert(s.ptr == NULL);
+    assert(kiln_shared_string_view(&shared).ptr == buffer);
+    kiln_shared_string_free(&shared);
+}
+
+static void* clone_and_free(void* arg) {
+    kiln_shared_string_t* shared = arg;
+    for (int i = 0; i < 20000; i++) {
+        kiln_shared_string_t mine = kiln_shared_string_clone(shared);
+        assert(kiln_shared_string_view(&mine).__length == 9);
+        if (i % 1000 == 0) {
+            kiln_shared_string_push_cstr(&mine, "!");
+            assert(kiln_shared_string_view(&mine).__length == 10);
+        }
+        kiln_shared_string_free(&mine);
+    }
+    return NULL;
+}
+
+// Test concurrent clones and frees of one buffer
+void test_shared_threads() {
+    kiln_shared_string_t shared = kiln_shared_string_from_cstr("broadcast");
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, clone_and_free, &shared);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    assert(kiln_shared_string_use_count(&shared) == 1);
+    assert(kstring_ref_equals_cstr(kiln_shared_string_view(&shared), "broadcast"));
+    kiln_shared_string_free(&shared);
+}
+
+int main() {
+    printf("=== Shared String Tests ===\n");
+
+    // Run all tests
+    run_test("kiln_shared_string_clone and free", test_shared_clone_free);
+    run_test("Copy on write", test_shared_copy_on_write);
+    run_test("No-op edits don't copy", test_shared_noop_edits);
+    run_test("kiln_shared_string_from_kiln_string", test_shared_from_kiln_string);
+    run_test("Concurrent clone and free", test_shared_threads);
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+static int ref_cmp(const void* a, const void* b) {
+    return kstring_ref_compare(*(const kstring_ref_t*)a, *(const kstring_ref_t*)b);
+}
+
+static bool is_sorted(const kstring_ref_t* refs, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        if (kstring_ref_compare(refs[i - 1], refs[i]) > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Builds `n` random strings over a tiny alphabet so there are lots of shared prefixes and duplicates
+static char* make_random_refs(kstring_ref_t* refs, size_t n, size_t max_len, unsigned int seed) {
+    char* pool = malloc(n * max_len + 1);
+    srand(seed);
+    for (size_t i = 0; i < n; i++) {
+        size_t len = (size_t)rand() % (max_len + 1);
+        char* p = pool + i * max_len;
+        for (size_t j = 0; j < len; j++) {
+            p[j] = "ab\0z"[rand() % 4];
+        }
+        refs[i] = (kstring_ref_t){ .ptr = p, .__length = len };
+    }
+    return pool;
+}
+
+// Test kstring_ref_sort
+void test_stringref_sort() {
+    kstring_ref_t refs[] = {
+        kstring_ref_from_cstr("pear"),
+        kstring_ref_from_cstr("apple"),
+        kstring_ref_from_cstr(""),
+        kstring_ref_from_cstr("apple pie with cream"),
+        kstring_ref_from_cstr("apple pie with cheese"),
+        kstring_ref_from_cstr("banana"),
+        kstring_ref_from_cstr("app"),
+    };
+    size_t n = sizeof(refs) / sizeof(refs[0]);
+    kstring_ref_sort(refs, n);
+
+    assert(kstring_ref_equals_cstr(refs[0], ""));
+    assert(kstring_ref_equals_cstr(refs[1], "app"));
+    assert(kstring_ref_equals_cstr(refs[2], "apple"));
+    assert(kstring_ref_equals_cstr(refs[3], "apple pie with cheese"));
+    assert(kstring_ref_equals_cstr(refs[4], "apple pie with cream"));
+    assert(kstring_ref_equals_cstr(refs[5], "banana"));
+    assert(kstring_ref_equals_cstr(refs[6], "pear"));
+
+    // Empty and single element arrays
+    kstring_ref_sort(refs, 0);
+    kstring_ref_sort(refs, 1);
+
+    // Embedded NUL bytes must sort by length, "ab" < "ab\0" < "ab\0\0\0\0\0\0\0x"
+    kstring_ref_t nuls[] = {
+        { .ptr = "ab\0\0\0\0\0\0\0x", .__length = 10 },
+        { .ptr = "ab\0", .__length = 3 },
+        { .ptr = "ab", .__length = 2 },
+    };
+    kstring_ref_sort(nuls, 3);
+    assert(nuls[0].__length == 2);
+    assert(nuls[1].__length == 3);
+    assert(nuls[2].__length == 10);
+}
+
+// Test that kstring_ref_sort agrees with qsort + kstring_ref_compare on random input
+void test_stringref_sort_random() {
+    size_t n = 5000;
+    kstring_ref_t* refs = malloc(n * sizeof(kstring_ref_t));
+    kstring_ref_t* expected = malloc(n * sizeof(kstring_ref_t));
+    char* pool = make_random_refs(refs, n, 24, 42);
+
+    memcpy(expected, refs, n * sizeof(kstring_ref_t));
+    qsort(expected, n, sizeof(kstring_ref_t), ref_cmp);
+    kstring_ref_sort(refs, n);
+
+    for (size_t i = 0; i < n; i++) {
+        assert(kstring_ref_compare(refs[i], expected[i]) == 0);
+    }
+
+    free(pool);
+    free(refs);
+    free(expected);
+}
+
+// Test kstring_ref_sort_stable
+void test_stringref_sort_stable() {
+    // Same contents in separate buffers, so the original order is visible through the pointers
+    char a1[] = "same", a2[] = "same", a3[] = "same";
+    kstring_ref_t refs[] = {
+        kstring_ref_from_cstr(a1),
+        kstring_ref_from_cstr("other"),
+        kstring_ref_from_cstr(a2),
+        kstring_ref_from_cstr("first"),
+        kstring_ref_from_cstr(a3),
+    };
+    kstring_ref_sort_stable(refs, 5);
+
+    assert(kstring_ref_equals_cstr(refs[0], "first"));
+    assert(kstring_ref_equals_cstr(refs[1], "other"));
+    assert(refs[2].ptr == a1);
+    assert(refs[3].ptr == a2);
+    assert(refs[4].ptr == a3);
+
+    size_t n = 3000;
+    kstring_ref_t* many = malloc(n * sizeof(kstring_ref_t));
+    char* pool = make_random_refs(many, n, 6, 7);
+    kstring_ref_sort_stable(many, n);
+    assert(is_sorted(many, n));
+    for (size_t i = 1; i < n; i++) {
+        if (kstring_ref_compare(many[i - 1], many[i]) == 0) {
+            assert(many[i - 1].ptr < many[i].ptr);
+        }
+    }
+    free(pool);
+    free(many);
+}
+
+// Test kstring_ref_sort_unique
+void test_stringref_sort_unique() {
+    char d1[] = "dup", d2[] = "dup";
+    kstring_ref_t refs[] = {
+        kstring_ref_from_cstr(d1),
+        kstring_ref_from_cstr("b"),
+        kstring_ref_from_cstr("a"),
+        kstring_ref_from_cstr(d2),
+        kstring_ref_from_cstr("b"),
+    };
+    size_t n = kstring_ref_sort_unique(refs, 5);
+
+    assert(n == 3);
+    assert(kstring_ref_equals_cstr(refs[0], "a"));
+    assert(kstring_ref_equals_cstr(refs[1], "b"));
+    assert(kstring_ref_equals_cstr(refs[2], "dup"));
+    assert(refs[2].ptr == d1);
+
+    assert(kstring_ref_sort_unique(refs, 0) == 0);
+}
+
+// Test kstring_ref_sort_parallel
+void test_stringref_sort_parallel() {
+    size_t n = 100000;
+    kstring_ref_t* refs = malloc(n * sizeof(kstring_ref_t));
+    kstring_ref_t* expected = malloc(n * sizeof(kstring_ref_t));
+    char* pool = make_random_refs(refs, n, 16, 1234);
+
+    memcpy(expected, refs, n * sizeof(kstring_ref_t));
+    qsort(expected, n, sizeof(kstring_ref_t), ref_cmp);
+
+    kstring_ref_sort_parallel(refs, n, 4);
+    for (size_t i = 0; i < n; i++) {
+        assert(kstring_ref_compare(refs[i], expected[i]) == 0);
+    }
+
+    // Default thread count, and small inputs that stay on the calling thread
+    make_random_refs(refs, n, 16, 99);
+    kstring_ref_sort_parallel(refs, n, 0);
+    assert(is_sorted(refs, n));
+    kstring_ref_sort_parallel(refs, 10, 8);
+    assert(is_sorted(refs, 10));
+
+    free(pool);
+    free(refs);
+    free(expected);
+}
+
+int main() {
+    printf("=== kstring_ref_t Sort Tests ===\n");
+
+    // Run all tests
+    run_test("kstring_ref_sort", test_stringref_sort);
+    run_test("kstring_ref_sort random", test_stringref_sort_random);
+    run_test("kstring_ref_sort_stable", test_stringref_sort_stable);
+    run_test("kstring_ref_sort_unique", test_stringref_sort_unique);
+    run_test("kstring_ref_sort_parallel", test_stringref_sort_parallel);
+
+    return 0;
+}
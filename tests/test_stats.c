@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include "../include/kiln_string.h"
+
+// These tests check real numbers when the library and the test are compiled
+// with -DKILN_STRING_STATS, and that every counter stays 0 otherwise.
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+// Test that constructors count one allocation and one copy
+void test_stats_constructors() {
+    kiln_string_stats_reset();
+
+    kiln_string_t a = kiln_string_from_cstr("hello");
+    kiln_string_t b = kiln_string_from_kstring_ref(kstring_ref_from_cstr("world!"));
+    kiln_string_t c = kiln_string_with_capacity(32);
+
+    kiln_string_stats_t stats = kiln_string_stats_snapshot();
+#ifdef KILN_STRING_STATS
+    assert(stats.allocations == 3);
+    assert(stats.reallocations == 0);
+    assert(stats.bytes_allocated == 6 + 7 + 32);
+    assert(stats.bytes_copied == 5 + 6);
+#else
+    assert(stats.allocations == 0);
+    assert(stats.bytes_allocated == 0);
+    assert(stats.bytes_copied == 0);
+#endif
+
+    kiln_string_free(&a);
+    kiln_string_free(&b);
+    kiln_string_free(&c);
+}
+
+// Test that pushes count growth events, reallocations and slack
+void test_stats_push() {
+    kiln_string_t s = kiln_string_with_capacity(4);
+    s.ptr[0] = '\0';
+    kiln_string_stats_reset();
+
+    kiln_string_push_cstr(&s, "ab");       // fits in 4
+    kiln_string_push_cstr(&s, "cdef");     // needs 7, doubles to 8
+    kiln_string_push_cstr(&s, "ghijklmn"); // needs 15, doubles to 16
+
+    kiln_string_stats_t stats = kiln_string_stats_snapshot();
+    assert(strcmp(s.ptr, "abcdefghijklmn") == 0);
+#ifdef KILN_STRING_STATS
+    assert(stats.allocations == 0);
+    assert(stats.reallocations == 2);
+    assert(stats.growth_events == 2);
+    assert(stats.bytes_allocated == 8 + 16);
+    assert(stats.capacity_slack == (8 - 7) + (16 - 15));
+    assert(stats.bytes_copied == 2 + 4 + 8);
+#else
+    assert(stats.reallocations == 0);
+    assert(stats.growth_events == 0);
+#endif
+
+    kiln_string_free(&s);
+}
+
+// Test that replace and in place edits count their copies and moves
+void test_stats_replace_trim() {
+    kiln_string_t s = kiln_string_from_cstr("  one two one  ");
+    kiln_string_stats_reset();
+
+    kiln_string_trim_inplace(&s);
+    kiln_string_replace(&s, "one", "1");
+    kiln_string_remove_prefix(&s, kstring_ref_from_cstr("1 "));
+    assert(kiln_string_equals_cstr(&s, "two 1"));
+
+    kiln_string_stats_t stats = kiln_string_stats_snapshot();
+#ifdef KILN_STRING_STATS
+    assert(stats.allocations == 1);
+    assert(stats.bytes_moved == strlen("one two one") + strlen("two 1"));
+    assert(stats.bytes_copied == strlen("1 two 1"));
+#else
+    assert(stats.allocations == 0);
+    assert(stats.bytes_moved == 0);
+#endif
+
+    kiln_string_stats_reset();
+    stats = kiln_string_stats_snapshot();
+    assert(stats.allocations == 0 && stats.bytes_moved == 0 && stats.bytes_copied == 0);
+
+    kiln_string_free(&s);
+}
+
+int main() {
+    printf("=== Allocation Stats Tests ===\n");
+
+    // Run all tests
+    run_test("Constructors", test_stats_constructors);
+    run_test("kiln_string_push_cstr", test_stats_push);
+    run_test("Replace and trim", test_stats_replace_trim);
+
+    return 0;
+}
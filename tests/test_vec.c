@@ -0,0 +1,322 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "../include/kiln_string.h"
+
+// Test helper function to print test name
+void run_test(const char* test_name, void (*test_func)(void)) {
+    printf("Running: %s\n", test_name);
+    test_func();
+    printf("  ✓ PASSED\n");
+}
+
+static bool ref_equals_cstr(kstring_ref_t ref, const char* expected) {
+    return ref.__length == strlen(expected) && memcmp(ref.ptr, expected, ref.__length) == 0;
+}
+
+// Test pushing strings and reading them back
+void test_vec_push_get() {
+    kiln_string_vec_t vec = kiln_string_vec_new();
+    assert(kiln_string_vec_len(&vec) == 0);
+    assert(kiln_string_vec_data_len(&vec) == 0);
+    assert(kiln_string_vec_offsets(&vec)[0] == 0);
+
+    kiln_string_vec_push(&vec, KSTR("hello"));
+    kiln_string_vec_push(&vec, KSTR(""));
+    kiln_string_vec_push(&vec, KSTR("world"));
+    kiln_string_vec_push(&vec, (kstring_ref_t){ .ptr = NULL, .__length = 0 });
+
+    assert(kiln_string_vec_len(&vec) == 4);
+    assert(ref_equals_cstr(kiln_string_vec_get(&vec, 0), "hello"));
+    assert(kiln_string_vec_get(&vec, 1).__length == 0);
+    assert(ref_equals_cstr(kiln_string_vec_get(&vec, 2), "world"));
+    assert(kiln_string_vec_get(&vec, 3).__length == 0);
+
+    // Arrow layout: one blob plus len + 1 offsets
+    assert(kiln_string_vec_data_len(&vec) == 10);
+    assert(memcmp(kiln_string_vec_data(&vec), "helloworld", 10) == 0);
+    const uint64_t* offsets = kiln_string_vec_offsets(&vec);
+    assert(offsets[0] == 0 && offsets[1] == 5 && offsets[2] == 5 && offsets[3] == 10 && offsets[4] == 10);
+
+    uint32_t offsets32[5];
+    assert(kiln_string_vec_export_offsets32(&vec, offsets32));
+    for (size_t i = 0; i < 5; i++) {
+        assert(offsets32[i] == offsets[i]);
+    }
+
+    kiln_string_vec_clear(&vec);
+    assert(kiln_string_vec_len(&vec) == 0);
+    assert(kiln_string_vec_data_len(&vec) == 0);
+    kiln_string_vec_push(&vec, KSTR("again"));
+    assert(kiln_string_vec_len(&vec) == 1);
+    assert(ref_equals_cstr(kiln_string_vec_get(&vec, 0), "again"));
+
+    kiln_string_vec_free(&vec);
+    assert(kiln_string_vec_len(&vec) == 0);
+    kiln_string_vec_free(&vec);
+}
+
+// Test many strings, with and without reserving first
+void test_vec_many() {
+    size_t n = 100000;
+    char buf[32];
+
+    kiln_string_vec_t grown = kiln_string_vec_new();
+    kiln_string_vec_t reserved = kiln_string_vec_with_capacity(16, 16);
+    assert(kiln_string_vec_reserve(&reserved, n, n * 12));
+    const char* data_before = kiln_string_vec_data(&reserved);
+    const uint64_t* offsets_before = kiln_string_vec_offsets(&reserved);
+
+    for (size_t i = 0; i < n; i++) {
+        int len = snprintf(buf, sizeof(buf), "s%zu", i * 7919);
+        kstring_ref_t ref = { .ptr = buf, .__length = (uint64_t)len };
+        kiln_string_vec_push(&grown, ref);
+        kiln_string_vec_push(&reserved, ref);
+    }
+
+    // Everything fit in the reservation
+    assert(kiln_string_vec_data(&reserved) == data_before);
+    assert(kiln_string_vec_offsets(&reserved) == offsets_before);
+
+    assert(kiln_string_vec_len(&grown) == n);
+    for (size_t i = 0; i < n; i += 997) {
+        snprintf(buf, sizeof(buf), "s%zu", i * 7919);
+        assert(ref_equals_cstr(kiln_string_vec_get(&grown, i), buf));
+        assert(ref_equals_cstr(kiln_string_vec_get(&reserved, i), buf));
+        assert(kiln_string_vec_index_of(&grown, kstring_ref_from_cstr(buf)) == (int64_t)i);
+    }
+    assert(kiln_string_vec_index_of(&grown, KSTR("s1")) == -1);
+    assert(kiln_string_vec_index_of(&grown, KSTR("")) == -1);
+
+    kiln_string_vec_free(&grown);
+    kiln_string_vec_free(&reserved);
+}
+
+// Test bulk pushes from a split iterator
+void test_vec_push_split() {
+    kiln_string_vec_t vec = kiln_string_vec_new();
+    kiln_string_vec_push(&vec, KSTR("header"));
+
+    kstring_split_iter_t iter = kstr_split("alpha\nbeta\n\ngamma", "\n");
+    assert(kiln_string_vec_push_split(&vec, &iter) == 4);
+    assert(kiln_string_vec_push_split(&vec, &iter) == 0);
+
+    assert(kiln_string_vec_len(&vec) == 5);
+    assert(ref_equals_cstr(kiln_string_vec_get(&vec, 0), "header"));
+    assert(ref_equals_cstr(kiln_string_vec_get(&vec, 1), "alpha"));
+    assert(ref_equals_cstr(kiln_string_vec_get(&vec, 2), "beta"));
+    assert(kiln_string_vec_get(&vec, 3).__length == 0);
+    assert(ref_equals_cstr(kiln_string_vec_get(&vec, 4), "gamma"));
+    assert(kiln_string_vec_index_of(&vec, KSTR("")) == 3);
+
+    // A large input, split on a two byte separator
+    size_t n = 20000;
+    kiln_string_t input = kiln_string_from_cstr("");
+    char buf[32];
+    for (size_t i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), i + 1 < n ? "row%zu\r\n" : "row%zu", i);
+        kiln_string_push_cstr(&input, buf);
+    }
+    kiln_string_vec_clear(&vec);
+    iter = kstring_ref_split(kstring_ref_from_kiln_string(&input), KSTR("\r\n"));
+    assert(kiln_string_vec_push_split(&vec, &iter) == n);
+    for (size_t i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "row%zu", i);
+        assert(ref_equals_cstr(kiln_string_vec_get(&vec, i), buf));
+    }
+
+    kiln_string_free(&input);
+    kiln_string_vec_free(&vec);
+}
+
+static char* temp_path(void) {
+    static char path[] = "/tmp/kiln_vec_XXXXXX";
+    strcpy(path + strlen(path) - 6, "XXXXXX");
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    return path;
+}
+
+static char* read_file(const char* path, size_t* size) {
+    FILE* f = fopen(path, "rb");
+    assert(f != NULL);
+    fseek(f, 0, SEEK_END);
+    *size = (size_t)ftell(f);
+    fseek(f, 0, SEEK_SET);
+    // malloc'd memory is aligned enough for the offsets
+    char* buf = malloc(*size > 0 ? *size : 1);
+    assert(fread(buf, 1, *size, f) == *size);
+    fclose(f);
+    return buf;
+}
+
+// Test saving a vector and mapping it back
+void test_vec_save_view() {
+    size_t n = 5000;
+    char buf[32];
+    kiln_string_vec_t vec = kiln_string_vec_new();
+    for (size_t i = 0; i < n; i++) {
+        int len = snprintf(buf, sizeof(buf), i % 10 == 0 ? "" : "value-%zu", i);
+        kiln_string_vec_push(&vec, (kstring_ref_t){ .ptr = buf, .__length = (uint64_t)len });
+    }
+
+    char* path = temp_path();
+    assert(kiln_string_vec_save(&vec, path));
+
+    for (int verify = 0; verify <= 1; verify++) {
+        kiln_string_vec_view_t view;
+        assert(kiln_string_vec_view_open(&view, path, verify));
+        assert(kiln_string_vec_view_len(&view) == n);
+        for (size_t i = 0; i < n; i++) {
+            kstring_ref_t a = kiln_string_vec_view_get(&view, i);
+            kstring_ref_t b = kiln_string_vec_get(&vec, i);
+            assert(a.__length == b.__length && memcmp(a.ptr, b.ptr, a.__length) == 0);
+        }
+        // The blob is 64 byte aligned in the file, and so in the mapping
+        assert(((uintptr_t)kiln_string_vec_view_get(&view, 0).ptr & 63) == 0);
+
+        kiln_string_vec_t copy = kiln_string_vec_from_view(&view);
+        kiln_string_vec_view_close(&view);
+        assert(kiln_string_vec_len(&copy) == n);
+        assert(kiln_string_vec_data_len(&copy) == kiln_string_vec_data_len(&vec));
+        assert(memcmp(kiln_string_vec_data(&copy), kiln_string_vec_data(&vec), kiln_string_vec_data_len(&vec)) == 0);
+        kiln_string_vec_push(&copy, KSTR("more"));
+        assert(ref_equals_cstr(kiln_string_vec_get(&copy, n), "more"));
+        kiln_string_vec_free(&copy);
+    }
+
+    // The same bytes through a buffer
+    size_t size;
+    char* bytes = read_file(path, &size);
+    kiln_string_vec_view_t view;
+    assert(kiln_string_vec_view_from_buffer(&view, (kstring_ref_t){ .ptr = bytes, .__length = size }, true));
+    assert(ref_equals_cstr(kiln_string_vec_view_get(&view, 1), "value-1"));
+    kiln_string_vec_view_close(&view);
+    free(bytes);
+
+    unlink(path);
+    kiln_string_vec_free(&vec);
+}
+
+// Test that damaged or foreign files are rejected
+void test_vec_view_invalid() {
+    kiln_string_vec_t vec = kiln_string_vec_new();
+    kiln_string_vec_push(&vec, KSTR("alpha"));
+    kiln_string_vec_push(&vec, KSTR("beta"));
+    char* path = temp_path();
+    assert(kiln_string_vec_save(&vec, path));
+
+    size_t size;
+    char* bytes = read_file(path, &size);
+    kstring_ref_t ref = { .ptr = bytes, .__length = size };
+    kiln_string_vec_view_t view;
+    assert(kiln_string_vec_view_from_buffer(&view, ref, true));
+
+    // A flipped byte in the blob only fails the checksum
+    bytes[size - 1] ^= 1;
+    assert(kiln_string_vec_view_from_buffer(&view, ref, false));
+    assert(!kiln_string_vec_view_from_buffer(&view, ref, true));
+    bytes[size - 1] ^= 1;
+
+    // Offsets out of order
+    uint64_t* offsets = (uint64_t*)(bytes + 64);
+    offsets[1] = 12;
+    assert(!kiln_string_vec_view_from_buffer(&view, ref, true));
+    offsets[1] = 5;
+
+    // Bad magic, unknown version, truncated file, misaligned buffer
+    bytes[0] = 'X';
+    assert(!kiln_string_vec_view_from_buffer(&view, ref, false));
+    bytes[0] = 'K';
+    bytes[8] = 2;
+    assert(!kiln_string_vec_view_from_buffer(&view, ref, false));
+    bytes[8] = 1;
+    assert(!kiln_string_vec_view_from_buffer(&view, (kstring_ref_t){ .ptr = bytes, .__length = size - 1 }, false));
+    assert(!kiln_string_vec_view_from_buffer(&view, (kstring_ref_t){ .ptr = bytes, .__length = 32 }, false));
+    assert(kiln_string_vec_view_from_buffer(&view, ref, true));
+
+    char* shifted = malloc(size + 1);
+    memcpy(shifted + 1, bytes, size);
+    assert(!kiln_string_vec_view_from_buffer(&view, (kstring_ref_t){ .ptr = shifted + 1, .__length = size }, false));
+    free(shifted);
+
+    // Missing and non vector files
+    assert(!kiln_string_vec_view_open(&view, "/nonexistent/kiln_vec", false));
+    FILE* f = fopen(path, "wb");
+    fputs("not a string vector, but long enough to hold a header.....................", f);
+    fclose(f);
+    assert(!kiln_string_vec_view_open(&view, path, false));
+    assert(kiln_string_vec_view_len(&view) == 0);
+
+    // An empty vector round trips
+    kiln_string_vec_t empty = kiln_string_vec_new();
+    assert(kiln_string_vec_save(&empty, path));
+    assert(kiln_string_vec_view_open(&view, path, true));
+    assert(kiln_string_vec_view_len(&view) == 0);
+    kiln_string_vec_t copy = kiln_string_vec_from_view(&view);
+    assert(kiln_string_vec_len(&copy) == 0);
+    kiln_string_vec_view_close(&view);
+    kiln_string_vec_free(&copy);
+    kiln_string_vec_free(&empty);
+
+    assert(!kiln_string_vec_save(&vec, "/nonexistent/kiln_vec"));
+
+    unlink(path);
+    free(bytes);
+    kiln_string_vec_free(&vec);
+}
+
+// Test that saving over a file leaves existing views of it intact
+void test_vec_save_over_view() {
+    size_t n = 20000;
+    char buf[32];
+    kiln_string_vec_t old_vec = kiln_string_vec_new();
+    kiln_string_vec_t new_vec = kiln_string_vec_new();
+    for (size_t i = 0; i < n; i++) {
+        int len = snprintf(buf, sizeof(buf), "old-%zu", i);
+        kiln_string_vec_push(&old_vec, (kstring_ref_t){ .ptr = buf, .__length = (uint64_t)len });
+    }
+    kiln_string_vec_push(&new_vec, KSTR("new"));
+
+    char* path = temp_path();
+    assert(kiln_string_vec_save(&old_vec, path));
+    kiln_string_vec_view_t old_view;
+    assert(kiln_string_vec_view_open(&old_view, path, true));
+
+    // A smaller file replaces the mapped one; the old pages must stay readable
+    assert(kiln_string_vec_save(&new_vec, path));
+    for (size_t i = 0; i < n; i++) {
+        int len = snprintf(buf, sizeof(buf), "old-%zu", i);
+        kstring_ref_t ref = kiln_string_vec_view_get(&old_view, i);
+        assert(ref.__length == (uint64_t)len && memcmp(ref.ptr, buf, ref.__length) == 0);
+    }
+    kiln_string_vec_view_close(&old_view);
+
+    kiln_string_vec_view_t new_view;
+    assert(kiln_string_vec_view_open(&new_view, path, true));
+    assert(kiln_string_vec_view_len(&new_view) == 1);
+    assert(ref_equals_cstr(kiln_string_vec_view_get(&new_view, 0), "new"));
+    kiln_string_vec_view_close(&new_view);
+
+    unlink(path);
+    kiln_string_vec_free(&old_vec);
+    kiln_string_vec_free(&new_vec);
+}
+
+int main() {
+    printf("=== String Vector Tests ===\n");
+
+    // Run all tests
+    run_test("kiln_string_vec_push", test_vec_push_get);
+    run_test("kiln_string_vec_reserve", test_vec_many);
+    run_test("kiln_string_vec_push_split", test_vec_push_split);
+    run_test("kiln_string_vec_save and kiln_string_vec_view_open", test_vec_save_view);
+    run_test("kiln_string_vec_view_from_buffer invalid input", test_vec_view_invalid);
+    run_test("kiln_string_vec_save over a mapped file", test_vec_save_over_view);
+
+    return 0;
+}